@@ -16,6 +16,8 @@ this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "LibBoolEE.h"
 
+#include <algorithm>
+
 std::vector<std::string> LibBoolEE::singleParse(const std::string & formula, const char op, ErrorReport* errorReport) {
     int start_pos = -1;
     int parity_count = 0;
@@ -145,6 +147,121 @@ bool LibBoolEE::resolveRec(const std::string &source, const Vals & valuation, Er
     }
 }
 
+LibBoolEE::Program LibBoolEE::compile(const std::string &source, ErrorReport* errorReport) {
+    Program program;
+    compileRec(removeWhitespaces(source), program, errorReport);
+    return program;
+}
+
+// Follows the steps of resolveRec, so the same formulas are rejected with the same errors, but emits code instead of
+// resolving the subexpressions. The variables are looked up when the program is evaluated.
+void LibBoolEE::compileRec(const std::string &source, Program & program, ErrorReport* errorReport) {
+    if (source.empty()) {
+        if (errorReport) {
+            errorReport->type = ErrorReport::ErrorType::EmptySubExpression;
+            errorReport->vecUserData.emplace_back(source);
+            errorReport->strDevData = "bad-txns-null-verifier-empty-sub-expression";
+        }
+        throw std::runtime_error("An empty subexpression was encountered");
+    }
+
+    char current_op = '|';
+    // Try to divide by |
+    std::vector<std::string> subexpressions = singleParse(source, current_op, errorReport);
+    // No | on the top level
+    if (subexpressions.size() == 1) {
+        current_op = '&';
+        subexpressions = singleParse(source, current_op, errorReport);
+    }
+
+    // No valid name found
+    if (subexpressions.size() == 0) {
+        if (errorReport) {
+            errorReport->type = ErrorReport::ErrorType::InvalidQualifierName;
+            errorReport->vecUserData.emplace_back(source);
+            errorReport->strDevData = "bad-txns-null-verifier-no-sub-expressions";
+        }
+        throw std::runtime_error("The subexpression " + source + " is not a valid formula.");
+    }
+
+    // No binary top level operator found
+    else if (subexpressions.size() == 1) {
+        if (source[0] == '!') {
+            compileRec(source.substr(1), program, errorReport);
+            program.emit(Program::OP_NOT);
+        }
+        else if (source[0] == '(') {
+            compileRec(source.substr(1, source.size() - 2), program, errorReport);
+        }
+        else if (source == "1") {
+            program.emit(Program::OP_TRUE);
+        }
+        else if (source == "0") {
+            program.emit(Program::OP_FALSE);
+        }
+        else {
+            program.emitVariable(source);
+        }
+    }
+    else {
+        // Every subexpression is evaluated, as resolveRec doesn't short circuit either
+        compileRec(subexpressions[0], program, errorReport);
+        for (size_t i = 1; i < subexpressions.size(); i++) {
+            compileRec(subexpressions[i], program, errorReport);
+            program.emit(current_op == '|' ? Program::OP_OR : Program::OP_AND);
+        }
+    }
+}
+
+void LibBoolEE::Program::emit(uint8_t op) {
+    if (op == OP_AND || op == OP_OR) {
+        nDepth--;
+    } else if (op != OP_NOT) {
+        if (++nDepth > MAX_STACK_DEPTH)
+            throw std::runtime_error("The formula is nested too deeply to be compiled.");
+        nMaxDepth = std::max(nMaxDepth, nDepth);
+    }
+    code.push_back(op);
+}
+
+void LibBoolEE::Program::emitVariable(const std::string &name) {
+    size_t index = std::find(vars.begin(), vars.end(), name) - vars.begin();
+    if (index == vars.size()) {
+        if (vars.size() == MAX_VARIABLES)
+            throw std::runtime_error("The formula has too many variables to be compiled.");
+        vars.push_back(name);
+    }
+    emit(OP_VAR | static_cast<uint8_t>(index));
+}
+
+bool LibBoolEE::Program::evaluate(uint64_t valuation) const {
+    // The stack is kept in the bits of a single word, with its top in bit 0
+    uint64_t stack = 0;
+    for (const uint8_t op : code) {
+        switch (op) {
+            case OP_FALSE:
+                stack <<= 1;
+                break;
+            case OP_TRUE:
+                stack = (stack << 1) | 1;
+                break;
+            case OP_NOT:
+                stack ^= 1;
+                break;
+            case OP_AND:
+                stack = (stack >> 1) & (~static_cast<uint64_t>(1) | stack);
+                break;
+            case OP_OR:
+                stack = (stack >> 1) | (stack & 1);
+                break;
+            default:
+                stack = (stack << 1) | ((valuation >> (op & ~OP_VAR)) & 1);
+                break;
+        }
+    }
+    return stack & 1;
+}
+
 std::string LibBoolEE::trim(const std::string &source) {
     static const std::string WHITESPACES = " \n\r\t\v\f";
     const size_t front = source.find_first_not_of(WHITESPACES);
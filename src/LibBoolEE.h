@@ -34,6 +34,7 @@ this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "assets/assets.h"
 
 #include <map>
+#include <stdint.h>
 #include <string>
 #include <vector>
 #include <utility>
@@ -44,9 +45,51 @@ public:
     typedef std::map<std::string, bool> Vals; ///< Valuation of atomic propositions
     typedef std::pair<std::string, bool> Val; ///< A single proposition valuation
 
+    /// A formula compiled to postfix code. Every variable is given the index of its first appearance, and a valuation
+    /// is a bitset where bit i holds the value of variable i.
+    class Program {
+    public:
+        static const size_t MAX_VARIABLES = 64;
+        static const size_t MAX_STACK_DEPTH = 64;
+
+        Program() : nDepth(0), nMaxDepth(0) {}
+
+        // @return	true iff the formula is true under the valuation
+        bool evaluate(uint64_t valuation) const;
+
+        // @return	the variables of the formula, in the order of their indexes
+        const std::vector<std::string> & variables() const { return vars; }
+
+        size_t size() const { return code.size(); }
+
+    private:
+        friend class LibBoolEE;
+
+        enum : uint8_t {
+            OP_FALSE = 0,
+            OP_TRUE = 1,
+            OP_NOT = 2,
+            OP_AND = 3,
+            OP_OR = 4,
+            OP_VAR = 0x80 ///< The low bits hold the index of the variable
+        };
+
+        void emit(uint8_t op);
+        void emitVariable(const std::string & name);
+
+        std::vector<uint8_t> code;
+        std::vector<std::string> vars;
+        size_t nDepth;
+        size_t nMaxDepth;
+    };
+
     // @return	true iff the formula is true under the valuation (where the valuation are pairs (variable,value))
     static bool resolve(const std::string & source, const Vals & valuation,  ErrorReport* errorReport = nullptr);
 
+    // @return	the formula compiled to a Program. Throws for the same malformed formulas as resolve does, and for formulas
+    //          with more than Program::MAX_VARIABLES variables or nested deeper than Program::MAX_STACK_DEPTH
+    static Program compile(const std::string & source, ErrorReport* errorReport = nullptr);
+
     // @return  new string made from the source by removing whitespaces
     static std::string removeWhitespaces(const std::string & source);
 
@@ -62,6 +105,9 @@ private:
     // @return	true iff the formula is true under the valuation (where the valuation are pairs (variable,value))---used internally
     static bool resolveRec(const std::string & source, const Vals & valuation, ErrorReport* errorReport = nullptr);
 
+    // Append the code of the formula to the program---used internally
+    static void compileRec(const std::string & source, Program & program, ErrorReport* errorReport = nullptr);
+
 
     // @return	new string made from the source by removing the leading and trailing white spaces
     static std::string trim(const std::string & source);
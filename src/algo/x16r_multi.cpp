@@ -0,0 +1,507 @@
+// Copyright (c) 2023-2024 The Nrgc Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "algo/x16r_multi.h"
+
+#include "crypto/common.h"
+#include "hash.h"
+
+#include <assert.h>
+#include <string.h>
+
+// Internal implementation code.
+namespace
+{
+/** Hash nLanes equal-length inputs in lock-step, in[i] -> out[i] (64 bytes). */
+typedef void (*LaneKernel)(const unsigned char* const* in, size_t len, unsigned char* const* out);
+
+/// Scalar single-lane implementation, identical to the per-round switch in HashX16R.
+void HashScalar(int algo, const void* toHash, size_t lenToHash, void* out)
+{
+    switch (algo) {
+        case 0: {
+            sph_blake512_context ctx;
+            sph_blake512_init(&ctx);
+            sph_blake512(&ctx, toHash, lenToHash);
+            sph_blake512_close(&ctx, out);
+            break;
+        }
+        case 1: {
+            sph_bmw512_context ctx;
+            sph_bmw512_init(&ctx);
+            sph_bmw512(&ctx, toHash, lenToHash);
+            sph_bmw512_close(&ctx, out);
+            break;
+        }
+        case 2: {
+            sph_groestl512_context ctx;
+            sph_groestl512_init(&ctx);
+            sph_groestl512(&ctx, toHash, lenToHash);
+            sph_groestl512_close(&ctx, out);
+            break;
+        }
+        case 3: {
+            sph_jh512_context ctx;
+            sph_jh512_init(&ctx);
+            sph_jh512(&ctx, toHash, lenToHash);
+            sph_jh512_close(&ctx, out);
+            break;
+        }
+        case 4: {
+            sph_keccak512_context ctx;
+            sph_keccak512_init(&ctx);
+            sph_keccak512(&ctx, toHash, lenToHash);
+            sph_keccak512_close(&ctx, out);
+            break;
+        }
+        case 5: {
+            sph_skein512_context ctx;
+            sph_skein512_init(&ctx);
+            sph_skein512(&ctx, toHash, lenToHash);
+            sph_skein512_close(&ctx, out);
+            break;
+        }
+        case 6: {
+            sph_luffa512_context ctx;
+            sph_luffa512_init(&ctx);
+            sph_luffa512(&ctx, toHash, lenToHash);
+            sph_luffa512_close(&ctx, out);
+            break;
+        }
+        case 7: {
+            sph_cubehash512_context ctx;
+            sph_cubehash512_init(&ctx);
+            sph_cubehash512(&ctx, toHash, lenToHash);
+            sph_cubehash512_close(&ctx, out);
+            break;
+        }
+        case 8: {
+            sph_shavite512_context ctx;
+            sph_shavite512_init(&ctx);
+            sph_shavite512(&ctx, toHash, lenToHash);
+            sph_shavite512_close(&ctx, out);
+            break;
+        }
+        case 9: {
+            sph_simd512_context ctx;
+            sph_simd512_init(&ctx);
+            sph_simd512(&ctx, toHash, lenToHash);
+            sph_simd512_close(&ctx, out);
+            break;
+        }
+        case 10: {
+            sph_echo512_context ctx;
+            sph_echo512_init(&ctx);
+            sph_echo512(&ctx, toHash, lenToHash);
+            sph_echo512_close(&ctx, out);
+            break;
+        }
+        case 11: {
+            sph_hamsi512_context ctx;
+            sph_hamsi512_init(&ctx);
+            sph_hamsi512(&ctx, toHash, lenToHash);
+            sph_hamsi512_close(&ctx, out);
+            break;
+        }
+        case 12: {
+            sph_fugue512_context ctx;
+            sph_fugue512_init(&ctx);
+            sph_fugue512(&ctx, toHash, lenToHash);
+            sph_fugue512_close(&ctx, out);
+            break;
+        }
+        case 13: {
+            sph_shabal512_context ctx;
+            sph_shabal512_init(&ctx);
+            sph_shabal512(&ctx, toHash, lenToHash);
+            sph_shabal512_close(&ctx, out);
+            break;
+        }
+        case 14: {
+            sph_whirlpool_context ctx;
+            sph_whirlpool_init(&ctx);
+            sph_whirlpool(&ctx, toHash, lenToHash);
+            sph_whirlpool_close(&ctx, out);
+            break;
+        }
+        case 15: {
+            sph_sha512_context ctx;
+            sph_sha512_init(&ctx);
+            sph_sha512(&ctx, toHash, lenToHash);
+            sph_sha512_close(&ctx, out);
+            break;
+        }
+    }
+}
+
+/// X16RV2 runs tiger in front of keccak, luffa and sha512.
+bool IsTigerPrefixed(int algo)
+{
+    return algo == 4 || algo == 6 || algo == 15;
+}
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__amd64__))
+#define ENABLE_X16R_MULTI_LANES 1
+
+/*
+ * The lane kernels are written once against GCC vector extensions and
+ * instantiated for 4 x 64-bit (AVX2) and 8 x 64-bit (AVX-512) vectors.
+ * Everything is forced inline into the target-specific entry points at the
+ * bottom so that no vector type crosses a function boundary compiled for the
+ * baseline ISA.
+ */
+typedef uint64_t v4u64 __attribute__((vector_size(32)));
+typedef uint64_t v8u64 __attribute__((vector_size(64)));
+
+#define X16R_INLINE inline __attribute__((always_inline))
+
+namespace blake512
+{
+const uint64_t IV[8] = {
+    0x6A09E667F3BCC908ULL, 0xBB67AE8584CAA73BULL, 0x3C6EF372FE94F82BULL, 0xA54FF53A5F1D36F1ULL,
+    0x510E527FADE682D1ULL, 0x9B05688C2B3E6C1FULL, 0x1F83D9ABFB41BD6BULL, 0x5BE0CD19137E2179ULL,
+};
+
+const uint64_t CB[16] = {
+    0x243F6A8885A308D3ULL, 0x13198A2E03707344ULL, 0xA4093822299F31D0ULL, 0x082EFA98EC4E6C89ULL,
+    0x452821E638D01377ULL, 0xBE5466CF34E90C6CULL, 0xC0AC29B7C97C50DDULL, 0x3F84D5B5B5470917ULL,
+    0x9216D5D98979FB1BULL, 0xD1310BA698DFB5ACULL, 0x2FFD72DBD01ADFB7ULL, 0xB8E1AFED6A267E96ULL,
+    0xBA7C9045F12C7F99ULL, 0x24A19947B3916CF7ULL, 0x0801F2E2858EFC16ULL, 0x636920D871574E69ULL,
+};
+
+const uint8_t sigma[10][16] = {
+    { 0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 15},
+    {14, 10,  4,  8,  9, 15, 13,  6,  1, 12,  0,  2, 11,  7,  5,  3},
+    {11,  8, 12,  0,  5,  2, 15, 13, 10, 14,  3,  6,  7,  1,  9,  4},
+    { 7,  9,  3,  1, 13, 12, 11, 14,  2,  6,  5, 10,  4,  0, 15,  8},
+    { 9,  0,  5,  7,  2,  4, 10, 15, 14,  1, 11, 12,  6,  8,  3, 13},
+    { 2, 12,  6, 10,  0, 11,  8,  3,  4, 13,  7,  5, 15, 14,  1,  9},
+    {12,  5,  1, 15, 14, 13,  4, 10,  0,  7,  6,  3,  9,  2,  8, 11},
+    {13, 11,  7, 14, 12,  1,  3,  9,  5,  0, 15,  4,  8,  6,  2, 10},
+    { 6, 15, 14,  9, 11,  3,  0,  8, 12,  2, 13,  7,  1,  4, 10,  5},
+    {10,  2,  8,  4,  7,  6,  1,  5, 15, 11,  9, 14,  3, 12, 13,  0},
+};
+
+/** Inputs longer than this do not fit in a single padded block. */
+const size_t MAX_SINGLE_BLOCK = 111;
+
+#define BLAKE_ROTR(x, n) (((x) >> (n)) | ((x) << (64 - (n))))
+#define BLAKE_G(r, i, a, b, c, d) do { \
+        a = a + b + (M[sigma[r][2 * i]] ^ CB[sigma[r][2 * i + 1]]); \
+        d = BLAKE_ROTR(d ^ a, 32); \
+        c = c + d; \
+        b = BLAKE_ROTR(b ^ c, 25); \
+        a = a + b + (M[sigma[r][2 * i + 1]] ^ CB[sigma[r][2 * i]]); \
+        d = BLAKE_ROTR(d ^ a, 16); \
+        c = c + d; \
+        b = BLAKE_ROTR(b ^ c, 11); \
+    } while (0)
+
+template <typename V, int LANES>
+X16R_INLINE void Lanes(const unsigned char* const* in, size_t len, unsigned char* const* out)
+{
+    // Single compression: the 0x80 .. 0x01 padding and the bit length fit in the first block.
+    V M[16];
+    for (int l = 0; l < LANES; l++) {
+        unsigned char block[128] = {};
+        memcpy(block, in[l], len);
+        block[len] = 0x80;
+        block[111] |= 1;
+        WriteBE64(block + 120, (uint64_t)len << 3);
+        for (int k = 0; k < 16; k++)
+            M[k][l] = ReadBE64(block + 8 * k);
+    }
+
+    const uint64_t T0 = (uint64_t)len << 3;
+    const V zero = {};
+    V V0 = zero + IV[0], V1 = zero + IV[1], V2 = zero + IV[2], V3 = zero + IV[3];
+    V V4 = zero + IV[4], V5 = zero + IV[5], V6 = zero + IV[6], V7 = zero + IV[7];
+    V V8 = zero + CB[0], V9 = zero + CB[1], VA = zero + CB[2], VB = zero + CB[3];
+    V VC = zero + (T0 ^ CB[4]), VD = zero + (T0 ^ CB[5]), VE = zero + CB[6], VF = zero + CB[7];
+
+    for (int r = 0; r < 16; r++) {
+        const int s = r % 10;
+        BLAKE_G(s, 0, V0, V4, V8, VC);
+        BLAKE_G(s, 1, V1, V5, V9, VD);
+        BLAKE_G(s, 2, V2, V6, VA, VE);
+        BLAKE_G(s, 3, V3, V7, VB, VF);
+        BLAKE_G(s, 4, V0, V5, VA, VF);
+        BLAKE_G(s, 5, V1, V6, VB, VC);
+        BLAKE_G(s, 6, V2, V7, V8, VD);
+        BLAKE_G(s, 7, V3, V4, V9, VE);
+    }
+
+    const V H[8] = {
+        (V0 ^ V8) ^ IV[0], (V1 ^ V9) ^ IV[1], (V2 ^ VA) ^ IV[2], (V3 ^ VB) ^ IV[3],
+        (V4 ^ VC) ^ IV[4], (V5 ^ VD) ^ IV[5], (V6 ^ VE) ^ IV[6], (V7 ^ VF) ^ IV[7],
+    };
+    for (int l = 0; l < LANES; l++)
+        for (int k = 0; k < 8; k++)
+            WriteBE64(out[l] + 8 * k, H[k][l]);
+}
+
+#undef BLAKE_G
+#undef BLAKE_ROTR
+} // namespace blake512
+
+namespace keccak512
+{
+const uint64_t RC[24] = {
+    0x0000000000000001ULL, 0x0000000000008082ULL, 0x800000000000808AULL, 0x8000000080008000ULL,
+    0x000000000000808BULL, 0x0000000080000001ULL, 0x8000000080008081ULL, 0x8000000000008009ULL,
+    0x000000000000008AULL, 0x0000000000000088ULL, 0x0000000080008009ULL, 0x000000008000000AULL,
+    0x000000008000808BULL, 0x800000000000008BULL, 0x8000000000008089ULL, 0x8000000000008003ULL,
+    0x8000000000008002ULL, 0x8000000000000080ULL, 0x000000000000800AULL, 0x800000008000000AULL,
+    0x8000000080008081ULL, 0x8000000000008080ULL, 0x0000000080000001ULL, 0x8000000080008008ULL,
+};
+
+const int ROTC[24] = {1, 3, 6, 10, 15, 21, 28, 36, 45, 55, 2, 14, 27, 41, 56, 8, 25, 43, 62, 18, 39, 61, 20, 44};
+const int PILN[24] = {10, 7, 11, 17, 18, 3, 5, 16, 8, 21, 24, 4, 15, 23, 19, 13, 12, 2, 20, 14, 22, 9, 6, 1};
+
+/** Keccak-512 absorbs 72 bytes per permutation. */
+const size_t RATE = 72;
+
+#define KECCAK_ROTL(x, n) (((x) << (n)) | ((x) >> (64 - (n))))
+
+template <typename V>
+X16R_INLINE void Permute(V* st)
+{
+    for (int round = 0; round < 24; round++) {
+        V bc[5];
+        for (int i = 0; i < 5; i++)
+            bc[i] = st[i] ^ st[i + 5] ^ st[i + 10] ^ st[i + 15] ^ st[i + 20];
+        for (int i = 0; i < 5; i++) {
+            const V t = bc[(i + 4) % 5] ^ KECCAK_ROTL(bc[(i + 1) % 5], 1);
+            for (int j = 0; j < 25; j += 5)
+                st[j + i] ^= t;
+        }
+
+        V t = st[1];
+        for (int i = 0; i < 24; i++) {
+            const int j = PILN[i];
+            const V tmp = st[j];
+            st[j] = KECCAK_ROTL(t, ROTC[i]);
+            t = tmp;
+        }
+
+        for (int j = 0; j < 25; j += 5) {
+            for (int i = 0; i < 5; i++)
+                bc[i] = st[j + i];
+            for (int i = 0; i < 5; i++)
+                st[j + i] ^= (~bc[(i + 1) % 5]) & bc[(i + 2) % 5];
+        }
+
+        st[0] ^= RC[round];
+    }
+}
+
+template <typename V, int LANES>
+X16R_INLINE void Lanes(const unsigned char* const* in, size_t len, unsigned char* const* out)
+{
+    V st[25] = {};
+
+    size_t offset = 0;
+    bool fFinal = false;
+    while (!fFinal) {
+        const size_t chunk = len - offset < RATE ? len - offset : RATE;
+        fFinal = chunk < RATE;
+        for (int l = 0; l < LANES; l++) {
+            unsigned char block[RATE];
+            memcpy(block, in[l] + offset, chunk);
+            if (fFinal) {
+                // Original Keccak padding, as used by sph_keccak512.
+                memset(block + chunk, 0, RATE - chunk);
+                block[chunk] = 0x01;
+                block[RATE - 1] |= 0x80;
+            }
+            for (size_t w = 0; w < RATE / 8; w++)
+                st[w][l] ^= ReadLE64(block + 8 * w);
+        }
+        Permute(st);
+        offset += chunk;
+    }
+
+    for (int l = 0; l < LANES; l++)
+        for (int k = 0; k < 8; k++)
+            WriteLE64(out[l] + 8 * k, st[k][l]);
+}
+
+#undef KECCAK_ROTL
+} // namespace keccak512
+
+__attribute__((target("avx2"))) void Blake512x4(const unsigned char* const* in, size_t len, unsigned char* const* out)
+{
+    blake512::Lanes<v4u64, 4>(in, len, out);
+}
+
+__attribute__((target("avx2"))) void Keccak512x4(const unsigned char* const* in, size_t len, unsigned char* const* out)
+{
+    keccak512::Lanes<v4u64, 4>(in, len, out);
+}
+
+__attribute__((target("avx512f"))) void Blake512x8(const unsigned char* const* in, size_t len, unsigned char* const* out)
+{
+    blake512::Lanes<v8u64, 8>(in, len, out);
+}
+
+__attribute__((target("avx512f"))) void Keccak512x8(const unsigned char* const* in, size_t len, unsigned char* const* out)
+{
+    keccak512::Lanes<v8u64, 8>(in, len, out);
+}
+
+#undef X16R_INLINE
+#endif // ENABLE_X16R_MULTI_LANES
+
+/** Number of lanes processed per kernel call, 0 when only the scalar path is available. */
+int nLanes = 0;
+/** Per-algorithm lane kernels (nullptr: scalar fallback). */
+LaneKernel laneKernels[16] = {};
+/** Longest input each lane kernel accepts. */
+size_t laneMaxLen[16] = {};
+
+bool SelfTest(int algo, LaneKernel kernel, int lanes)
+{
+    unsigned char in[16][80];
+    unsigned char out[16][64];
+    unsigned char expected[64];
+    const unsigned char* pin[16];
+    unsigned char* pout[16];
+
+    for (size_t len : {(size_t)64, (size_t)80}) {
+        if (len > laneMaxLen[algo])
+            continue;
+        for (int l = 0; l < lanes; l++) {
+            for (size_t i = 0; i < sizeof(in[l]); i++)
+                in[l][i] = (unsigned char)(l * 31 + i * 7 + algo);
+            pin[l] = in[l];
+            pout[l] = out[l];
+        }
+        kernel(pin, len, pout);
+        for (int l = 0; l < lanes; l++) {
+            HashScalar(algo, in[l], len, expected);
+            if (memcmp(expected, out[l], sizeof(expected)) != 0)
+                return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+std::string X16RMultiAutoDetect()
+{
+    nLanes = 0;
+    for (int i = 0; i < 16; i++) {
+        laneKernels[i] = nullptr;
+        laneMaxLen[i] = 0;
+    }
+
+#if defined(ENABLE_X16R_MULTI_LANES)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        nLanes = 8;
+        laneKernels[0] = Blake512x8;
+        laneKernels[4] = Keccak512x8;
+    } else if (__builtin_cpu_supports("avx2")) {
+        nLanes = 4;
+        laneKernels[0] = Blake512x4;
+        laneKernels[4] = Keccak512x4;
+    }
+    laneMaxLen[0] = blake512::MAX_SINGLE_BLOCK;
+    laneMaxLen[4] = SIZE_MAX;
+
+    for (int i = 0; i < 16; i++) {
+        if (laneKernels[i])
+            assert(SelfTest(i, laneKernels[i], nLanes));
+    }
+
+    if (nLanes == 8)
+        return "avx512 (8-way blake512, keccak512)";
+    if (nLanes == 4)
+        return "avx2 (4-way blake512, keccak512)";
+#endif
+
+    return "standard";
+}
+
+void HashX16RMulti(std::vector<X16RMultiJob>& jobs)
+{
+    static const unsigned char pblank[1] = {};
+
+    const size_t nJobs = jobs.size();
+    // Running 512-bit state of every job; round i reads it and overwrites it in place.
+    std::vector<uint512> state(nJobs);
+    std::vector<const unsigned char*> vInput(nJobs);
+    std::vector<size_t> vInputLen(nJobs);
+    std::vector<uint32_t> vBucket[16];
+
+    for (size_t j = 0; j < nJobs; j++) {
+        vInput[j] = jobs[j].pbegin == jobs[j].pend ? pblank : jobs[j].pbegin;
+        vInputLen[j] = jobs[j].pend - jobs[j].pbegin;
+    }
+
+    for (int round = 0; round < 16; round++) {
+        for (int algo = 0; algo < 16; algo++)
+            vBucket[algo].clear();
+        for (size_t j = 0; j < nJobs; j++)
+            vBucket[GetHashSelection(jobs[j].hashPrevBlock, round)].push_back(j);
+
+        for (int algo = 0; algo < 16; algo++) {
+            const std::vector<uint32_t>& bucket = vBucket[algo];
+            if (bucket.empty())
+                continue;
+
+            if (IsTigerPrefixed(algo)) {
+                for (uint32_t j : bucket) {
+                    if (!jobs[j].fV2)
+                        continue;
+                    // The tiger digest is 24 bytes, zero extended to the 64 bytes fed onwards.
+                    uint512 tiger;
+                    sph_tiger_context ctx_tiger;
+                    sph_tiger_init(&ctx_tiger);
+                    sph_tiger(&ctx_tiger, vInput[j], vInputLen[j]);
+                    sph_tiger_close(&ctx_tiger, static_cast<void*>(tiger.begin()));
+                    state[j] = tiger;
+                    vInput[j] = state[j].begin();
+                    vInputLen[j] = 64;
+                }
+            }
+
+            size_t next = 0;
+            const LaneKernel kernel = laneKernels[algo];
+            if (kernel) {
+                const unsigned char* pin[8];
+                unsigned char* pout[8];
+                while (bucket.size() - next >= (size_t)nLanes) {
+                    const size_t len = vInputLen[bucket[next]];
+                    bool fUniform = len <= laneMaxLen[algo];
+                    for (int l = 1; l < nLanes && fUniform; l++)
+                        fUniform = vInputLen[bucket[next + l]] == len;
+                    if (!fUniform)
+                        break;
+                    for (int l = 0; l < nLanes; l++) {
+                        const uint32_t j = bucket[next + l];
+                        pin[l] = vInput[j];
+                        pout[l] = state[j].begin();
+                    }
+                    kernel(pin, len, pout);
+                    next += nLanes;
+                }
+            }
+
+            for (; next < bucket.size(); next++) {
+                const uint32_t j = bucket[next];
+                HashScalar(algo, vInput[j], vInputLen[j], state[j].begin());
+            }
+        }
+
+        for (size_t j = 0; j < nJobs; j++) {
+            vInput[j] = state[j].begin();
+            vInputLen[j] = 64;
+        }
+    }
+
+    for (size_t j = 0; j < nJobs; j++)
+        jobs[j].hash = state[j].trim256();
+}
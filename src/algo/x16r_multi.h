@@ -0,0 +1,41 @@
+// Copyright (c) 2023-2024 The Nrgc Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef NRGC_ALGO_X16R_MULTI_H
+#define NRGC_ALGO_X16R_MULTI_H
+
+#include "uint256.h"
+
+#include <string>
+#include <vector>
+
+/** A single input for HashX16RMulti. */
+struct X16RMultiJob
+{
+    const unsigned char* pbegin;
+    const unsigned char* pend;
+    uint256 hashPrevBlock;
+    //! Use the X16RV2 variant (tiger pre-hash before keccak, luffa and sha512)
+    bool fV2;
+    //! Result, identical to HashX16R / HashX16RV2 over the same input
+    uint256 hash;
+
+    X16RMultiJob() : pbegin(nullptr), pend(nullptr), fV2(false) {}
+    X16RMultiJob(const unsigned char* pbeginIn, const unsigned char* pendIn, const uint256& hashPrevBlockIn, bool fV2In)
+        : pbegin(pbeginIn), pend(pendIn), hashPrevBlock(hashPrevBlockIn), fV2(fV2In) {}
+};
+
+/** Autodetect the widest multi-lane kernels (AVX-512 or AVX2) usable on this CPU,
+ *  and return a description of the selected implementation. */
+std::string X16RMultiAutoDetect();
+
+/**
+ * Hash a batch of X16R/X16RV2 inputs. At each of the 16 rounds the jobs are
+ * grouped by the algorithm their hashPrevBlock selects, and each group is
+ * pushed through the multi-lane kernel for that algorithm when one exists,
+ * falling back to the scalar sph implementation otherwise.
+ */
+void HashX16RMulti(std::vector<X16RMultiJob>& jobs);
+
+#endif // NRGC_ALGO_X16R_MULTI_H
@@ -9,6 +9,7 @@
 #include <tinyformat.h>
 #include "assetdb.h"
 #include "assets.h"
+#include "txdb.h"
 #include "validation.h"
 
 #include <boost/thread.hpp>
@@ -19,6 +20,8 @@ static const char ADDRESS_ASSET_QUANTITY_FLAG = 'C';
 static const char MY_ASSET_FLAG = 'M';
 static const char BLOCK_ASSET_UNDO_DATA = 'U';
 static const char MEMPOOL_REISSUED_TX = 'Z';
+static const char ASSET_HOLDER_COUNT_FLAG = 'H';
+static const char ASSET_HOLDER_COUNTS_BUILT = 'h';
 
 static size_t MAX_DATABASE_RESULTS = 50000;
 
@@ -33,7 +36,12 @@ bool CAssetsDB::WriteAssetData(const CNewAsset &asset, const int nHeight, const
 
 bool CAssetsDB::WriteAssetAddressQuantity(const std::string &assetName, const std::string &address, const CAmount &quantity)
 {
-    return Write(std::make_pair(ASSET_ADDRESS_QUANTITY_FLAG, std::make_pair(assetName, address)), quantity);
+    auto key = std::make_pair(ASSET_ADDRESS_QUANTITY_FLAG, std::make_pair(assetName, address));
+    CDBBatch batch(*this);
+    if (!Exists(key))
+        AddHolderCount(batch, assetName, 1);
+    batch.Write(key, quantity);
+    return WriteBatch(batch);
 }
 
 bool CAssetsDB::WriteAddressAssetQuantity(const std::string &address, const std::string &assetName, const CAmount& quantity) {
@@ -75,7 +83,77 @@ bool CAssetsDB::EraseMyAssetData(const std::string& assetName)
 }
 
 bool CAssetsDB::EraseAssetAddressQuantity(const std::string &assetName, const std::string &address) {
-    return Erase(std::make_pair(ASSET_ADDRESS_QUANTITY_FLAG, std::make_pair(assetName, address)));
+    auto key = std::make_pair(ASSET_ADDRESS_QUANTITY_FLAG, std::make_pair(assetName, address));
+    if (!Exists(key))
+        return true;
+    CDBBatch batch(*this);
+    AddHolderCount(batch, assetName, -1);
+    batch.Erase(key);
+    return WriteBatch(batch);
+}
+
+void CAssetsDB::AddHolderCount(CDBBatch& batch, const std::string& assetName, int64_t nChange)
+{
+    int64_t nCount = 0;
+    ReadAssetHolderCount(assetName, nCount);
+    nCount += nChange;
+    if (nCount > 0)
+        batch.Write(std::make_pair(ASSET_HOLDER_COUNT_FLAG, assetName), nCount);
+    else
+        batch.Erase(std::make_pair(ASSET_HOLDER_COUNT_FLAG, assetName));
+}
+
+bool CAssetsDB::ReadAssetHolderCount(const std::string& assetName, int64_t& nCount)
+{
+    nCount = 0;
+    if (!Exists(std::make_pair(ASSET_HOLDER_COUNT_FLAG, assetName)))
+        return true;
+    return Read(std::make_pair(ASSET_HOLDER_COUNT_FLAG, assetName), nCount);
+}
+
+bool CAssetsDB::BuildAssetHolderCounts()
+{
+    if (Exists(ASSET_HOLDER_COUNTS_BUILT))
+        return true;
+
+    LogPrintf("Counting the holders of every asset...\n");
+
+    std::unique_ptr<CDBIterator> pcursor(NewIterator());
+    pcursor->Seek(std::make_pair(ASSET_ADDRESS_QUANTITY_FLAG, std::make_pair(std::string(), std::string())));
+
+    CDBBatch batch(*this);
+    std::string strCurrent;
+    int64_t nCount = 0;
+    size_t nAssets = 0;
+    while (true) {
+        boost::this_thread::interruption_point();
+
+        std::pair<char, std::pair<std::string, std::string> > key;
+        bool fValid = pcursor->Valid() && pcursor->GetKey(key) && key.first == ASSET_ADDRESS_QUANTITY_FLAG;
+        if (nCount && (!fValid || key.second.first != strCurrent)) {
+            batch.Write(std::make_pair(ASSET_HOLDER_COUNT_FLAG, strCurrent), nCount);
+            nCount = 0;
+            nAssets++;
+            if (batch.SizeEstimate() > (size_t)nDefaultDbBatchSize) {
+                if (!WriteBatch(batch))
+                    return error("%s: failed to write holder counts", __func__);
+                batch.Clear();
+            }
+        }
+        if (!fValid)
+            break;
+
+        strCurrent = key.second.first;
+        nCount++;
+        pcursor->Next();
+    }
+
+    batch.Write(ASSET_HOLDER_COUNTS_BUILT, true);
+    if (!WriteBatch(batch, true))
+        return error("%s: failed to write holder counts", __func__);
+
+    LogPrintf("Counted the holders of %u assets\n", nAssets);
+    return true;
 }
 
 bool CAssetsDB::EraseAddressAssetQuantity(const std::string &address, const std::string &assetName) {
@@ -135,7 +213,7 @@ bool CAssetsDB::LoadAssets()
 
                 // Loaded enough from database to have in memory.
                 // No need to load everything if it is just going to be removed from the cache
-                if (passetsCache->Size() == (passetsCache->MaxSize() / 2))
+                if (passetsCache->Size() >= (passetsCache->MaxSize() / 2))
                     break;
             } else {
                 return error("%s: failed to read asset", __func__);
@@ -174,13 +252,77 @@ bool CAssetsDB::LoadAssets()
     return true;
 }
 
-bool CAssetsDB::AssetDir(std::vector<CDatabasedAssetData>& assets, const std::string filter, const size_t count, const long start)
+/** The directory queries read the database, so the tip asset cache has to be written out first when it holds changes */
+static void FlushDirtyAssets()
 {
+    AssertLockHeld(cs_main);
+    if (passets && passets->GetCacheSize() == 0)
+        return;
     FlushStateToDisk();
+}
 
-    std::unique_ptr<CDBIterator> pcursor(NewIterator());
-    pcursor->Seek(std::make_pair(ASSET_FLAG, std::string()));
+/**
+ * Call fn(key, cursor) on every asset whose name matches prefix (all names starting with it when fWildcard),
+ * in database order, starting after strStartAfter. Stops early when fn returns false.
+ *
+ * Names are serialized with their length first, so the names sharing a prefix are not contiguous. They are
+ * contiguous within each name length though, so this seeks once to the start of the matches of every length.
+ */
+template <typename Callable>
+static bool WalkAssetNames(CDBIterator& cursor, const std::string& prefix, bool fWildcard, const std::string& strStartAfter, Callable fn)
+{
+    if (!fWildcard) {
+        cursor.Seek(std::make_pair(ASSET_FLAG, prefix));
+        std::pair<char, std::string> key;
+        if (strStartAfter.empty() && cursor.Valid() && cursor.GetKey(key) && key.first == ASSET_FLAG && key.second == prefix)
+            fn(key, cursor);
+        return true;
+    }
+
+    size_t nLength = prefix.size();
+    bool fResume = false;
+    if (strStartAfter.size() >= prefix.size()) {
+        // A token sorting before the matches of its length starts that length from the top, one after them moves on
+        int nCompare = strStartAfter.compare(0, prefix.size(), prefix);
+        nLength = strStartAfter.size() + (nCompare > 0 ? 1 : 0);
+        fResume = nCompare == 0;
+    }
+    while (true) {
+        boost::this_thread::interruption_point();
+
+        if (fResume)
+            cursor.Seek(std::make_pair(ASSET_FLAG, strStartAfter));
+        else
+            cursor.Seek(std::make_pair(ASSET_FLAG, prefix + std::string(nLength - prefix.size(), '\0')));
 
+        std::pair<char, std::string> key;
+        if (!cursor.Valid() || !cursor.GetKey(key) || key.first != ASSET_FLAG)
+            return true;
+
+        // Skip the lengths without any name
+        if (key.second.size() > nLength && !fResume) {
+            nLength = key.second.size();
+            continue;
+        }
+
+        if (fResume && key.second == strStartAfter)
+            cursor.Next();
+        fResume = false;
+
+        while (cursor.Valid()) {
+            boost::this_thread::interruption_point();
+            if (!cursor.GetKey(key) || key.first != ASSET_FLAG || key.second.size() != nLength || key.second.compare(0, prefix.size(), prefix) != 0)
+                break;
+            if (!fn(key, cursor))
+                return false;
+            cursor.Next();
+        }
+        nLength++;
+    }
+}
+
+bool CAssetsDB::AssetDir(std::vector<CDatabasedAssetData>& assets, const std::string filter, const size_t count, const long start)
+{
     auto prefix = filter;
     bool wildcard = prefix.back() == '*';
     if (wildcard)
@@ -192,77 +334,119 @@ bool CAssetsDB::AssetDir(std::vector<CDatabasedAssetData>& assets, const std::st
     }
     else {
         // compute table size for backwards offset
+        FlushDirtyAssets();
+        std::unique_ptr<CDBIterator> pcursor(NewIterator());
         long table_size = 0;
-        while (pcursor->Valid()) {
-            boost::this_thread::interruption_point();
-
-            std::pair<char, std::string> key;
-            if (pcursor->GetKey(key) && key.first == ASSET_FLAG) {
-                if (prefix == "" ||
-                    (wildcard && key.second.find(prefix) == 0) ||
-                    (!wildcard && key.second == prefix)) {
-                    table_size += 1;
-                }
-            }
-            pcursor->Next();
-        }
-        skip = table_size + start;
-        pcursor->SeekToFirst();
+        WalkAssetNames(*pcursor, prefix, wildcard, "", [&table_size](const std::pair<char, std::string>&, CDBIterator&) {
+            table_size += 1;
+            return true;
+        });
+        skip = std::max<long>(table_size + start, 0);
     }
 
+    return AssetDir(assets, filter, "", count, skip);
+}
 
+bool CAssetsDB::AssetDir(std::vector<CDatabasedAssetData>& assets, const std::string& filter, const std::string& strStartAfter, const size_t count, const size_t skip)
+{
+    FlushDirtyAssets();
+
+    auto prefix = filter;
+    bool wildcard = prefix.back() == '*';
+    if (wildcard)
+        prefix.pop_back();
+
+    std::unique_ptr<CDBIterator> pcursor(NewIterator());
     size_t loaded = 0;
     size_t offset = 0;
+    bool fFailed = false;
 
     // Load assets
-    while (pcursor->Valid() && loaded < count) {
+    WalkAssetNames(*pcursor, prefix, wildcard, strStartAfter, [&](const std::pair<char, std::string>&, CDBIterator& cursor) {
+        if (loaded >= count)
+            return false;
+        if (offset < skip) {
+            offset += 1;
+            return true;
+        }
+        CDatabasedAssetData data;
+        if (!cursor.GetValue(data)) {
+            fFailed = true;
+            return false;
+        }
+        assets.push_back(data);
+        loaded += 1;
+        return true;
+    });
+
+    if (fFailed)
+        return error("%s: failed to read asset", __func__);
+
+    return true;
+}
+
+/**
+ * Read up to count (key, amount) entries of one of the two quantity indexes, restricted to the entries whose
+ * first key part is first, starting after the entry whose second key part is strStartAfter.
+ */
+static bool ReadQuantityDir(CDBWrapper& db, char flag, const std::string& first, const std::string& strStartAfter, size_t skip,
+                            size_t count, std::vector<std::pair<std::string, CAmount> >& vecResult)
+{
+    std::unique_ptr<CDBIterator> pcursor(db.NewIterator());
+    pcursor->Seek(std::make_pair(flag, std::make_pair(first, strStartAfter)));
+
+    size_t loaded = 0;
+    size_t offset = 0;
+    while (pcursor->Valid() && loaded < count && loaded < MAX_DATABASE_RESULTS) {
         boost::this_thread::interruption_point();
 
-        std::pair<char, std::string> key;
-        if (pcursor->GetKey(key) && key.first == ASSET_FLAG) {
-            if (prefix == "" ||
-                    (wildcard && key.second.find(prefix) == 0) ||
-                    (!wildcard && key.second == prefix)) {
-                if (offset < skip) {
-                    offset += 1;
-                }
-                else {
-                    CDatabasedAssetData data;
-                    if (pcursor->GetValue(data)) {
-                        assets.push_back(data);
-                        loaded += 1;
-                    } else {
-                        return error("%s: failed to read asset", __func__);
-                    }
-                }
-            }
-            pcursor->Next();
-        } else {
+        std::pair<char, std::pair<std::string, std::string> > key;
+        if (!pcursor->GetKey(key) || key.first != flag || key.second.first != first)
             break;
+
+        if (!strStartAfter.empty() && key.second.second == strStartAfter) {
+            // Resume after the last entry of the previous page
+        } else if (offset < skip) {
+            offset += 1;
+        } else {
+            CAmount amount;
+            if (!pcursor->GetValue(amount))
+                return false;
+            vecResult.emplace_back(key.second.second, amount);
+            loaded += 1;
         }
+        pcursor->Next();
     }
 
     return true;
 }
 
-bool CAssetsDB::AddressDir(std::vector<std::pair<std::string, CAmount> >& vecAssetAmount, int& totalEntries, const bool& fGetTotal, const std::string& address, const size_t count, const long start)
+/** Number of entries of one of the two quantity indexes whose first key part is first */
+static long CountQuantityDir(CDBWrapper& db, char flag, const std::string& first)
 {
-    FlushStateToDisk();
+    std::unique_ptr<CDBIterator> pcursor(db.NewIterator());
+    pcursor->Seek(std::make_pair(flag, std::make_pair(first, std::string())));
 
-    std::unique_ptr<CDBIterator> pcursor(NewIterator());
-    pcursor->Seek(std::make_pair(ADDRESS_ASSET_QUANTITY_FLAG, std::make_pair(address, std::string())));
+    long nEntries = 0;
+    while (pcursor->Valid()) {
+        boost::this_thread::interruption_point();
 
-    if (fGetTotal) {
-        totalEntries = 0;
-        while (pcursor->Valid()) {
-            boost::this_thread::interruption_point();
+        std::pair<char, std::pair<std::string, std::string> > key;
+        if (!pcursor->GetKey(key) || key.first != flag || key.second.first != first)
+            break;
+        nEntries++;
+        pcursor->Next();
+    }
+    return nEntries;
+}
 
-            std::pair<char, std::pair<std::string, std::string> > key;
-            if (pcursor->GetKey(key) && key.first == ADDRESS_ASSET_QUANTITY_FLAG && key.second.first == address) {
-                totalEntries++;
-            }
-            pcursor->Next();
-        }
+bool CAssetsDB::AddressDir(std::vector<std::pair<std::string, CAmount> >& vecAssetAmount, int& totalEntries, const bool& fGetTotal, const std::string& address, const size_t count, const long start)
+{
+    FlushDirtyAssets();
+
+    // An address holds few enough assets that counting them is cheap
+    if (fGetTotal) {
+        totalEntries = CountQuantityDir(*this, ADDRESS_ASSET_QUANTITY_FLAG, address);
         return true;
     }
 
@@ -272,47 +456,21 @@ bool CAssetsDB::AddressDir(std::vector<std::pair<std::string, CAmount> >& vecAss
     }
     else {
         // compute table size for backwards offset
-        long table_size = 0;
-        while (pcursor->Valid()) {
-            boost::this_thread::interruption_point();
-
-            std::pair<char, std::pair<std::string, std::string> > key;
-            if (pcursor->GetKey(key) && key.first == ADDRESS_ASSET_QUANTITY_FLAG && key.second.first == address) {
-                table_size += 1;
-            }
-            pcursor->Next();
-        }
-        skip = table_size + start;
-        pcursor->SeekToFirst();
+        skip = std::max<long>(CountQuantityDir(*this, ADDRESS_ASSET_QUANTITY_FLAG, address) + start, 0);
     }
 
+    if (!ReadQuantityDir(*this, ADDRESS_ASSET_QUANTITY_FLAG, address, "", skip, count, vecAssetAmount))
+        return error("%s: failed to Address Asset Quanity", __func__);
 
-    size_t loaded = 0;
-    size_t offset = 0;
+    return true;
+}
 
-    // Load assets
-    while (pcursor->Valid() && loaded < count && loaded < MAX_DATABASE_RESULTS) {
-        boost::this_thread::interruption_point();
+bool CAssetsDB::AddressDir(std::vector<std::pair<std::string, CAmount> >& vecAssetAmount, const std::string& address, const std::string& strStartAfter, const size_t count)
+{
+    FlushDirtyAssets();
 
-        std::pair<char, std::pair<std::string, std::string> > key;
-        if (pcursor->GetKey(key) && key.first == ADDRESS_ASSET_QUANTITY_FLAG && key.second.first == address) {
-                if (offset < skip) {
-                    offset += 1;
-                }
-                else {
-                    CAmount amount;
-                    if (pcursor->GetValue(amount)) {
-                        vecAssetAmount.emplace_back(std::make_pair(key.second.second, amount));
-                        loaded += 1;
-                    } else {
-                        return error("%s: failed to Address Asset Quanity", __func__);
-                    }
-                }
-            pcursor->Next();
-        } else {
-            break;
-        }
-    }
+    if (!ReadQuantityDir(*this, ADDRESS_ASSET_QUANTITY_FLAG, address, strStartAfter, 0, count, vecAssetAmount))
+        return error("%s: failed to Address Asset Quanity", __func__);
 
     return true;
 }
@@ -320,22 +478,14 @@ bool CAssetsDB::AddressDir(std::vector<std::pair<std::string, CAmount> >& vecAss
 // Can get to total count of addresses that belong to a certain asset_name, or get you the list of all address that belong to a certain asset_name
 bool CAssetsDB::AssetAddressDir(std::vector<std::pair<std::string, CAmount> >& vecAddressAmount, int& totalEntries, const bool& fGetTotal, const std::string& assetName, const size_t count, const long start)
 {
-    FlushStateToDisk();
+    FlushDirtyAssets();
 
-    std::unique_ptr<CDBIterator> pcursor(NewIterator());
-    pcursor->Seek(std::make_pair(ASSET_ADDRESS_QUANTITY_FLAG, std::make_pair(assetName, std::string())));
+    int64_t nHolders;
+    if (!ReadAssetHolderCount(assetName, nHolders))
+        return error("%s: failed to read the holder count of %s", __func__, assetName);
 
     if (fGetTotal) {
-        totalEntries = 0;
-        while (pcursor->Valid()) {
-            boost::this_thread::interruption_point();
-
-            std::pair<char, std::pair<std::string, std::string> > key;
-            if (pcursor->GetKey(key) && key.first == ASSET_ADDRESS_QUANTITY_FLAG && key.second.first == assetName) {
-                totalEntries += 1;
-            }
-            pcursor->Next();
-        }
+        totalEntries = nHolders;
         return true;
     }
 
@@ -344,47 +494,21 @@ bool CAssetsDB::AssetAddressDir(std::vector<std::pair<std::string, CAmount> >& v
         skip = start;
     }
     else {
-        // compute table size for backwards offset
-        long table_size = 0;
-        while (pcursor->Valid()) {
-            boost::this_thread::interruption_point();
-
-            std::pair<char, std::pair<std::string, std::string> > key;
-            if (pcursor->GetKey(key) && key.first == ASSET_ADDRESS_QUANTITY_FLAG && key.second.first == assetName) {
-                table_size += 1;
-            }
-            pcursor->Next();
-        }
-        skip = table_size + start;
-        pcursor->SeekToFirst();
+        skip = std::max<int64_t>(nHolders + start, 0);
     }
 
-    size_t loaded = 0;
-    size_t offset = 0;
+    if (!ReadQuantityDir(*this, ASSET_ADDRESS_QUANTITY_FLAG, assetName, "", skip, count, vecAddressAmount))
+        return error("%s: failed to Asset Address Quanity", __func__);
 
-    // Load assets
-    while (pcursor->Valid() && loaded < count && loaded < MAX_DATABASE_RESULTS) {
-        boost::this_thread::interruption_point();
+    return true;
+}
 
-        std::pair<char, std::pair<std::string, std::string> > key;
-        if (pcursor->GetKey(key) && key.first == ASSET_ADDRESS_QUANTITY_FLAG && key.second.first == assetName) {
-            if (offset < skip) {
-                offset += 1;
-            }
-            else {
-                CAmount amount;
-                if (pcursor->GetValue(amount)) {
-                    vecAddressAmount.emplace_back(std::make_pair(key.second.second, amount));
-                    loaded += 1;
-                } else {
-                    return error("%s: failed to Asset Address Quanity", __func__);
-                }
-            }
-            pcursor->Next();
-        } else {
-            break;
-        }
-    }
+bool CAssetsDB::AssetAddressDir(std::vector<std::pair<std::string, CAmount> >& vecAddressAmount, const std::string& assetName, const std::string& strStartAfter, const size_t count)
+{
+    FlushDirtyAssets();
+
+    if (!ReadQuantityDir(*this, ASSET_ADDRESS_QUANTITY_FLAG, assetName, strStartAfter, 0, count, vecAddressAmount))
+        return error("%s: failed to Asset Address Quanity", __func__);
 
     return true;
 }
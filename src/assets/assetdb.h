@@ -79,6 +79,8 @@ public:
     bool ReadAddressAssetQuantity(const std::string& address, const std::string& assetName, CAmount& quantity);
     bool ReadBlockUndoAssetData(const uint256& blockhash, std::vector<std::pair<std::string, CBlockAssetUndo> >& assetUndoData);
     bool ReadReissuedMempoolState();
+    /** Number of addresses holding assetName, kept up to date with the asset address quantity index */
+    bool ReadAssetHolderCount(const std::string& assetName, int64_t& nCount);
 
     // Erase from database functions
     bool EraseAssetData(const std::string& assetName);
@@ -88,11 +90,22 @@ public:
 
     // Helper functions
     bool LoadAssets();
+    /** Count the holders of every asset once, on databases written before the counts were kept */
+    bool BuildAssetHolderCounts();
+
+    // Directory queries. The start/count versions skip over start entries, the strStartAfter versions
+    // seek straight past the entry named strStartAfter, which is the last one of the previous page.
     bool AssetDir(std::vector<CDatabasedAssetData>& assets, const std::string filter, const size_t count, const long start);
+    bool AssetDir(std::vector<CDatabasedAssetData>& assets, const std::string& filter, const std::string& strStartAfter, const size_t count, const size_t skip);
     bool AssetDir(std::vector<CDatabasedAssetData>& assets);
 
     bool AddressDir(std::vector<std::pair<std::string, CAmount> >& vecAssetAmount, int& totalEntries, const bool& fGetTotal, const std::string& address, const size_t count, const long start);
+    bool AddressDir(std::vector<std::pair<std::string, CAmount> >& vecAssetAmount, const std::string& address, const std::string& strStartAfter, const size_t count);
     bool AssetAddressDir(std::vector<std::pair<std::string, CAmount> >& vecAddressAmount, int& totalEntries, const bool& fGetTotal, const std::string& assetName, const size_t count, const long start);
+    bool AssetAddressDir(std::vector<std::pair<std::string, CAmount> >& vecAddressAmount, const std::string& assetName, const std::string& strStartAfter, const size_t count);
+
+private:
+    void AddHolderCount(CDBBatch& batch, const std::string& assetName, int64_t nChange);
 };
 
 
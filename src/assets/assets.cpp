@@ -45,161 +45,273 @@ std::map<std::string, uint256> mapReissuedAssets;
 static const auto MAX_NAME_LENGTH = 31;
 static const auto MAX_CHANNEL_NAME_LENGTH = 12;
 
-// min lengths are expressed by quantifiers
-static const std::regex ROOT_NAME_CHARACTERS("^[A-Z0-9._]{3,}$");
-static const std::regex SUB_NAME_CHARACTERS("^[A-Z0-9._]+$");
-static const std::regex UNIQUE_TAG_CHARACTERS("^[-A-Za-z0-9@$%&*()[\\]{}_.?:]+$");
-static const std::regex MSG_CHANNEL_TAG_CHARACTERS("^[A-Za-z0-9_]+$");
-static const std::regex VOTE_TAG_CHARACTERS("^[A-Z0-9._]+$");
-
-// Restricted assets
-static const std::regex QUALIFIER_NAME_CHARACTERS("#[A-Z0-9._]{3,}$");
-static const std::regex SUB_QUALIFIER_NAME_CHARACTERS("#[A-Z0-9._]+$");
-static const std::regex RESTRICTED_NAME_CHARACTERS("\\$[A-Z0-9._]{3,}$");
-
-static const std::regex DOUBLE_PUNCTUATION("^.*[._]{2,}.*$");
-static const std::regex LEADING_PUNCTUATION("^[._].*$");
-static const std::regex TRAILING_PUNCTUATION("^.*[._]$");
-static const std::regex QUALIFIER_LEADING_PUNCTUATION("^[#\\$][._].*$"); // Used for qualifier assets, and restricted asset only
-
 static const std::string SUB_NAME_DELIMITER = "/";
 static const std::string UNIQUE_TAG_DELIMITER = "#";
 static const std::string MSG_CHANNEL_TAG_DELIMITER = "~";
 static const std::string VOTE_TAG_DELIMITER = "^";
 static const std::string RESTRICTED_TAG_DELIMITER = "$";
 
-static const std::regex UNIQUE_INDICATOR(R"(^[^^~#!]+#[^~#!\/]+$)");
-static const std::regex MSG_CHANNEL_INDICATOR(R"(^[^^~#!]+~[^~#!\/]+$)");
-static const std::regex OWNER_INDICATOR(R"(^[^^~#!]+!$)");
-static const std::regex VOTE_INDICATOR(R"(^[^^~#!]+\^[^~#!\/]+$)");
+// Names are validated in a single pass over the characters with the class table below.
+// The regular expression each check implements is kept in its comment; the std::regex
+// implementation they replaced lives on in test/assets/asset_name_regex.h, which the
+// unit and fuzz tests compare against.
+enum AssetNameCharClass : uint8_t
+{
+    NAME_CHAR = 1 << 0,            //!< [A-Z0-9._]
+    PUNCTUATION_CHAR = 1 << 1,     //!< [._]
+    UNIQUE_TAG_CHAR = 1 << 2,      //!< [-A-Za-z0-9@$%&*()[\]{}_.?:]
+    MSG_CHANNEL_TAG_CHAR = 1 << 3, //!< [A-Za-z0-9_]
+    TAG_PREFIX_STOP_CHAR = 1 << 4, //!< [\^~#!], not allowed before a tag delimiter
+    TAG_SUFFIX_STOP_CHAR = 1 << 5, //!< [~#!/], not allowed after a tag delimiter
+};
 
-static const std::regex QUALIFIER_INDICATOR("^[#][A-Z0-9._]{3,}$"); // Starts with #
-static const std::regex SUB_QUALIFIER_INDICATOR("^#[A-Z0-9._]+\\/#[A-Z0-9._]+$"); // Starts with #
-static const std::regex RESTRICTED_INDICATOR("^[\\$][A-Z0-9._]{3,}$"); // Starts with $
+struct AssetNameCharTable
+{
+    uint8_t classes[256];
+};
 
-static const std::regex NRGC_NAMES("^NRGC$|^NRGC$|^ENERGYCOIN$|^#NRGC$|^#NRGC$|^#ENERGYCOIN$");
+static constexpr bool IsCharOneOf(int c, const char* chars)
+{
+    for (; *chars; chars++) {
+        if (c == (unsigned char)*chars)
+            return true;
+    }
+    return false;
+}
 
-bool IsRootNameValid(const std::string& name)
+static constexpr AssetNameCharTable MakeAssetNameCharTable()
 {
-    return std::regex_match(name, ROOT_NAME_CHARACTERS)
-        && !std::regex_match(name, DOUBLE_PUNCTUATION)
-        && !std::regex_match(name, LEADING_PUNCTUATION)
-        && !std::regex_match(name, TRAILING_PUNCTUATION)
-        && !std::regex_match(name, NRGC_NAMES);
+    AssetNameCharTable table{};
+    for (int c = 0; c < 256; c++) {
+        const bool fUpper = c >= 'A' && c <= 'Z';
+        const bool fLower = c >= 'a' && c <= 'z';
+        const bool fDigit = c >= '0' && c <= '9';
+        uint8_t classes = 0;
+        if (fUpper || fDigit || IsCharOneOf(c, "._"))
+            classes |= NAME_CHAR;
+        if (IsCharOneOf(c, "._"))
+            classes |= PUNCTUATION_CHAR;
+        if (fUpper || fLower || fDigit || IsCharOneOf(c, "-@$%&*()[]{}_.?:"))
+            classes |= UNIQUE_TAG_CHAR;
+        if (fUpper || fLower || fDigit || c == '_')
+            classes |= MSG_CHANNEL_TAG_CHAR;
+        if (IsCharOneOf(c, "^~#!"))
+            classes |= TAG_PREFIX_STOP_CHAR;
+        if (IsCharOneOf(c, "~#!/"))
+            classes |= TAG_SUFFIX_STOP_CHAR;
+        table.classes[c] = classes;
+    }
+    return table;
 }
 
-bool IsQualifierNameValid(const std::string& name)
+static constexpr AssetNameCharTable ASSET_NAME_CHARS = MakeAssetNameCharTable();
+
+static const char* const NRGC_NAMES[] = {"NRGC", "ENERGYCOIN", "#NRGC", "#ENERGYCOIN"};
+
+static inline bool HasCharClass(char c, uint8_t nClass)
 {
-    return std::regex_match(name, QUALIFIER_NAME_CHARACTERS)
-           && !std::regex_match(name, DOUBLE_PUNCTUATION)
-           && !std::regex_match(name, QUALIFIER_LEADING_PUNCTUATION)
-           && !std::regex_match(name, TRAILING_PUNCTUATION)
-           && !std::regex_match(name, NRGC_NAMES);
+    return ASSET_NAME_CHARS.classes[(unsigned char)c] & nClass;
 }
 
-bool IsRestrictedNameValid(const std::string& name)
+/** ^[class]{nMin,}$ */
+static bool IsAllOfCharClass(const char* p, size_t n, uint8_t nClass, size_t nMin)
 {
-    return std::regex_match(name, RESTRICTED_NAME_CHARACTERS)
-           && !std::regex_match(name, DOUBLE_PUNCTUATION)
-           && !std::regex_match(name, LEADING_PUNCTUATION)
-           && !std::regex_match(name, TRAILING_PUNCTUATION)
-           && !std::regex_match(name, NRGC_NAMES);
+    if (n < nMin)
+        return false;
+    for (size_t i = 0; i < n; i++) {
+        if (!HasCharClass(p[i], nClass))
+            return false;
+    }
+    return true;
 }
 
-bool IsSubQualifierNameValid(const std::string& name)
+/**
+ * None of ^.*[._]{2,}.*$ (DOUBLE_PUNCTUATION), ^.*[._]$ (TRAILING_PUNCTUATION) and, with
+ * fLeading, ^[._].*$ (LEADING_PUNCTUATION). Only called on names already known to be
+ * made of NAME_CHAR or MSG_CHANNEL_TAG_CHAR, which do not include line terminators.
+ */
+static bool HasValidPunctuation(const char* p, size_t n, bool fLeading)
 {
-    return std::regex_match(name, SUB_QUALIFIER_NAME_CHARACTERS)
-           && !std::regex_match(name, DOUBLE_PUNCTUATION)
-           && !std::regex_match(name, LEADING_PUNCTUATION)
-           && !std::regex_match(name, TRAILING_PUNCTUATION);
+    if (n == 0)
+        return true;
+    if (fLeading && HasCharClass(p[0], PUNCTUATION_CHAR))
+        return false;
+    if (HasCharClass(p[n - 1], PUNCTUATION_CHAR))
+        return false;
+    for (size_t i = 1; i < n; i++) {
+        if (HasCharClass(p[i - 1], PUNCTUATION_CHAR) && HasCharClass(p[i], PUNCTUATION_CHAR))
+            return false;
+    }
+    return true;
 }
 
-bool IsSubNameValid(const std::string& name)
+/** ^NRGC$|^ENERGYCOIN$|^#NRGC$|^#ENERGYCOIN$ */
+static bool IsNrgcName(const char* p, size_t n)
 {
-    return std::regex_match(name, SUB_NAME_CHARACTERS)
-        && !std::regex_match(name, DOUBLE_PUNCTUATION)
-        && !std::regex_match(name, LEADING_PUNCTUATION)
-        && !std::regex_match(name, TRAILING_PUNCTUATION);
+    for (const char* reserved : NRGC_NAMES) {
+        if (n == strlen(reserved) && memcmp(p, reserved, n) == 0)
+            return true;
+    }
+    return false;
 }
 
-bool IsUniqueTagValid(const std::string& tag)
+static bool IsRootNameValid(const char* p, size_t n)
 {
-    return std::regex_match(tag, UNIQUE_TAG_CHARACTERS);
+    // ^[A-Z0-9._]{3,}$
+    return IsAllOfCharClass(p, n, NAME_CHAR, 3)
+        && HasValidPunctuation(p, n, true)
+        && !IsNrgcName(p, n);
 }
 
-bool IsVoteTagValid(const std::string& tag)
+static bool IsQualifierNameValid(const char* p, size_t n)
 {
-    return std::regex_match(tag, VOTE_TAG_CHARACTERS);
+    // #[A-Z0-9._]{3,}$, the leading punctuation rule applies after the '#' (^[#\$][._].*$)
+    return n > 0 && p[0] == QUALIFIER_CHAR
+           && IsAllOfCharClass(p + 1, n - 1, NAME_CHAR, 3)
+           && HasValidPunctuation(p + 1, n - 1, true)
+           && !IsNrgcName(p, n);
 }
 
-bool IsMsgChannelTagValid(const std::string &tag)
+static bool IsRestrictedNameValid(const char* p, size_t n)
 {
-    return std::regex_match(tag, MSG_CHANNEL_TAG_CHARACTERS)
-        && !std::regex_match(tag, DOUBLE_PUNCTUATION)
-        && !std::regex_match(tag, LEADING_PUNCTUATION)
-        && !std::regex_match(tag, TRAILING_PUNCTUATION);
+    // \$[A-Z0-9._]{3,}$, the leading punctuation rule only ever sees the '$'
+    return n > 0 && p[0] == RESTRICTED_CHAR
+           && IsAllOfCharClass(p + 1, n - 1, NAME_CHAR, 3)
+           && HasValidPunctuation(p + 1, n - 1, false)
+           && !IsNrgcName(p, n);
 }
 
-bool IsNameValidBeforeTag(const std::string& name)
+static bool IsSubQualifierNameValid(const char* p, size_t n)
 {
-    std::vector<std::string> parts;
-    boost::split(parts, name, boost::is_any_of(SUB_NAME_DELIMITER));
+    // #[A-Z0-9._]+$, the leading punctuation rule only ever sees the '#'
+    return n > 0 && p[0] == QUALIFIER_CHAR
+           && IsAllOfCharClass(p + 1, n - 1, NAME_CHAR, 1)
+           && HasValidPunctuation(p + 1, n - 1, false);
+}
 
-    if (!IsRootNameValid(parts.front())) return false;
+static bool IsSubNameValid(const char* p, size_t n)
+{
+    // ^[A-Z0-9._]+$
+    return IsAllOfCharClass(p, n, NAME_CHAR, 1)
+        && HasValidPunctuation(p, n, true);
+}
 
-    if (parts.size() > 1)
-    {
-        for (unsigned long i = 1; i < parts.size(); i++)
-        {
-            if (!IsSubNameValid(parts[i])) return false;
-        }
+static bool IsUniqueTagValid(const char* p, size_t n)
+{
+    // ^[-A-Za-z0-9@$%&*()[\]{}_.?:]+$
+    return IsAllOfCharClass(p, n, UNIQUE_TAG_CHAR, 1);
+}
+
+bool IsUniqueTagValid(const std::string& tag)
+{
+    return IsUniqueTagValid(tag.data(), tag.size());
+}
+
+static bool IsVoteTagValid(const char* p, size_t n)
+{
+    // ^[A-Z0-9._]+$
+    return IsAllOfCharClass(p, n, NAME_CHAR, 1);
+}
+
+static bool IsMsgChannelTagValid(const char* p, size_t n)
+{
+    // ^[A-Za-z0-9_]+$
+    return IsAllOfCharClass(p, n, MSG_CHANNEL_TAG_CHAR, 1)
+        && HasValidPunctuation(p, n, true);
+}
+
+static bool IsNameValidBeforeTag(const char* p, size_t n)
+{
+    // The root name, followed by any number of /SUB names
+    const char* pend = p + n;
+    const char* psep = std::find(p, pend, SUB_NAME_DELIMITER[0]);
+    if (!IsRootNameValid(p, psep - p)) return false;
+
+    while (psep != pend) {
+        const char* pbegin = psep + 1;
+        psep = std::find(pbegin, pend, SUB_NAME_DELIMITER[0]);
+        if (!IsSubNameValid(pbegin, psep - pbegin)) return false;
     }
 
     return true;
 }
 
-bool IsQualifierNameValidBeforeTag(const std::string& name)
+static bool IsQualifierNameValidBeforeTag(const char* p, size_t n)
 {
-    std::vector<std::string> parts;
-    boost::split(parts, name, boost::is_any_of(SUB_NAME_DELIMITER));
+    const char* pend = p + n;
+    const char* psep = std::find(p, pend, SUB_NAME_DELIMITER[0]);
+    if (!IsQualifierNameValid(p, psep - p)) return false;
 
-    if (!IsQualifierNameValid(parts.front())) return false;
+    if (psep == pend)
+        return true;
 
     // Qualifiers can only have one sub qualifier under it
-    if (parts.size() > 2) {
+    const char* pbegin = psep + 1;
+    if (std::find(pbegin, pend, SUB_NAME_DELIMITER[0]) != pend)
         return false;
-    }
 
-    if (parts.size() > 1)
-    {
+    return IsSubQualifierNameValid(pbegin, pend - pbegin);
+}
 
-        for (unsigned long i = 1; i < parts.size(); i++)
-        {
-            if (!IsSubQualifierNameValid(parts[i])) return false;
-        }
-    }
+bool IsAssetNameASubasset(const std::string& name)
+{
+    size_t nSep = name.find(SUB_NAME_DELIMITER[0]);
+    return IsRootNameValid(name.data(), std::min(nSep, name.size())) && nSep != std::string::npos;
+}
 
-    return true;
+bool IsAssetNameASubQualifier(const std::string& name)
+{
+    size_t nSep = name.find(SUB_NAME_DELIMITER[0]);
+    return IsQualifierNameValid(name.data(), std::min(nSep, name.size())) && nSep != std::string::npos;
 }
 
-bool IsAssetNameASubasset(const std::string& name)
+/**
+ * ^[^^~#!]+<delimiter>[^~#!\/]+$ for the unique, message channel and vote tags,
+ * and ^[^^~#!]+!$ for the owner tag.
+ */
+static bool HasTagIndicator(const std::string& name, char cDelimiter)
 {
-    std::vector<std::string> parts;
-    boost::split(parts, name, boost::is_any_of(SUB_NAME_DELIMITER));
+    // The delimiter has to be the first of ^~#! in the name
+    size_t nPos = 0;
+    while (nPos < name.size() && !HasCharClass(name[nPos], TAG_PREFIX_STOP_CHAR))
+        nPos++;
+    if (nPos == 0 || nPos == name.size() || name[nPos] != cDelimiter)
+        return false;
 
-    if (!IsRootNameValid(parts.front())) return false;
+    if (cDelimiter == OWNER_TAG[0])
+        return nPos == name.size() - 1;
 
-    return parts.size() > 1;
+    if (nPos == name.size() - 1)
+        return false;
+    for (size_t i = nPos + 1; i < name.size(); i++) {
+        if (HasCharClass(name[i], TAG_SUFFIX_STOP_CHAR))
+            return false;
+    }
+    return true;
 }
 
-bool IsAssetNameASubQualifier(const std::string& name)
+static bool HasQualifierIndicator(const std::string& name)
 {
-    std::vector<std::string> parts;
-    boost::split(parts, name, boost::is_any_of(SUB_NAME_DELIMITER));
+    // ^[#][A-Z0-9._]{3,}$
+    return !name.empty() && name[0] == QUALIFIER_CHAR
+           && IsAllOfCharClass(name.data() + 1, name.size() - 1, NAME_CHAR, 3);
+}
 
-    if (!IsQualifierNameValid(parts.front())) return false;
+static bool HasSubQualifierIndicator(const std::string& name)
+{
+    // ^#[A-Z0-9._]+\/#[A-Z0-9._]+$
+    size_t nSep = name.find(SUB_NAME_DELIMITER[0]);
+    return !name.empty() && name[0] == QUALIFIER_CHAR && nSep != std::string::npos
+           && IsAllOfCharClass(name.data() + 1, nSep - 1, NAME_CHAR, 1)
+           && nSep + 1 < name.size() && name[nSep + 1] == QUALIFIER_CHAR
+           && IsAllOfCharClass(name.data() + nSep + 2, name.size() - nSep - 2, NAME_CHAR, 1);
+}
 
-    return parts.size() > 1;
+static bool HasRestrictedIndicator(const std::string& name)
+{
+    // ^[\$][A-Z0-9._]{3,}$
+    return !name.empty() && name[0] == RESTRICTED_CHAR
+           && IsAllOfCharClass(name.data() + 1, name.size() - 1, NAME_CHAR, 3);
 }
 
 
@@ -211,7 +323,7 @@ bool IsAssetNameValid(const std::string& name, AssetType& assetType, std::string
         return false;
 
     assetType = AssetType::INVALID;
-    if (std::regex_match(name, UNIQUE_INDICATOR))
+    if (HasTagIndicator(name, UNIQUE_TAG_DELIMITER[0]))
     {
         bool ret = IsTypeCheckNameValid(AssetType::UNIQUE, name, error);
         if (ret)
@@ -219,7 +331,7 @@ bool IsAssetNameValid(const std::string& name, AssetType& assetType, std::string
 
         return ret;
     }
-    else if (std::regex_match(name, MSG_CHANNEL_INDICATOR))
+    else if (HasTagIndicator(name, MSG_CHANNEL_TAG_DELIMITER[0]))
     {
         bool ret = IsTypeCheckNameValid(AssetType::MSGCHANNEL, name, error);
         if (ret)
@@ -227,7 +339,7 @@ bool IsAssetNameValid(const std::string& name, AssetType& assetType, std::string
 
         return ret;
     }
-    else if (std::regex_match(name, OWNER_INDICATOR))
+    else if (HasTagIndicator(name, OWNER_TAG[0]))
     {
         bool ret = IsTypeCheckNameValid(AssetType::OWNER, name, error);
         if (ret)
@@ -235,7 +347,7 @@ bool IsAssetNameValid(const std::string& name, AssetType& assetType, std::string
 
         return ret;
     }
-    else if (std::regex_match(name, VOTE_INDICATOR))
+    else if (HasTagIndicator(name, VOTE_TAG_DELIMITER[0]))
     {
         bool ret = IsTypeCheckNameValid(AssetType::VOTE, name, error);
         if (ret)
@@ -243,7 +355,7 @@ bool IsAssetNameValid(const std::string& name, AssetType& assetType, std::string
 
         return ret;
     }
-    else if (std::regex_match(name, QUALIFIER_INDICATOR))
+    else if (HasQualifierIndicator(name))
     {
         bool ret = IsTypeCheckNameValid(AssetType::QUALIFIER, name, error);
         if (ret) {
@@ -255,7 +367,7 @@ bool IsAssetNameValid(const std::string& name, AssetType& assetType, std::string
 
         return ret;
     }
-    else if (std::regex_match(name, SUB_QUALIFIER_INDICATOR))
+    else if (HasSubQualifierIndicator(name))
     {
         bool ret = IsTypeCheckNameValid(AssetType::SUB_QUALIFIER, name, error);
         if (ret) {
@@ -265,7 +377,7 @@ bool IsAssetNameValid(const std::string& name, AssetType& assetType, std::string
 
         return ret;
     }
-    else if (std::regex_match(name, RESTRICTED_INDICATOR))
+    else if (HasRestrictedIndicator(name))
     {
         bool ret = IsTypeCheckNameValid(AssetType::RESTRICTED, name, error);
         if (ret)
@@ -305,72 +417,73 @@ bool IsAssetNameARoot(const std::string& name)
 
 bool IsAssetNameAnOwner(const std::string& name)
 {
-    return IsAssetNameValid(name) && std::regex_match(name, OWNER_INDICATOR);
+    return IsAssetNameValid(name) && HasTagIndicator(name, OWNER_TAG[0]);
 }
 
 bool IsAssetNameAnRestricted(const std::string& name)
 {
-    return IsAssetNameValid(name) && std::regex_match(name, RESTRICTED_INDICATOR);
+    return IsAssetNameValid(name) && HasRestrictedIndicator(name);
 }
 
 bool IsAssetNameAQualifier(const std::string& name, bool fOnlyQualifiers)
 {
     if (fOnlyQualifiers) {
-        return IsAssetNameValid(name) && std::regex_match(name, QUALIFIER_INDICATOR);
+        return IsAssetNameValid(name) && HasQualifierIndicator(name);
     }
 
-    return IsAssetNameValid(name) && (std::regex_match(name, QUALIFIER_INDICATOR) || std::regex_match(name, SUB_QUALIFIER_INDICATOR));
+    return IsAssetNameValid(name) && (HasQualifierIndicator(name) || HasSubQualifierIndicator(name));
 }
 
 bool IsAssetNameAnMsgChannel(const std::string& name)
 {
-    return IsAssetNameValid(name) && std::regex_match(name, MSG_CHANNEL_INDICATOR);
+    return IsAssetNameValid(name) && HasTagIndicator(name, MSG_CHANNEL_TAG_DELIMITER[0]);
 }
 
 // TODO get the string translated below
 bool IsTypeCheckNameValid(const AssetType type, const std::string& name, std::string& error)
 {
+    // The name before the first tag delimiter and the tag after the last one
+    auto front = [&name](char cDelimiter) { return std::min(name.find(cDelimiter), name.size()); };
+    auto back = [&name](char cDelimiter) { size_t nPos = name.rfind(cDelimiter); return nPos == std::string::npos ? 0 : nPos + 1; };
+
     if (type == AssetType::UNIQUE) {
         if (name.size() > MAX_NAME_LENGTH) { error = "Name is greater than max length of " + std::to_string(MAX_NAME_LENGTH); return false; }
-        std::vector<std::string> parts;
-        boost::split(parts, name, boost::is_any_of(UNIQUE_TAG_DELIMITER));
-        bool valid = IsNameValidBeforeTag(parts.front()) && IsUniqueTagValid(parts.back());
+        size_t nTag = back(UNIQUE_TAG_DELIMITER[0]);
+        bool valid = IsNameValidBeforeTag(name.data(), front(UNIQUE_TAG_DELIMITER[0])) && IsUniqueTagValid(name.data() + nTag, name.size() - nTag);
         if (!valid) { error = "Unique name contains invalid characters (Valid characters are: A-Z a-z 0-9 @ $ % & * ( ) [ ] { } _ . ? : -)";  return false; }
         return true;
     } else if (type == AssetType::MSGCHANNEL) {
         if (name.size() > MAX_NAME_LENGTH) { error = "Name is greater than max length of " + std::to_string(MAX_NAME_LENGTH); return false; }
-        std::vector<std::string> parts;
-        boost::split(parts, name, boost::is_any_of(MSG_CHANNEL_TAG_DELIMITER));
-        bool valid = IsNameValidBeforeTag(parts.front()) && IsMsgChannelTagValid(parts.back());
-        if (parts.back().size() > MAX_CHANNEL_NAME_LENGTH) { error = "Channel name is greater than max length of " + std::to_string(MAX_CHANNEL_NAME_LENGTH); return false; }
+        size_t nTag = back(MSG_CHANNEL_TAG_DELIMITER[0]);
+        bool valid = IsNameValidBeforeTag(name.data(), front(MSG_CHANNEL_TAG_DELIMITER[0])) && IsMsgChannelTagValid(name.data() + nTag, name.size() - nTag);
+        if (name.size() - nTag > MAX_CHANNEL_NAME_LENGTH) { error = "Channel name is greater than max length of " + std::to_string(MAX_CHANNEL_NAME_LENGTH); return false; }
         if (!valid) { error = "Message Channel name contains invalid characters (Valid characters are: A-Z 0-9 _ .) (special characters can't be the first or last characters)";  return false; }
         return true;
     } else if (type == AssetType::OWNER) {
         if (name.size() > MAX_NAME_LENGTH) { error = "Name is greater than max length of " + std::to_string(MAX_NAME_LENGTH); return false; }
-        bool valid = IsNameValidBeforeTag(name.substr(0, name.size() - 1));
+        bool valid = IsNameValidBeforeTag(name.data(), name.empty() ? 0 : name.size() - 1);
         if (!valid) { error = "Owner name contains invalid characters (Valid characters are: A-Z 0-9 _ .) (special characters can't be the first or last characters)";  return false; }
         return true;
     } else if (type == AssetType::VOTE) {
         if (name.size() > MAX_NAME_LENGTH) { error = "Name is greater than max length of " + std::to_string(MAX_NAME_LENGTH); return false; }
-        std::vector<std::string> parts;
-        boost::split(parts, name, boost::is_any_of(VOTE_TAG_DELIMITER));
-        bool valid = IsNameValidBeforeTag(parts.front()) && IsVoteTagValid(parts.back());
+        size_t nTag = back(VOTE_TAG_DELIMITER[0]);
+        bool valid = IsNameValidBeforeTag(name.data(), front(VOTE_TAG_DELIMITER[0])) && IsVoteTagValid(name.data() + nTag, name.size() - nTag);
         if (!valid) { error = "Vote name contains invalid characters (Valid characters are: A-Z 0-9 _ .) (special characters can't be the first or last characters)";  return false; }
         return true;
     } else if (type == AssetType::QUALIFIER || type == AssetType::SUB_QUALIFIER) {
         if (name.size() > MAX_NAME_LENGTH) { error = "Name is greater than max length of " + std::to_string(MAX_NAME_LENGTH); return false; }
-        bool valid = IsQualifierNameValidBeforeTag(name);
+        bool valid = IsQualifierNameValidBeforeTag(name.data(), name.size());
         if (!valid) { error = "Qualifier name contains invalid characters (Valid characters are: A-Z 0-9 _ .) (# must be the first character, _ . special characters can't be the first or last characters)";  return false; }
         return true;
     } else if (type == AssetType::RESTRICTED) {
         if (name.size() > MAX_NAME_LENGTH) { error = "Name is greater than max length of " + std::to_string(MAX_NAME_LENGTH); return false; }
-        bool valid = IsRestrictedNameValid(name);
+        bool valid = IsRestrictedNameValid(name.data(), name.size());
         if (!valid) { error = "Restricted name contains invalid characters (Valid characters are: A-Z 0-9 _ .) ($ must be the first character, _ . special characters can't be the first or last characters)";  return false; }
         return true;
     } else {
         if (name.size() > MAX_NAME_LENGTH - 1) { error = "Name is greater than max length of " + std::to_string(MAX_NAME_LENGTH - 1); return false; }  //Assets and sub-assets need to leave one extra char for OWNER indicator
         if (!IsAssetNameASubasset(name) && name.size() < MIN_ASSET_LENGTH) { error = "Name must be contain " + std::to_string(MIN_ASSET_LENGTH) + " characters"; return false; }
-        bool valid = IsNameValidBeforeTag(name);
+        bool valid = IsNameValidBeforeTag(name.data(), name.size());
         if (!valid && IsAssetNameASubasset(name) && name.size() < 3) { error = "Name must have at least 3 characters (Valid characters are: A-Z 0-9 _ .)";  return false; }
         if (!valid) { error = "Name contains invalid characters (Valid characters are: A-Z 0-9 _ .) (special characters can't be the first or last characters)";  return false; }
         return true;
@@ -1609,7 +1722,7 @@ bool CAssetTransfer::ContextualCheckAgainstVerifyString(CAssetsCache *assetCache
         return false;
     }
 
-    if (!ContextualCheckVerifierString(assetCache, verifier.verifier_string, address, strError))
+    if (!ContextualCheckVerifierString(assetCache, verifier.verifier_string, address, strError, nullptr, this->strName))
         return false;
 
     return true;
@@ -2551,6 +2664,8 @@ bool CAssetsCache::DumpCacheToDatabase()
             }
 
             passetsVerifierCache->Erase(assetName);
+            if (passetsCompiledVerifierCache)
+                passetsCompiledVerifierCache->Erase(assetName);
         }
 
         // Undo verifier string for restricted assets
@@ -2575,6 +2690,8 @@ bool CAssetsCache::DumpCacheToDatabase()
             }
 
             passetsVerifierCache->Erase(assetName);
+            if (passetsCompiledVerifierCache)
+                passetsCompiledVerifierCache->Erase(assetName);
         }
 
         // Add the new qualifier commands to the database
@@ -2810,180 +2927,244 @@ bool CAssetsCache::DumpCacheToDatabase()
 
 // This function will put all current cache data into the global passets cache.
 //! Do not call this function on the passets pointer
-bool CAssetsCache::Flush()
+CAssetsCache* CAssetsCache::Parent() const
+{
+    if (pparent)
+        return pparent;
+    return passets != this ? passets : nullptr;
+}
+
+const CAssetsCache* CAssetsCache::FirstDirtyCache(bool fSkipTempCache) const
 {
+    // Skipping the temp cache still searches the global cache when it is the one being asked
+    CAssetsCache* parent = Parent();
+    return fSkipTempCache && parent ? parent : this;
+}
 
-    if (!passets)
-        return error("%s: Couldn't find passets pointer while trying to flush assets cache", __func__);
+bool CAssetsCache::Flush()
+{
+    CAssetsCache* parent = Parent();
+    if (!parent)
+        return error("%s: Couldn't find the parent cache while trying to flush assets cache", __func__);
 
     try {
+        // RPCs read the database caches without cs_main, so they must never hold data older than the
+        // tip. Drop every entry this flush changes, it is cached again on the next lookup.
+        if (parent == passets && passetsCache) {
+            for (auto &item : setNewAssetsToAdd)
+                passetsCache->Erase(item.asset.strName);
+            for (auto &item : setNewAssetsToRemove)
+                passetsCache->Erase(item.asset.strName);
+            for (auto &item : mapReissuedAssetData)
+                passetsCache->Erase(item.first);
+            for (auto &item : setNewReissueToAdd)
+                passetsCache->Erase(item.reissue.strName);
+            for (auto &item : setNewReissueToRemove)
+                passetsCache->Erase(item.reissue.strName);
+        }
+
+        if (parent == passets && passetsVerifierCache) {
+            for (auto &item : setNewRestrictedVerifierToAdd)
+                passetsVerifierCache->Erase(item.assetName);
+            for (auto &item : setNewRestrictedVerifierToRemove)
+                passetsVerifierCache->Erase(item.assetName);
+        }
+
+        if (parent == passets && passetsCompiledVerifierCache) {
+            for (auto &item : setNewRestrictedVerifierToAdd)
+                passetsCompiledVerifierCache->Erase(item.assetName);
+            for (auto &item : setNewRestrictedVerifierToRemove)
+                passetsCompiledVerifierCache->Erase(item.assetName);
+        }
+
+        if (parent == passets && passetsQualifierCache) {
+            for (auto item : setNewQualifierAddressToAdd)
+                passetsQualifierCache->Erase(item.GetHash().GetHex());
+            for (auto item : setNewQualifierAddressToRemove)
+                passetsQualifierCache->Erase(item.GetHash().GetHex());
+        }
+
+        if (parent == passets && passetsRestrictionCache) {
+            for (auto item : setNewRestrictedAddressToAdd)
+                passetsRestrictionCache->Erase(item.GetHash().GetHex());
+            for (auto item : setNewRestrictedAddressToRemove)
+                passetsRestrictionCache->Erase(item.GetHash().GetHex());
+        }
+
+        if (parent == passets && passetsGlobalRestrictionCache) {
+            for (auto &item : setNewRestrictedGlobalToAdd)
+                passetsGlobalRestrictionCache->Erase(item.assetName);
+            for (auto &item : setNewRestrictedGlobalToRemove)
+                passetsGlobalRestrictionCache->Erase(item.assetName);
+        }
+
         for (auto &item : setNewAssetsToAdd) {
-            if (passets->setNewAssetsToRemove.count(item))
-                passets->setNewAssetsToRemove.erase(item);
-            passets->setNewAssetsToAdd.insert(item);
+            if (parent->setNewAssetsToRemove.count(item))
+                parent->setNewAssetsToRemove.erase(item);
+            parent->setNewAssetsToAdd.insert(item);
         }
 
         for (auto &item : setNewAssetsToRemove) {
-            if (passets->setNewAssetsToAdd.count(item))
-                passets->setNewAssetsToAdd.erase(item);
-            passets->setNewAssetsToRemove.insert(item);
+            if (parent->setNewAssetsToAdd.count(item))
+                parent->setNewAssetsToAdd.erase(item);
+            parent->setNewAssetsToRemove.insert(item);
         }
 
         for (auto &item : mapAssetsAddressAmount)
-            passets->mapAssetsAddressAmount[item.first] = item.second;
+            parent->mapAssetsAddressAmount[item.first] = item.second;
 
         for (auto &item : mapReissuedAssetData)
-            passets->mapReissuedAssetData[item.first] = item.second;
+            parent->mapReissuedAssetData[item.first] = item.second;
 
         for (auto &item : setNewOwnerAssetsToAdd) {
-            if (passets->setNewOwnerAssetsToRemove.count(item))
-                passets->setNewOwnerAssetsToRemove.erase(item);
-            passets->setNewOwnerAssetsToAdd.insert(item);
+            if (parent->setNewOwnerAssetsToRemove.count(item))
+                parent->setNewOwnerAssetsToRemove.erase(item);
+            parent->setNewOwnerAssetsToAdd.insert(item);
         }
 
         for (auto &item : setNewOwnerAssetsToRemove) {
-            if (passets->setNewOwnerAssetsToAdd.count(item))
-                passets->setNewOwnerAssetsToAdd.erase(item);
-            passets->setNewOwnerAssetsToRemove.insert(item);
+            if (parent->setNewOwnerAssetsToAdd.count(item))
+                parent->setNewOwnerAssetsToAdd.erase(item);
+            parent->setNewOwnerAssetsToRemove.insert(item);
         }
 
         for (auto &item : setNewReissueToAdd) {
-            if (passets->setNewReissueToRemove.count(item))
-                passets->setNewReissueToRemove.erase(item);
-            passets->setNewReissueToAdd.insert(item);
+            if (parent->setNewReissueToRemove.count(item))
+                parent->setNewReissueToRemove.erase(item);
+            parent->setNewReissueToAdd.insert(item);
         }
 
         for (auto &item : setNewReissueToRemove) {
-            if (passets->setNewReissueToAdd.count(item))
-                passets->setNewReissueToAdd.erase(item);
-            passets->setNewReissueToRemove.insert(item);
+            if (parent->setNewReissueToAdd.count(item))
+                parent->setNewReissueToAdd.erase(item);
+            parent->setNewReissueToRemove.insert(item);
         }
 
         for (auto &item : setNewTransferAssetsToAdd) {
-            if (passets->setNewTransferAssetsToRemove.count(item))
-                passets->setNewTransferAssetsToRemove.erase(item);
-            passets->setNewTransferAssetsToAdd.insert(item);
+            if (parent->setNewTransferAssetsToRemove.count(item))
+                parent->setNewTransferAssetsToRemove.erase(item);
+            parent->setNewTransferAssetsToAdd.insert(item);
         }
 
         for (auto &item : setNewTransferAssetsToRemove) {
-            if (passets->setNewTransferAssetsToAdd.count(item))
-                passets->setNewTransferAssetsToAdd.erase(item);
-            passets->setNewTransferAssetsToRemove.insert(item);
+            if (parent->setNewTransferAssetsToAdd.count(item))
+                parent->setNewTransferAssetsToAdd.erase(item);
+            parent->setNewTransferAssetsToRemove.insert(item);
         }
 
         for (auto &item : vSpentAssets) {
-            passets->vSpentAssets.emplace_back(item);
+            parent->vSpentAssets.emplace_back(item);
         }
 
         for (auto &item : vUndoAssetAmount) {
-            passets->vUndoAssetAmount.emplace_back(item);
+            parent->vUndoAssetAmount.emplace_back(item);
         }
 
         for(auto &item : setNewQualifierAddressToAdd) {
-            if (passets->setNewQualifierAddressToRemove.count(item)) {
-                passets->setNewQualifierAddressToRemove.erase(item);
+            if (parent->setNewQualifierAddressToRemove.count(item)) {
+                parent->setNewQualifierAddressToRemove.erase(item);
             }
 
-            if (passets->setNewQualifierAddressToAdd.count(item)) {
-                passets->setNewQualifierAddressToAdd.erase(item);
+            if (parent->setNewQualifierAddressToAdd.count(item)) {
+                parent->setNewQualifierAddressToAdd.erase(item);
             }
 
-            passets->setNewQualifierAddressToAdd.insert(item);
+            parent->setNewQualifierAddressToAdd.insert(item);
         }
 
         for(auto &item : setNewQualifierAddressToRemove) {
-            if (passets->setNewQualifierAddressToAdd.count(item)) {
-                passets->setNewQualifierAddressToAdd.erase(item);
+            if (parent->setNewQualifierAddressToAdd.count(item)) {
+                parent->setNewQualifierAddressToAdd.erase(item);
             }
 
-            if (passets->setNewQualifierAddressToRemove.count(item)) {
-                passets->setNewQualifierAddressToRemove.erase(item);
+            if (parent->setNewQualifierAddressToRemove.count(item)) {
+                parent->setNewQualifierAddressToRemove.erase(item);
             }
 
-            passets->setNewQualifierAddressToRemove.insert(item);
+            parent->setNewQualifierAddressToRemove.insert(item);
         }
 
         for(auto &item : setNewRestrictedAddressToAdd) {
-            if (passets->setNewRestrictedAddressToRemove.count(item)) {
-                passets->setNewRestrictedAddressToRemove.erase(item);
+            if (parent->setNewRestrictedAddressToRemove.count(item)) {
+                parent->setNewRestrictedAddressToRemove.erase(item);
             }
 
-            if (passets->setNewRestrictedAddressToAdd.count(item)) {
-                passets->setNewRestrictedAddressToAdd.erase(item);
+            if (parent->setNewRestrictedAddressToAdd.count(item)) {
+                parent->setNewRestrictedAddressToAdd.erase(item);
             }
 
-            passets->setNewRestrictedAddressToAdd.insert(item);
+            parent->setNewRestrictedAddressToAdd.insert(item);
         }
 
         for(auto &item : setNewRestrictedAddressToRemove) {
-            if (passets->setNewRestrictedAddressToAdd.count(item)) {
-                passets->setNewRestrictedAddressToAdd.erase(item);
+            if (parent->setNewRestrictedAddressToAdd.count(item)) {
+                parent->setNewRestrictedAddressToAdd.erase(item);
             }
 
-            if (passets->setNewRestrictedAddressToRemove.count(item)) {
-                passets->setNewRestrictedAddressToRemove.erase(item);
+            if (parent->setNewRestrictedAddressToRemove.count(item)) {
+                parent->setNewRestrictedAddressToRemove.erase(item);
             }
 
-            passets->setNewRestrictedAddressToRemove.insert(item);
+            parent->setNewRestrictedAddressToRemove.insert(item);
         }
 
         for(auto &item : setNewRestrictedGlobalToAdd) {
-            if (passets->setNewRestrictedGlobalToRemove.count(item)) {
-                passets->setNewRestrictedGlobalToRemove.erase(item);
+            if (parent->setNewRestrictedGlobalToRemove.count(item)) {
+                parent->setNewRestrictedGlobalToRemove.erase(item);
             }
 
-            if (passets->setNewRestrictedGlobalToAdd.count(item)) {
-                passets->setNewRestrictedGlobalToAdd.erase(item);
+            if (parent->setNewRestrictedGlobalToAdd.count(item)) {
+                parent->setNewRestrictedGlobalToAdd.erase(item);
             }
 
-            passets->setNewRestrictedGlobalToAdd.insert(item);
+            parent->setNewRestrictedGlobalToAdd.insert(item);
         }
 
         for(auto &item : setNewRestrictedGlobalToRemove) {
-            if (passets->setNewRestrictedGlobalToAdd.count(item)) {
-                passets->setNewRestrictedGlobalToAdd.erase(item);
+            if (parent->setNewRestrictedGlobalToAdd.count(item)) {
+                parent->setNewRestrictedGlobalToAdd.erase(item);
             }
 
-            if (passets->setNewRestrictedGlobalToRemove.count(item)) {
-                passets->setNewRestrictedGlobalToRemove.erase(item);
+            if (parent->setNewRestrictedGlobalToRemove.count(item)) {
+                parent->setNewRestrictedGlobalToRemove.erase(item);
             }
 
-            passets->setNewRestrictedGlobalToRemove.insert(item);
+            parent->setNewRestrictedGlobalToRemove.insert(item);
         }
 
         for (auto &item : setNewRestrictedVerifierToAdd) {
-            if (passets->setNewRestrictedVerifierToRemove.count(item)) {
-                passets->setNewRestrictedVerifierToRemove.erase(item);
+            if (parent->setNewRestrictedVerifierToRemove.count(item)) {
+                parent->setNewRestrictedVerifierToRemove.erase(item);
             }
 
-            if (passets->setNewRestrictedVerifierToAdd.count(item)) {
-                passets->setNewRestrictedVerifierToAdd.erase(item);
+            if (parent->setNewRestrictedVerifierToAdd.count(item)) {
+                parent->setNewRestrictedVerifierToAdd.erase(item);
             }
 
-            passets->setNewRestrictedVerifierToAdd.insert(item);
+            parent->setNewRestrictedVerifierToAdd.insert(item);
         }
 
         for (auto &item : setNewRestrictedVerifierToRemove) {
-            if (passets->setNewRestrictedVerifierToAdd.count(item)) {
-                passets->setNewRestrictedVerifierToAdd.erase(item);
+            if (parent->setNewRestrictedVerifierToAdd.count(item)) {
+                parent->setNewRestrictedVerifierToAdd.erase(item);
             }
 
-            if (passets->setNewRestrictedVerifierToRemove.count(item)) {
-                passets->setNewRestrictedVerifierToRemove.erase(item);
+            if (parent->setNewRestrictedVerifierToRemove.count(item)) {
+                parent->setNewRestrictedVerifierToRemove.erase(item);
             }
 
-            passets->setNewRestrictedVerifierToRemove.insert(item);
+            parent->setNewRestrictedVerifierToRemove.insert(item);
         }
 
         for (auto &item : mapRootQualifierAddressesAdd) {
             for (auto asset : item.second) {
-                passets->mapRootQualifierAddressesAdd[item.first].insert(asset);
+                parent->mapRootQualifierAddressesAdd[item.first].insert(asset);
             }
         }
 
         for (auto &item : mapRootQualifierAddressesRemove) {
             for (auto asset : item.second) {
-                passets->mapRootQualifierAddressesAdd[item.first].insert(asset);
+                parent->mapRootQualifierAddressesAdd[item.first].insert(asset);
             }
         }
 
@@ -3343,37 +3524,28 @@ bool CAssetsCache::CheckIfAssetExists(const std::string& name, bool fForceDuplic
     asset.strName = name;
     CAssetCacheNewAsset cachedAsset(asset, "", 0, uint256());
 
-    // Check the dirty caches first and see if it was recently added or removed
-    if (setNewAssetsToRemove.count(cachedAsset)) {
-        return false;
-    }
-
-    // Check the dirty caches first and see if it was recently added or removed
-    if (passets->setNewAssetsToRemove.count(cachedAsset)) {
-        return false;
-    }
-
-    if (setNewAssetsToAdd.count(cachedAsset)) {
-        if (fForceDuplicateCheck) {
-            return true;
-        }
-        else {
-            LogPrintf("%s : Found asset %s in setNewAssetsToAdd but force duplicate check wasn't true\n", __func__, name);
+    // Check the dirty caches of this cache and its parents first and see if it was recently added or removed
+    for (const CAssetsCache* cache = this; cache; cache = cache->Parent()) {
+        if (cache->setNewAssetsToRemove.count(cachedAsset)) {
+            return false;
         }
     }
 
-    if (passets->setNewAssetsToAdd.count(cachedAsset)) {
-        if (fForceDuplicateCheck) {
-            return true;
-        }
-        else {
-            LogPrintf("%s : Found asset %s in setNewAssetsToAdd but force duplicate check wasn't true\n", __func__, name);
+    for (const CAssetsCache* cache = this; cache; cache = cache->Parent()) {
+        if (cache->setNewAssetsToAdd.count(cachedAsset)) {
+            if (fForceDuplicateCheck) {
+                return true;
+            }
+            else {
+                LogPrintf("%s : Found asset %s in setNewAssetsToAdd but force duplicate check wasn't true\n", __func__, name);
+            }
         }
     }
 
     // Check the cache, if it doesn't exist in the cache. Try and read it from database
     if (passetsCache) {
-        if (passetsCache->Exists(name)) {
+        CDatabasedAssetData data;
+        if (passetsCache->TryGet(name, data)) {
             if (fForceDuplicateCheck) {
                 return true;
             }
@@ -3409,16 +3581,13 @@ bool CAssetsCache::GetAssetMetaDataIfExists(const std::string &name, CNewAsset &
 
 bool CAssetsCache::GetAssetMetaDataIfExists(const std::string &name, CNewAsset &asset, int& nHeight, uint256& blockHash)
 {
-    // Check the map that contains the reissued asset data. If it is in this map, it hasn't been saved to disk yet
-    if (mapReissuedAssetData.count(name)) {
-        asset = mapReissuedAssetData.at(name);
-        return true;
-    }
-
-    // Check the map that contains the reissued asset data. If it is in this map, it hasn't been saved to disk yet
-    if (passets->mapReissuedAssetData.count(name)) {
-        asset = passets->mapReissuedAssetData.at(name);
-        return true;
+    // Check the maps that contain the reissued asset data. If it is in one of them, it hasn't been saved to disk yet
+    for (const CAssetsCache* cache = this; cache; cache = cache->Parent()) {
+        auto it = cache->mapReissuedAssetData.find(name);
+        if (it != cache->mapReissuedAssetData.end()) {
+            asset = it->second;
+            return true;
+        }
     }
 
     // Create objects that will be used to check the dirty cache
@@ -3427,38 +3596,27 @@ bool CAssetsCache::GetAssetMetaDataIfExists(const std::string &name, CNewAsset &
     CAssetCacheNewAsset cachedAsset(tempAsset, "", 0, uint256());
 
     // Check the dirty caches first and see if it was recently added or removed
-    if (setNewAssetsToRemove.count(cachedAsset)) {
-        LogPrintf("%s : Found in new assets to Remove - Returning False\n", __func__);
-        return false;
-    }
-
-    // Check the dirty caches first and see if it was recently added or removed
-    if (passets->setNewAssetsToRemove.count(cachedAsset)) {
-        LogPrintf("%s : Found in new assets to Remove - Returning False\n", __func__);
-        return false;
-    }
-
-    auto setIterator = setNewAssetsToAdd.find(cachedAsset);
-    if (setIterator != setNewAssetsToAdd.end()) {
-        asset = setIterator->asset;
-        nHeight = setIterator->blockHeight;
-        blockHash = setIterator->blockHash;
-        return true;
+    for (const CAssetsCache* cache = this; cache; cache = cache->Parent()) {
+        if (cache->setNewAssetsToRemove.count(cachedAsset)) {
+            LogPrintf("%s : Found in new assets to Remove - Returning False\n", __func__);
+            return false;
+        }
     }
 
-    setIterator = passets->setNewAssetsToAdd.find(cachedAsset);
-    if (setIterator != passets->setNewAssetsToAdd.end()) {
-        asset = setIterator->asset;
-        nHeight = setIterator->blockHeight;
-        blockHash = setIterator->blockHash;
-        return true;
+    for (const CAssetsCache* cache = this; cache; cache = cache->Parent()) {
+        auto setIterator = cache->setNewAssetsToAdd.find(cachedAsset);
+        if (setIterator != cache->setNewAssetsToAdd.end()) {
+            asset = setIterator->asset;
+            nHeight = setIterator->blockHeight;
+            blockHash = setIterator->blockHash;
+            return true;
+        }
     }
 
     // Check the cache, if it doesn't exist in the cache. Try and read it from database
     if (passetsCache) {
-        if (passetsCache->Exists(name)) {
-            CDatabasedAssetData data;
-            data = passetsCache->Get(name);
+        CDatabasedAssetData data;
+        if (passetsCache->TryGet(name, data)) {
             asset = data.asset;
             nHeight = data.nHeight;
             blockHash = data.blockHash;
@@ -3483,6 +3641,86 @@ bool CAssetsCache::GetAssetMetaDataIfExists(const std::string &name, CNewAsset &
     return false;
 }
 
+static std::shared_ptr<const CAssetMetaDataSnapshot> passetsMetaDataSnapshot;
+
+bool CAssetMetaDataSnapshot::GetAssetMetaData(const std::string& name, CDatabasedAssetData& data) const
+{
+    auto it = mapAssets.find(name);
+    if (it != mapAssets.end()) {
+        data = it->second;
+        return true;
+    }
+
+    if (setRemoved.count(name))
+        return false;
+
+    // Don't Put what is read from the database into passetsCache, a block could be connected in the meantime
+    if (passetsCache && passetsCache->TryGet(name, data))
+        return true;
+
+    if (passetsdb && passetsdb->ReadAssetData(name, data.asset, data.nHeight, data.blockHash))
+        return true;
+
+    return false;
+}
+
+static std::shared_ptr<const CAssetMetaDataSnapshot> BuildAssetMetaDataSnapshot()
+{
+    AssertLockHeld(cs_main);
+    auto snapshot = std::make_shared<CAssetMetaDataSnapshot>();
+
+    std::vector<const CAssetsCache*> vCaches;
+    for (const CAssetsCache* cache = passets; cache; cache = cache->Parent())
+        vCaches.push_back(cache);
+
+    // Apply the oldest changes first. Within a cache, GetAssetMetaDataIfExists prefers reissued data over removed
+    // assets over added ones
+    for (auto itCache = vCaches.rbegin(); itCache != vCaches.rend(); ++itCache) {
+        const CAssetsCache* cache = *itCache;
+        for (const auto& newAsset : cache->setNewAssetsToAdd) {
+            snapshot->mapAssets[newAsset.asset.strName] = CDatabasedAssetData(newAsset.asset, newAsset.blockHeight, newAsset.blockHash);
+            snapshot->setRemoved.erase(newAsset.asset.strName);
+        }
+
+        for (const auto& removedAsset : cache->setNewAssetsToRemove) {
+            snapshot->mapAssets.erase(removedAsset.asset.strName);
+            snapshot->setRemoved.insert(removedAsset.asset.strName);
+        }
+
+        for (const auto& reissued : cache->mapReissuedAssetData) {
+            // Reissues keep the height and block hash of the issuance
+            CDatabasedAssetData data;
+            if (!snapshot->GetAssetMetaData(reissued.first, data))
+                data.SetNull();
+            data.asset = reissued.second;
+            snapshot->mapAssets[reissued.first] = data;
+            snapshot->setRemoved.erase(reissued.first);
+        }
+    }
+
+    return snapshot;
+}
+
+std::shared_ptr<const CAssetMetaDataSnapshot> GetAssetMetaDataSnapshot()
+{
+    std::shared_ptr<const CAssetMetaDataSnapshot> snapshot = std::atomic_load(&passetsMetaDataSnapshot);
+    if (snapshot)
+        return snapshot;
+
+    LOCK(cs_main);
+    snapshot = std::atomic_load(&passetsMetaDataSnapshot);
+    if (!snapshot) {
+        snapshot = BuildAssetMetaDataSnapshot();
+        std::atomic_store(&passetsMetaDataSnapshot, snapshot);
+    }
+    return snapshot;
+}
+
+void InvalidateAssetMetaDataSnapshot()
+{
+    std::atomic_store(&passetsMetaDataSnapshot, std::shared_ptr<const CAssetMetaDataSnapshot>());
+}
+
 bool GetAssetInfoFromScript(const CScript& scriptPubKey, std::string& strName, CAmount& nAmount)
 {
     CAssetOutputEntry data;
@@ -3731,10 +3969,13 @@ bool GetBestAssetAddressAmount(CAssetsCache& cache, const std::string& assetName
         if (cache.mapAssetsAddressAmount.count(pair))
             return true;
 
-        // If the caches map has the pair, return true because the map already contains the best dirty amount
-        if (passets->mapAssetsAddressAmount.count(pair)) {
-            cache.mapAssetsAddressAmount[pair] = passets->mapAssetsAddressAmount.at(pair);
-            return true;
+        // If a parent cache has the pair, copy its amount because it is the best dirty amount
+        for (const CAssetsCache* parent = cache.Parent(); parent; parent = parent->Parent()) {
+            auto it = parent->mapAssetsAddressAmount.find(pair);
+            if (it != parent->mapAssetsAddressAmount.end()) {
+                cache.mapAssetsAddressAmount[pair] = it->second;
+                return true;
+            }
         }
 
         // If the database contains the assets address amount, insert it into the database and return true
@@ -4168,7 +4409,7 @@ bool CreateReissueAssetTransaction(CWallet* pwallet, CCoinControl& coinControl,
                 }
 
                 std::string strError = "";
-                if (!ContextualCheckVerifierString(passets, verifier.verifier_string, address, strError)) {
+                if (!ContextualCheckVerifierString(passets, verifier.verifier_string, address, strError, nullptr, reissueAsset.strName)) {
                     error = std::make_pair(RPC_INVALID_PARAMETER, strError);
                     return false;
                 }
@@ -4282,7 +4523,7 @@ bool CreateTransferAssetTransaction(CWallet* pwallet, const CCoinControl& coinCo
                     return false;
                 }
 
-                if (!ContextualCheckVerifierString(passets, verifier.verifier_string, change_address, strError)) {
+                if (!ContextualCheckVerifierString(passets, verifier.verifier_string, change_address, strError, nullptr, asset_name)) {
                     error = std::make_pair(RPC_DATABASE_ERROR, std::string(_("Change address can not be sent to because it doesn't have the correct qualifier tags ") + strError));
                     return false;
                 }
@@ -4584,44 +4825,30 @@ bool CAssetsCache::GetAssetVerifierStringIfExists(const std::string &name, CNull
     // Create objects that will be used to check the dirty cache
     CAssetCacheRestrictedVerifiers tempCacheVerifier {name, ""};
 
-    auto setIterator = setNewRestrictedVerifierToRemove.find(tempCacheVerifier);
     // Check the dirty caches first and see if it was recently added or removed
-    if (!fSkipTempCache && setIterator != setNewRestrictedVerifierToRemove.end()) {
-        if (setIterator->fUndoingRessiue) {
-            verifierString.verifier_string = setIterator->verifier;
-            return true;
+    for (const CAssetsCache* cache = FirstDirtyCache(fSkipTempCache); cache; cache = cache->Parent()) {
+        auto setIterator = cache->setNewRestrictedVerifierToRemove.find(tempCacheVerifier);
+        if (setIterator != cache->setNewRestrictedVerifierToRemove.end()) {
+            if (setIterator->fUndoingRessiue) {
+                verifierString.verifier_string = setIterator->verifier;
+                return true;
+            }
+            return false;
         }
-        return false;
     }
 
-    setIterator = passets->setNewRestrictedVerifierToRemove.find(tempCacheVerifier);
-    // Check the dirty caches first and see if it was recently added or removed
-    if (setIterator != passets->setNewRestrictedVerifierToRemove.end()) {
-        if (setIterator->fUndoingRessiue) {
+    for (const CAssetsCache* cache = FirstDirtyCache(fSkipTempCache); cache; cache = cache->Parent()) {
+        auto setIterator = cache->setNewRestrictedVerifierToAdd.find(tempCacheVerifier);
+        if (setIterator != cache->setNewRestrictedVerifierToAdd.end()) {
             verifierString.verifier_string = setIterator->verifier;
             return true;
         }
-        return false;
-    }
-
-    setIterator = setNewRestrictedVerifierToAdd.find(tempCacheVerifier);
-    if (!fSkipTempCache && setIterator != setNewRestrictedVerifierToAdd.end()) {
-        verifierString.verifier_string = setIterator->verifier;
-        return true;
-    }
-
-    setIterator = passets->setNewRestrictedVerifierToAdd.find(tempCacheVerifier);
-    if (setIterator != passets->setNewRestrictedVerifierToAdd.end()) {
-        verifierString.verifier_string = setIterator->verifier;
-        return true;
     }
 
     // Check the cache, if it doesn't exist in the cache. Try and read it from database
     if (passetsVerifierCache) {
-        if (passetsVerifierCache->Exists(name)) {
-            verifierString = passetsVerifierCache->Get(name);
+        if (passetsVerifierCache->TryGet(name, verifierString))
             return true;
-        }
     }
 
     if (prestricteddb) {
@@ -4652,65 +4879,49 @@ bool CAssetsCache::CheckForAddressQualifier(const std::string &qualifier_name, c
     CAssetCacheQualifierAddress cachedQualifierAddress(qualifier_name, address, QualifierType::ADD_QUALIFIER);
 
     // Check the dirty caches first and see if it was recently added or removed
-    auto setIterator = setNewQualifierAddressToRemove.find(cachedQualifierAddress);
-    if (!fSkipTempCache &&setIterator != setNewQualifierAddressToRemove.end()) {
-        // Undoing a remove qualifier command, means that we are adding the qualifier to the address
-        return setIterator->type == QualifierType::REMOVE_QUALIFIER;
-    }
-
-
-    setIterator = passets->setNewQualifierAddressToRemove.find(cachedQualifierAddress);
-    if (setIterator != passets->setNewQualifierAddressToRemove.end()) {
-        // Undoing a remove qualifier command, means that we are adding the qualifier to the address
-        return setIterator->type == QualifierType::REMOVE_QUALIFIER;
+    for (const CAssetsCache* cache = FirstDirtyCache(fSkipTempCache); cache; cache = cache->Parent()) {
+        auto setIterator = cache->setNewQualifierAddressToRemove.find(cachedQualifierAddress);
+        if (setIterator != cache->setNewQualifierAddressToRemove.end()) {
+            // Undoing a remove qualifier command, means that we are adding the qualifier to the address
+            return setIterator->type == QualifierType::REMOVE_QUALIFIER;
+        }
     }
 
-    setIterator = setNewQualifierAddressToAdd.find(cachedQualifierAddress);
-    if (!fSkipTempCache && setIterator != setNewQualifierAddressToAdd.end()) {
-        // Return true if we are adding the qualifier, and false if we are removing it
-        return setIterator->type == QualifierType::ADD_QUALIFIER;
-    }
+    auto tempChecker = CAssetCacheRootQualifierChecker(qualifier_name, address);
+    for (const CAssetsCache* cache = FirstDirtyCache(fSkipTempCache); cache; cache = cache->Parent()) {
+        auto setIterator = cache->setNewQualifierAddressToAdd.find(cachedQualifierAddress);
+        if (setIterator != cache->setNewQualifierAddressToAdd.end()) {
+            if (setIterator->type == QualifierType::ADD_QUALIFIER) {
+                return true;
+            }
 
+            // Return false if we are removing it in this cache
+            if (cache == this && !fSkipTempCache) {
+                return false;
+            }
 
-    setIterator = passets->setNewQualifierAddressToAdd.find(cachedQualifierAddress);
-    if (setIterator != passets->setNewQualifierAddressToAdd.end()) {
-        if (setIterator->type == QualifierType::ADD_QUALIFIER) {
-            return true;
-        } else {
             // BUG FIX:
             // This scenario can occur if a tag #TAG is removed from an address in a block, then in a later block
             // #TAG/#SECOND is added to the address.
             // If a database event hasn't occurred yet the in memory caches will find that #TAG should be removed from the
             // address and would normally fail this check. Now we can check for the exact condition where a subqualifier
             // was added later.
-
-            auto tempChecker = CAssetCacheRootQualifierChecker(qualifier_name, address);
-            if (passets->mapRootQualifierAddressesAdd.count(tempChecker)) {
-                if (passets->mapRootQualifierAddressesAdd.at(tempChecker).size()) {
-                    return true;
-                }
-            }
-
-            return false;
+            auto mapIterator = cache->mapRootQualifierAddressesAdd.find(tempChecker);
+            return mapIterator != cache->mapRootQualifierAddressesAdd.end() && mapIterator->second.size();
         }
     }
 
-    auto tempChecker = CAssetCacheRootQualifierChecker(qualifier_name, address);
-    if (!fSkipTempCache && mapRootQualifierAddressesAdd.count(tempChecker)){
-        if (mapRootQualifierAddressesAdd.at(tempChecker).size()) {
-            return true;
-        }
-    }
-
-    if (passets->mapRootQualifierAddressesAdd.count(tempChecker)) {
-        if (passets->mapRootQualifierAddressesAdd.at(tempChecker).size()) {
+    for (const CAssetsCache* cache = FirstDirtyCache(fSkipTempCache); cache; cache = cache->Parent()) {
+        auto mapIterator = cache->mapRootQualifierAddressesAdd.find(tempChecker);
+        if (mapIterator != cache->mapRootQualifierAddressesAdd.end() && mapIterator->second.size()) {
             return true;
         }
     }
 
     // Check the cache, if it doesn't exist in the cache. Try and read it from database
     if (passetsQualifierCache) {
-        if (passetsQualifierCache->Exists(cachedQualifierAddress.GetHash().GetHex())) {
+        int8_t nCached;
+        if (passetsQualifierCache->TryGet(cachedQualifierAddress.GetHash().GetHex(), nCached)) {
             return true;
         }
     }
@@ -4747,33 +4958,26 @@ bool CAssetsCache::CheckForAddressRestriction(const std::string &restricted_name
     CAssetCacheRestrictedAddress cachedRestrictedAddress(restricted_name, address, RestrictedType::FREEZE_ADDRESS);
 
     // Check the dirty caches first and see if it was recently added or removed
-    auto setIterator = setNewRestrictedAddressToRemove.find(cachedRestrictedAddress);
-    if (!fSkipTempCache && setIterator != setNewRestrictedAddressToRemove.end()) {
-        // Undoing a unfreeze, means that we are adding back a freeze
-        return setIterator->type == RestrictedType::UNFREEZE_ADDRESS;
-    }
-
-    setIterator = passets->setNewRestrictedAddressToRemove.find(cachedRestrictedAddress);
-    if (setIterator != passets->setNewRestrictedAddressToRemove.end()) {
-        // Undoing a unfreeze, means that we are adding back a freeze
-        return setIterator->type == RestrictedType::UNFREEZE_ADDRESS;
-    }
-
-    setIterator = setNewRestrictedAddressToAdd.find(cachedRestrictedAddress);
-    if (!fSkipTempCache && setIterator != setNewRestrictedAddressToAdd.end()) {
-        // Return true if we are freezing the address
-        return setIterator->type == RestrictedType::FREEZE_ADDRESS;
+    for (const CAssetsCache* cache = FirstDirtyCache(fSkipTempCache); cache; cache = cache->Parent()) {
+        auto setIterator = cache->setNewRestrictedAddressToRemove.find(cachedRestrictedAddress);
+        if (setIterator != cache->setNewRestrictedAddressToRemove.end()) {
+            // Undoing a unfreeze, means that we are adding back a freeze
+            return setIterator->type == RestrictedType::UNFREEZE_ADDRESS;
+        }
     }
 
-    setIterator = passets->setNewRestrictedAddressToAdd.find(cachedRestrictedAddress);
-    if (setIterator != passets->setNewRestrictedAddressToAdd.end()) {
-        // Return true if we are freezing the address
-        return setIterator->type == RestrictedType::FREEZE_ADDRESS;
+    for (const CAssetsCache* cache = FirstDirtyCache(fSkipTempCache); cache; cache = cache->Parent()) {
+        auto setIterator = cache->setNewRestrictedAddressToAdd.find(cachedRestrictedAddress);
+        if (setIterator != cache->setNewRestrictedAddressToAdd.end()) {
+            // Return true if we are freezing the address
+            return setIterator->type == RestrictedType::FREEZE_ADDRESS;
+        }
     }
 
     // Check the cache, if it doesn't exist in the cache. Try and read it from database
     if (passetsRestrictionCache) {
-        if (passetsRestrictionCache->Exists(cachedRestrictedAddress.GetHash().GetHex())) {
+        int8_t nCached;
+        if (passetsRestrictionCache->TryGet(cachedRestrictedAddress.GetHash().GetHex(), nCached)) {
             return true;
         }
     }
@@ -4806,33 +5010,26 @@ bool CAssetsCache::CheckForGlobalRestriction(const std::string &restricted_name,
     CAssetCacheRestrictedGlobal cachedRestrictedGlobal(restricted_name, RestrictedType::GLOBAL_FREEZE);
 
     // Check the dirty caches first and see if it was recently added or removed
-    auto setIterator = setNewRestrictedGlobalToRemove.find(cachedRestrictedGlobal);
-    if (!fSkipTempCache && setIterator != setNewRestrictedGlobalToRemove.end()) {
-        // Undoing a removal of a global unfreeze, means that is will become frozen
-        return setIterator->type == RestrictedType::GLOBAL_UNFREEZE;
-    }
-
-    setIterator = passets->setNewRestrictedGlobalToRemove.find(cachedRestrictedGlobal);
-    if (setIterator != passets->setNewRestrictedGlobalToRemove.end()) {
-        // Undoing a removal of a global unfreeze, means that is will become frozen
-        return setIterator->type == RestrictedType::GLOBAL_UNFREEZE;
-    }
-
-    setIterator = setNewRestrictedGlobalToAdd.find(cachedRestrictedGlobal);
-    if (!fSkipTempCache && setIterator != setNewRestrictedGlobalToAdd.end()) {
-        // Return true if we are adding a freeze command
-        return setIterator->type == RestrictedType::GLOBAL_FREEZE;
+    for (const CAssetsCache* cache = FirstDirtyCache(fSkipTempCache); cache; cache = cache->Parent()) {
+        auto setIterator = cache->setNewRestrictedGlobalToRemove.find(cachedRestrictedGlobal);
+        if (setIterator != cache->setNewRestrictedGlobalToRemove.end()) {
+            // Undoing a removal of a global unfreeze, means that is will become frozen
+            return setIterator->type == RestrictedType::GLOBAL_UNFREEZE;
+        }
     }
 
-    setIterator = passets->setNewRestrictedGlobalToAdd.find(cachedRestrictedGlobal);
-    if (setIterator != passets->setNewRestrictedGlobalToAdd.end()) {
-        // Return true if we are adding a freeze command
-        return setIterator->type == RestrictedType::GLOBAL_FREEZE;
+    for (const CAssetsCache* cache = FirstDirtyCache(fSkipTempCache); cache; cache = cache->Parent()) {
+        auto setIterator = cache->setNewRestrictedGlobalToAdd.find(cachedRestrictedGlobal);
+        if (setIterator != cache->setNewRestrictedGlobalToAdd.end()) {
+            // Return true if we are adding a freeze command
+            return setIterator->type == RestrictedType::GLOBAL_FREEZE;
+        }
     }
 
     // Check the cache, if it doesn't exist in the cache. Try and read it from database
     if (passetsGlobalRestrictionCache) {
-        if (passetsGlobalRestrictionCache->Exists(cachedRestrictedGlobal.assetName)) {
+        int8_t nCached;
+        if (passetsGlobalRestrictionCache->TryGet(cachedRestrictedGlobal.assetName, nCached)) {
             return true;
         }
     }
@@ -4920,7 +5117,7 @@ bool CheckVerifierString(const std::string& verifier, std::set<std::string>& set
         // Qualifer string was stripped above, so we need to add back the #
         edited_qualifier = QUALIFIER_CHAR + qualifier;
 
-        if (!IsQualifierNameValid(edited_qualifier)) {
+        if (!IsQualifierNameValid(edited_qualifier.data(), edited_qualifier.size())) {
             strError = "bad-txns-null-verifier-invalid-asset-name-" + qualifier;
             if (errorReport) {
                 errorReport->type = ErrorReport::ErrorType::InvalidQualifierName;
@@ -5140,12 +5337,100 @@ bool ContextualCheckVerifierAssetTxOut(const CTxOut& txout, CAssetsCache* assetC
     return true;
 }
 
-bool ContextualCheckVerifierString(CAssetsCache* cache, const std::string& verifier, const std::string& check_address, std::string& strError, ErrorReport* errorReport)
+/** A verifier string that passed CheckVerifierString, compiled so checking an address against it doesn't parse it again */
+struct CCompiledVerifierString
+{
+    std::string strVerifier;                        //! The verifier string it was compiled from
+    std::vector<std::string> vQualifiers;           //! The qualifiers CheckVerifierString found in it, with their #
+    std::vector<std::string> vVariableQualifiers;   //! The qualifier of each variable of the program, with its #
+    LibBoolEE::Program program;
+};
+
+std::shared_ptr<const CCompiledVerifierString> GetCompiledVerifierString(const std::string& strAssetName, const std::string& verifier)
+{
+    std::shared_ptr<const CCompiledVerifierString> compiled;
+    if (passetsCompiledVerifierCache && passetsCompiledVerifierCache->TryGet(strAssetName, compiled) && compiled->strVerifier == verifier)
+        return compiled;
+
+    // Verifiers that don't pass the syntax checks aren't compiled, so they keep failing with the errors of LibBoolEE::resolve
+    std::set<std::string> setFoundQualifiers;
+    std::string strError;
+    if (!CheckVerifierString(verifier, setFoundQualifiers, strError))
+        return nullptr;
+
+    std::shared_ptr<CCompiledVerifierString> newCompiled = std::make_shared<CCompiledVerifierString>();
+    try {
+        newCompiled->program = LibBoolEE::compile(verifier);
+    } catch (const std::runtime_error& run_error) {
+        // Too many qualifiers or too deeply nested, resolve it the slow way
+        return nullptr;
+    }
+
+    newCompiled->strVerifier = verifier;
+    for (const auto& qualifier : setFoundQualifiers)
+        newCompiled->vQualifiers.emplace_back(QUALIFIER_CHAR + qualifier);
+    for (const auto& variable : newCompiled->program.variables())
+        newCompiled->vVariableQualifiers.emplace_back(QUALIFIER_CHAR + variable);
+
+    if (passetsCompiledVerifierCache)
+        passetsCompiledVerifierCache->Put(strAssetName, newCompiled);
+
+    return newCompiled;
+}
+
+static bool ContextualCheckCompiledVerifierString(CAssetsCache* cache, const CCompiledVerifierString& compiled, const std::string& check_address, std::string& strError, ErrorReport* errorReport)
+{
+    // Loop through each qualifier and make sure that the asset exists
+    for (const auto& search : compiled.vQualifiers) {
+        if (!cache->CheckIfAssetExists(search, true)) {
+            if (errorReport) {
+                errorReport->type = ErrorReport::ErrorType::AssetDoesntExist;
+                errorReport->vecUserData.emplace_back(search);
+                errorReport->strDevData = "bad-txns-null-verifier-contains-non-issued-qualifier";
+            }
+            strError = "bad-txns-null-verifier-contains-non-issued-qualifier";
+            return false;
+        }
+    }
+
+    if (check_address.empty())
+        return true;
+
+    // Every variable of a verifier that passed CheckVerifierString is one of its qualifiers, so this can't fail to resolve
+    uint64_t nQualifiers = 0;
+    for (size_t i = 0; i < compiled.vVariableQualifiers.size(); i++) {
+        if (cache->CheckForAddressQualifier(compiled.vVariableQualifiers[i], check_address, true))
+            nQualifiers |= static_cast<uint64_t>(1) << i;
+    }
+
+    bool ret = compiled.program.evaluate(nQualifiers);
+    if (!ret) {
+        if (errorReport) {
+            if (errorReport->type == ErrorReport::ErrorType::NotSetError) {
+                errorReport->type = ErrorReport::ErrorType::FailedToVerifyAgainstAddress;
+                errorReport->vecUserData.emplace_back(check_address);
+                errorReport->strDevData = "bad-txns-null-verifier-address-failed-verification";
+            }
+        }
+
+        error("%s : The address %s failed to verify against: %s. Is null %d", __func__, check_address, compiled.strVerifier, errorReport ? 0 : 1);
+        strError = "bad-txns-null-verifier-address-failed-verification";
+    }
+    return ret;
+}
+
+bool ContextualCheckVerifierString(CAssetsCache* cache, const std::string& verifier, const std::string& check_address, std::string& strError, ErrorReport* errorReport, const std::string& strAssetName)
 {
     // If verifier is set to true, return true
     if (verifier == "true")
         return true;
 
+    if (!strAssetName.empty()) {
+        std::shared_ptr<const CCompiledVerifierString> compiled = GetCompiledVerifierString(strAssetName, verifier);
+        if (compiled)
+            return ContextualCheckCompiledVerifierString(cache, *compiled, check_address, strError, errorReport);
+    }
+
     // Check against the non contextual changes first
     std::set<std::string> setFoundQualifiers;
     if (!CheckVerifierString(verifier, setFoundQualifiers, strError, errorReport))
@@ -5216,7 +5501,7 @@ bool ContextualCheckVerifierString(CAssetsCache* cache, const std::string& verif
     }
 }
 
-bool ContextualCheckTransferAsset(CAssetsCache* assetCache, const CAssetTransfer& transfer, const std::string& address, std::string& strError)
+bool ContextualCheckTransferAsset(CAssetsCache* assetCache, const CAssetTransfer& transfer, const std::string& address, std::string& strError, bool fCheckRestrictions)
 {
     strError = "";
     AssetType assetType;
@@ -5266,19 +5551,8 @@ bool ContextualCheckTransferAsset(CAssetsCache* assetCache, const CAssetTransfer
             return false;
         }
 
-        if (assetCache) {
-            if (assetCache->CheckForGlobalRestriction(transfer.strName, true)) {
-                strError = "bad-txns-transfer-restricted-asset-that-is-globally-restricted";
-                return false;
-            }
-        }
-
-
-        std::string strError = "";
-        if (!transfer.ContextualCheckAgainstVerifyString(assetCache, address, strError)) {
-            error("%s : %s", __func__, strError);
+        if (fCheckRestrictions && !ContextualCheckTransferRestrictions(assetCache, transfer, address, strError))
             return false;
-        }
     }
 
     // If the transfer is a qualifier channel asset.
@@ -5291,6 +5565,24 @@ bool ContextualCheckTransferAsset(CAssetsCache* assetCache, const CAssetTransfer
     return true;
 }
 
+bool ContextualCheckTransferRestrictions(CAssetsCache* assetCache, const CAssetTransfer& transfer, const std::string& address, std::string& strError)
+{
+    if (assetCache) {
+        if (assetCache->CheckForGlobalRestriction(transfer.strName, true)) {
+            strError = "bad-txns-transfer-restricted-asset-that-is-globally-restricted";
+            return false;
+        }
+    }
+
+    std::string strVerifierError = "";
+    if (!transfer.ContextualCheckAgainstVerifyString(assetCache, address, strVerifierError)) {
+        error("%s : %s", __func__, strVerifierError);
+        return false;
+    }
+
+    return true;
+}
+
 bool CheckNewAsset(const CNewAsset& asset, std::string& strError)
 {
     strError = "";
@@ -5526,7 +5818,7 @@ bool ContextualCheckReissueAsset(CAssetsCache* assetCache, const CReissueAsset&
             if (fNotFound) {
                 CNullAssetTxVerifierString current_verifier;
                 if (assetCache->GetAssetVerifierStringIfExists(reissue_asset.strName, current_verifier)) {
-                    if (!ContextualCheckVerifierString(assetCache, current_verifier.verifier_string, strAddress, strError))
+                    if (!ContextualCheckVerifierString(assetCache, current_verifier.verifier_string, strAddress, strError, nullptr, reissue_asset.strName))
                         return false;
                 } else {
                     // This should happen, but if it does. The wallet needs to shutdown,
@@ -16,6 +16,7 @@
 #include <map>
 #include <unordered_map>
 #include <list>
+#include <memory>
 
 #define NRGC_R 114
 #define NRGC_V 118
@@ -62,6 +63,7 @@ class CWalletTx;
 struct CAssetOutputEntry;
 class CCoinControl;
 struct CBlockAssetUndo;
+struct CCompiledVerifierString;
 class COutput;
 
 // 2500 * 82 Bytes == 205 KB (kilobytes) of memory
@@ -79,17 +81,6 @@ public:
     // Dirty, Gets wiped once flushed to database
     std::map<std::string, CNewAsset> mapReissuedAssetData; // Asset Name -> New Asset Data
 
-    CAssets(const CAssets& assets) {
-        this->mapAssetsAddressAmount = assets.mapAssetsAddressAmount;
-        this->mapReissuedAssetData = assets.mapReissuedAssetData;
-    }
-
-    CAssets& operator=(const CAssets& other) {
-        mapAssetsAddressAmount = other.mapAssetsAddressAmount;
-        mapReissuedAssetData = other.mapReissuedAssetData;
-        return *this;
-    }
-
     CAssets() {
         SetNull();
     }
@@ -130,6 +121,11 @@ private:
     bool AddBackSpentAsset(const Coin& coin, const std::string& assetName, const std::string& address, const CAmount& nAmount, const COutPoint& out);
     void AddToAssetBalance(const std::string& strName, const std::string& address, const CAmount& nAmount);
     bool UndoTransfer(const CAssetTransfer& transfer, const std::string& address, const COutPoint& outToRemove);
+
+    CAssetsCache* pparent;
+
+    //! The first cache whose dirty sets a lookup searches before walking up through the parents
+    const CAssetsCache* FirstDirtyCache(bool fSkipTempCache) const;
 public :
     //! These are memory only containers that show dirty entries that will be databased when flushed
     std::vector<CAssetCacheUndoAssetAmount> vUndoAssetAmount;
@@ -171,103 +167,25 @@ public :
     std::map<CAssetCacheRootQualifierChecker, std::set<std::string> > mapRootQualifierAddressesAdd;
     std::map<CAssetCacheRootQualifierChecker, std::set<std::string> > mapRootQualifierAddressesRemove;
 
-    CAssetsCache() : CAssets()
+    CAssetsCache() : CAssets(), pparent(nullptr)
     {
         SetNull();
         ClearDirtyCache();
     }
 
-    CAssetsCache(const CAssetsCache& cache) : CAssets(cache)
-    {
-        //! Copy dirty cache also
-        this->vSpentAssets = cache.vSpentAssets;
-        this->vUndoAssetAmount = cache.vUndoAssetAmount;
-
-        //! Transfer Caches
-        this->setNewTransferAssetsToAdd = cache.setNewTransferAssetsToAdd;
-        this->setNewTransferAssetsToRemove = cache.setNewTransferAssetsToRemove;
-
-        //! Issue Caches
-        this->setNewAssetsToRemove = cache.setNewAssetsToRemove;
-        this->setNewAssetsToAdd = cache.setNewAssetsToAdd;
-
-        //! Reissue Caches
-        this->setNewReissueToRemove = cache.setNewReissueToRemove;
-        this->setNewReissueToAdd = cache.setNewReissueToAdd;
+    CAssetsCache(const CAssetsCache& cache) = delete;
+    CAssetsCache& operator=(const CAssetsCache& cache) = delete;
 
-        //! Owner Caches
-        this->setNewOwnerAssetsToAdd = cache.setNewOwnerAssetsToAdd;
-        this->setNewOwnerAssetsToRemove = cache.setNewOwnerAssetsToRemove;
-
-        //! Qualifier Caches
-        this->setNewQualifierAddressToAdd = cache.setNewQualifierAddressToAdd;
-        this->setNewQualifierAddressToRemove = cache.setNewQualifierAddressToRemove;
-
-        //! Restricted Address Caches
-        this->setNewRestrictedAddressToAdd = cache.setNewRestrictedAddressToAdd;
-        this->setNewRestrictedAddressToRemove = cache.setNewRestrictedAddressToRemove;
-
-        //! Restricted Global Caches
-        this->setNewRestrictedGlobalToAdd = cache.setNewRestrictedGlobalToAdd;
-        this->setNewRestrictedGlobalToRemove = cache.setNewRestrictedGlobalToRemove;
-
-        //! Restricted Verifier Caches
-        this->setNewRestrictedVerifierToAdd = cache.setNewRestrictedVerifierToAdd;
-        this->setNewRestrictedVerifierToRemove = cache.setNewRestrictedVerifierToRemove;
-
-        //! Root Qualifier Address Map
-        this->mapRootQualifierAddressesAdd = cache.mapRootQualifierAddressesAdd;
-        this->mapRootQualifierAddressesRemove = cache.mapRootQualifierAddressesRemove;
-    }
-
-    CAssetsCache& operator=(const CAssetsCache& cache)
+    //! Create an empty view on top of parent, that only holds its own changes until it is flushed into parent
+    explicit CAssetsCache(CAssetsCache* parent) : CAssets(), pparent(parent)
     {
-        this->mapAssetsAddressAmount = cache.mapAssetsAddressAmount;
-        this->mapReissuedAssetData = cache.mapReissuedAssetData;
-
-        //! Copy dirty cache also
-        this->vSpentAssets = cache.vSpentAssets;
-        this->vUndoAssetAmount = cache.vUndoAssetAmount;
-
-        //! Transfer Caches
-        this->setNewTransferAssetsToAdd = cache.setNewTransferAssetsToAdd;
-        this->setNewTransferAssetsToRemove = cache.setNewTransferAssetsToRemove;
-
-        //! Issue Caches
-        this->setNewAssetsToRemove = cache.setNewAssetsToRemove;
-        this->setNewAssetsToAdd = cache.setNewAssetsToAdd;
-
-        //! Reissue Caches
-        this->setNewReissueToRemove = cache.setNewReissueToRemove;
-        this->setNewReissueToAdd = cache.setNewReissueToAdd;
-
-        //! Owner Caches
-        this->setNewOwnerAssetsToAdd = cache.setNewOwnerAssetsToAdd;
-        this->setNewOwnerAssetsToRemove = cache.setNewOwnerAssetsToRemove;
-
-        //! Qualifier Caches
-        this->setNewQualifierAddressToAdd = cache.setNewQualifierAddressToAdd;
-        this->setNewQualifierAddressToRemove = cache.setNewQualifierAddressToRemove;
-
-        //! Restricted Address Caches
-        this->setNewRestrictedAddressToAdd = cache.setNewRestrictedAddressToAdd;
-        this->setNewRestrictedAddressToRemove = cache.setNewRestrictedAddressToRemove;
-
-        //! Restricted Global Caches
-        this->setNewRestrictedGlobalToAdd = cache.setNewRestrictedGlobalToAdd;
-        this->setNewRestrictedGlobalToRemove = cache.setNewRestrictedGlobalToRemove;
-
-        //! Restricted Verifier Caches
-        this->setNewRestrictedVerifierToAdd = cache.setNewRestrictedVerifierToAdd;
-        this->setNewRestrictedVerifierToRemove = cache.setNewRestrictedVerifierToRemove;
-
-        //! Root Qualifier Address Map
-        this->mapRootQualifierAddressesAdd = cache.mapRootQualifierAddressesAdd;
-        this->mapRootQualifierAddressesRemove = cache.mapRootQualifierAddressesRemove;
-
-        return *this;
+        SetNull();
+        ClearDirtyCache();
     }
 
+    //! The cache lookups fall back to and Flush() writes into: the given parent, or passets for the other caches
+    CAssetsCache* Parent() const;
+
     //! Cache only undo functions
     bool RemoveNewAsset(const CNewAsset& asset, const std::string address);
     bool RemoveTransfer(const CAssetTransfer& transfer, const std::string& address, const COutPoint& out);
@@ -322,7 +240,7 @@ public :
     size_t GetCacheSize() const;
     size_t GetCacheSizeV2() const;
 
-    //! Flush all new cache entries into the passets global cache
+    //! Flush all new cache entries into the parent cache
     bool Flush();
 
     //! Write asset cache data to database
@@ -416,6 +334,9 @@ bool IsAssetNameAQualifier(const std::string& name, bool fOnlyQualifiers = false
 //! Check if an asset is a sub qualifier
 bool IsAssetNameASubQualifier(const std::string& name);
 
+//! Check if an asset is a sub asset
+bool IsAssetNameASubasset(const std::string& name);
+
 //! Check if an asset is a message channel
 bool IsAssetNameAnMsgChannel(const std::string& name);
 
@@ -549,6 +470,23 @@ bool SendAssetTransaction(CWallet* pwallet, CWalletTx& transaction, CReserveKey&
 bool VerifyWalletHasAsset(const std::string& asset_name, std::pair<int, std::string>& pairError);
 #endif
 
+/** The asset metadata at the current tip. Lookups don't need cs_main, so peers' asset data requests can be
+ *  answered without holding it. Entries that passets hasn't flushed to the database yet are copied in when the
+ *  snapshot is built, the rest is read from passetsCache and passetsdb */
+class CAssetMetaDataSnapshot
+{
+public:
+    std::map<std::string, CDatabasedAssetData> mapAssets;
+    std::set<std::string> setRemoved;
+
+    bool GetAssetMetaData(const std::string& name, CDatabasedAssetData& data) const;
+};
+
+/** The snapshot of the current tip. Builds it under cs_main if the tip changed since the last one was built */
+std::shared_ptr<const CAssetMetaDataSnapshot> GetAssetMetaDataSnapshot();
+/** Called when the tip changes. Snapshots that are already handed out stay valid */
+void InvalidateAssetMetaDataSnapshot();
+
 /** Helper method for extracting address bytes, asset name and amount from an asset script */
 bool ParseAssetScript(CScript scriptPubKey, uint160 &hashBytes, std::string &assetName, CAmount &assetAmount);
 
@@ -557,6 +495,10 @@ void ExtractVerifierStringQualifiers(const std::string& verifier, std::set<std::
 bool CheckVerifierString(const std::string& verifier, std::set<std::string>& setFoundQualifiers, std::string& strError, ErrorReport* errorReport = nullptr);
 std::string GetStrippedVerifierString(const std::string& verifier);
 
+/** The compiled verifier of strAssetName, from passetsCompiledVerifierCache if it was compiled from the same verifier string.
+ *  Returns nullptr if the verifier doesn't pass CheckVerifierString or can't be compiled */
+std::shared_ptr<const CCompiledVerifierString> GetCompiledVerifierString(const std::string& strAssetName, const std::string& verifier);
+
 /** Helper methods that validate changes to null asset data transaction databases */
 bool VerifyNullAssetDataFlag(const int& flag, std::string& strError);
 bool VerifyQualifierChange(CAssetsCache& cache, const CNullAssetTxData& data, const std::string& address, std::string& strError);
@@ -572,9 +514,12 @@ bool CheckReissueAsset(const CReissueAsset& asset, std::string& strError);
 bool ContextualCheckNullAssetTxOut(const CTxOut& txout, CAssetsCache* assetCache, std::string& strError, std::vector<std::pair<std::string, CNullAssetTxData>>* myNullAssetData = nullptr);
 bool ContextualCheckGlobalAssetTxOut(const CTxOut& txout, CAssetsCache* assetCache, std::string& strError);
 bool ContextualCheckVerifierAssetTxOut(const CTxOut& txout, CAssetsCache* assetCache, std::string& strError);
-bool ContextualCheckVerifierString(CAssetsCache* cache, const std::string& verifier, const std::string& check_address, std::string& strError, ErrorReport* errorReport = nullptr);
+//! strAssetName is the asset the verifier currently belongs to, if any. Its verifier is then compiled once and kept in passetsCompiledVerifierCache
+bool ContextualCheckVerifierString(CAssetsCache* cache, const std::string& verifier, const std::string& check_address, std::string& strError, ErrorReport* errorReport = nullptr, const std::string& strAssetName = "");
 bool ContextualCheckNewAsset(CAssetsCache* assetCache, const CNewAsset& asset, std::string& strError, bool fCheckMempool = false);
-bool ContextualCheckTransferAsset(CAssetsCache* assetCache, const CAssetTransfer& transfer, const std::string& address, std::string& strError);
+bool ContextualCheckTransferAsset(CAssetsCache* assetCache, const CAssetTransfer& transfer, const std::string& address, std::string& strError, bool fCheckRestrictions = true);
+//! The global restriction and verifier string checks of a restricted asset transfer. Only reads the caches below assetCache
+bool ContextualCheckTransferRestrictions(CAssetsCache* assetCache, const CAssetTransfer& transfer, const std::string& address, std::string& strError);
 bool ContextualCheckReissueAsset(CAssetsCache* assetCache, const CReissueAsset& reissue_asset, std::string& strError, const CTransaction& tx);
 bool ContextualCheckReissueAsset(CAssetsCache* assetCache, const CReissueAsset& reissue_asset, std::string& strError);
 bool ContextualCheckUniqueAssetTx(CAssetsCache* assetCache, std::string& strError, const CTransaction& tx);
@@ -4,13 +4,26 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include "assetsnapshotdb.h"
+#include "txdb.h"
 #include "validation.h"
 #include "base58.h"
 
 #include <boost/algorithm/string.hpp>
 #include <boost/thread.hpp>
 
-static const char SNAPSHOTCHECK_FLAG = 'C'; // Snapshot Check
+static const char SNAPSHOTCHECK_FLAG = 'C'; // Snapshot Check, snapshots written as one record
+static const char SNAPSHOTHEADER_FLAG = 'H'; // Snapshot Header
+static const char SNAPSHOTCHUNK_FLAG = 'K'; // Snapshot Chunk
+
+static std::pair<char, std::pair<int, std::string>> SnapshotHeaderKey(const std::string & p_assetName, int p_height)
+{
+    return std::make_pair(SNAPSHOTHEADER_FLAG, std::make_pair(p_height, p_assetName));
+}
+
+static std::pair<char, std::pair<std::pair<int, std::string>, uint32_t>> SnapshotChunkKey(const std::string & p_assetName, int p_height, uint32_t p_chunk)
+{
+    return std::make_pair(SNAPSHOTCHUNK_FLAG, std::make_pair(std::make_pair(p_height, p_assetName), p_chunk));
+}
 
 CAssetSnapshotDBEntry::CAssetSnapshotDBEntry()
 {
@@ -33,9 +46,69 @@ CAssetSnapshotDBEntry::CAssetSnapshotDBEntry(
     heightAndName = std::to_string(height) + assetName;
 }
 
+CAssetSnapshotWriter::CAssetSnapshotWriter(CAssetSnapshotDB & p_db, const std::string & p_assetName, int p_height)
+    : db(p_db), batch(p_db), nPreviousChunks(0)
+{
+    header.height = p_height;
+    header.assetName = p_assetName;
+    chunk.reserve(SNAPSHOT_CHUNK_SIZE);
+
+    //  A snapshot being rewritten stops being readable as soon as its first new chunk is written
+    CAssetSnapshotHeader previous;
+    if (db.ReadSnapshotHeader(p_assetName, p_height, previous)) {
+        nPreviousChunks = previous.nChunks;
+        batch.Erase(SnapshotHeaderKey(p_assetName, p_height));
+    }
+}
+
+bool CAssetSnapshotWriter::Add(const std::string & p_address, CAmount p_amount)
+{
+    chunk.emplace_back(p_address, p_amount);
+    header.nOwners++;
+    header.nTotalAmount += p_amount;
+
+    if (chunk.size() < SNAPSHOT_CHUNK_SIZE)
+        return true;
+    return WriteChunk();
+}
+
+bool CAssetSnapshotWriter::WriteChunk()
+{
+    batch.Write(SnapshotChunkKey(header.assetName, header.height, header.nChunks), chunk);
+    header.nChunks++;
+    chunk.clear();
+
+    if (batch.SizeEstimate() > (size_t)nDefaultDbBatchSize) {
+        if (!db.WriteBatch(batch))
+            return false;
+        batch.Clear();
+    }
+    return true;
+}
+
+bool CAssetSnapshotWriter::Finish()
+{
+    if (header.nOwners == 0)
+        return false;
+
+    if (!chunk.empty() && !WriteChunk())
+        return false;
+
+    //  Drop what is left of an older version of the snapshot
+    for (uint32_t i = header.nChunks; i < nPreviousChunks; i++)
+        batch.Erase(SnapshotChunkKey(header.assetName, header.height, i));
+    batch.Erase(std::make_pair(SNAPSHOTCHECK_FLAG, std::to_string(header.height) + header.assetName));
+
+    batch.Write(SnapshotHeaderKey(header.assetName, header.height), header);
+    return db.WriteBatch(batch);
+}
+
 CAssetSnapshotDB::CAssetSnapshotDB(size_t nCacheSize, bool fMemory, bool fWipe) : CDBWrapper(GetDataDir() / "rewards" / "assetsnapshot", nCacheSize, fMemory, fWipe) {
 }
 
+CAssetSnapshotDB::CAssetSnapshotDB(const fs::path& path, size_t nCacheSize, bool fMemory, bool fWipe) : CDBWrapper(path, nCacheSize, fMemory, fWipe) {
+}
+
 bool CAssetSnapshotDB::AddAssetOwnershipSnapshot(
     const std::string & p_assetName, int p_height)
 {
@@ -48,68 +121,96 @@ bool CAssetSnapshotDB::AddAssetOwnershipSnapshot(
         return false;
     }
 
-    std::set<std::pair<std::string, CAmount>> ownersAndAmounts;
+    CAssetSnapshotWriter writer(*this, p_assetName, p_height);
     std::vector<std::pair<std::string, CAmount>> tempOwnersAndAmounts;
-    int totalEntryCount;
 
-    if (!passetsdb->AssetAddressDir(tempOwnersAndAmounts, totalEntryCount, true, p_assetName, INT_MAX, 0)) {
-        LogPrint(BCLog::REWARDS, "AddAssetOwnershipSnapshot: Failed to retrieve assets directory for '%s'\n", p_assetName.c_str());
-        return false;
-    }
+    //  Stream the addresses/amounts into the snapshot in batches, each one resuming after the last address of the previous
+    std::string lastAddress;
 
-    //  Retrieve all of the addresses/amounts in batches
-    const int MAX_RETRIEVAL_COUNT = 100;
-    bool errorsOccurred = false;
+    do {
+        tempOwnersAndAmounts.clear();
 
-    for (int retrievalOffset = 0; retrievalOffset < totalEntryCount; retrievalOffset += MAX_RETRIEVAL_COUNT) {
-        //  Retrieve the specified segment of addresses
-        if (!passetsdb->AssetAddressDir(tempOwnersAndAmounts, totalEntryCount, false, p_assetName, MAX_RETRIEVAL_COUNT, retrievalOffset)) {
+        //  Retrieve the next segment of addresses
+        if (!passetsdb->AssetAddressDir(tempOwnersAndAmounts, p_assetName, lastAddress, SNAPSHOT_CHUNK_SIZE)) {
             LogPrint(BCLog::REWARDS, "AddAssetOwnershipSnapshot: Failed to retrieve assets directory for '%s'\n", p_assetName.c_str());
-            errorsOccurred = true;
-            break;
-        }
-
-        //  Verify that some addresses were returned
-        if (tempOwnersAndAmounts.size() == 0) {
-            LogPrint(BCLog::REWARDS, "AddAssetOwnershipSnapshot: No addresses were retrieved.\n");
-            continue;
+            LogPrint(BCLog::REWARDS, "AddAssetOwnershipSnapshot: Errors occurred while acquiring ownership info for asset '%s'.\n", p_assetName.c_str());
+            return false;
         }
 
-        //  Move these into the main set
         for (auto const & currPair : tempOwnersAndAmounts) {
             //  Verify that the address is valid
             CTxDestination dest = DecodeDestination(currPair.first);
-            if (IsValidDestination(dest)) {
-                ownersAndAmounts.insert(currPair);
-            }
-            else {
+            if (!IsValidDestination(dest)) {
                 LogPrint(BCLog::REWARDS, "AddAssetOwnershipSnapshot: Address '%s' is invalid.\n", currPair.first.c_str());
+                continue;
+            }
+
+            if (!writer.Add(currPair.first, currPair.second)) {
+                LogPrint(BCLog::REWARDS, "AddAssetOwnershipSnapshot: Failed to write snapshot for '%s'\n", p_assetName.c_str());
+                return false;
             }
         }
 
-        tempOwnersAndAmounts.clear();
-    }
+        if (!tempOwnersAndAmounts.empty())
+            lastAddress = tempOwnersAndAmounts.back().first;
+    } while (tempOwnersAndAmounts.size() == SNAPSHOT_CHUNK_SIZE);
 
-    if (errorsOccurred) {
-        LogPrint(BCLog::REWARDS, "AddAssetOwnershipSnapshot: Errors occurred while acquiring ownership info for asset '%s'.\n", p_assetName.c_str());
-        return false;
-    }
-    if (ownersAndAmounts.size() == 0) {
+    if (writer.GetHeader().nOwners == 0) {
         LogPrint(BCLog::REWARDS, "AddAssetOwnershipSnapshot: No owners exist for asset '%s'.\n", p_assetName.c_str());
         return false;
     }
 
-    //  Write the snapshot to the database. We don't care if we overwrite, because it should be identical.
-    CAssetSnapshotDBEntry snapshotEntry(p_assetName, p_height, ownersAndAmounts);
-
-    if (Write(std::make_pair(SNAPSHOTCHECK_FLAG, snapshotEntry.heightAndName), snapshotEntry)) {
-        LogPrint(BCLog::REWARDS, "AddAssetOwnershipSnapshot: Successfully added snapshot for '%s' at height %d (ownerCount = %d).\n",
-            p_assetName.c_str(), p_height, ownersAndAmounts.size());
+    //  Write the rest of the snapshot. We don't care if we overwrite, because it should be identical.
+    if (writer.Finish()) {
+        LogPrint(BCLog::REWARDS, "AddAssetOwnershipSnapshot: Successfully added snapshot for '%s' at height %d (ownerCount = %d, chunks = %d).\n",
+            p_assetName.c_str(), p_height, writer.GetHeader().nOwners, writer.GetHeader().nChunks);
         return true;
     }
     return false;
 }
 
+bool CAssetSnapshotDB::ReadSnapshotHeader(const std::string & p_assetName, int p_height, CAssetSnapshotHeader & p_header)
+{
+    auto key = SnapshotHeaderKey(p_assetName, p_height);
+    return Exists(key) && Read(key, p_header);
+}
+
+bool CAssetSnapshotDB::ForEachOwnershipSnapshotChunk(
+    const std::string & p_assetName, int p_height,
+    const std::function<bool(const SnapshotChunk &)> & p_func)
+{
+    CAssetSnapshotHeader header;
+    if (!ReadSnapshotHeader(p_assetName, p_height, header)) {
+        //  Fall back to a snapshot stored as one record
+        CAssetSnapshotDBEntry snapshotEntry;
+        if (!Read(std::make_pair(SNAPSHOTCHECK_FLAG, std::to_string(p_height) + p_assetName), snapshotEntry))
+            return false;
+        return p_func(SnapshotChunk(snapshotEntry.ownersAndAmounts.begin(), snapshotEntry.ownersAndAmounts.end()));
+    }
+
+    SnapshotChunk chunk;
+    for (uint32_t i = 0; i < header.nChunks; i++) {
+        boost::this_thread::interruption_point();
+
+        chunk.clear();
+        if (!Read(SnapshotChunkKey(p_assetName, p_height, i), chunk)) {
+            LogPrint(BCLog::REWARDS, "%s : Chunk %d of snapshot '%s' at height %d is missing!\n",
+                __func__, i, p_assetName.c_str(), p_height);
+            return false;
+        }
+        if (!p_func(chunk))
+            return false;
+    }
+    return true;
+}
+
+bool CAssetSnapshotDB::HasOwnershipSnapshot(
+    const std::string & p_assetName, int p_height)
+{
+    return Exists(SnapshotHeaderKey(p_assetName, p_height)) ||
+           Exists(std::make_pair(SNAPSHOTCHECK_FLAG, std::to_string(p_height) + p_assetName));
+}
+
 bool CAssetSnapshotDB::RetrieveOwnershipSnapshot(
     const std::string & p_assetName, int p_height,
     CAssetSnapshotDBEntry & p_snapshotEntry)
@@ -121,7 +222,15 @@ bool CAssetSnapshotDB::RetrieveOwnershipSnapshot(
         __func__,
         heightAndName.c_str());
 
-    bool succeeded = Read(std::make_pair(SNAPSHOTCHECK_FLAG, heightAndName), p_snapshotEntry);
+    p_snapshotEntry.SetNull();
+    p_snapshotEntry.height = p_height;
+    p_snapshotEntry.assetName = p_assetName;
+    p_snapshotEntry.heightAndName = heightAndName;
+
+    bool succeeded = ForEachOwnershipSnapshotChunk(p_assetName, p_height, [&p_snapshotEntry](const SnapshotChunk & chunk) {
+        p_snapshotEntry.ownersAndAmounts.insert(chunk.begin(), chunk.end());
+        return true;
+    });
 
     LogPrint(BCLog::REWARDS, "%s : Retrieval of snapshot for '%s' %s!\n",
         __func__,
@@ -141,7 +250,16 @@ bool CAssetSnapshotDB::RemoveOwnershipSnapshot(
         __func__,
         heightAndName.c_str());
 
-    bool succeeded = Erase(std::make_pair(SNAPSHOTCHECK_FLAG, heightAndName), true);
+    CDBBatch batch(*this);
+    CAssetSnapshotHeader header;
+    if (ReadSnapshotHeader(p_assetName, p_height, header)) {
+        for (uint32_t i = 0; i < header.nChunks; i++)
+            batch.Erase(SnapshotChunkKey(p_assetName, p_height, i));
+        batch.Erase(SnapshotHeaderKey(p_assetName, p_height));
+    }
+    batch.Erase(std::make_pair(SNAPSHOTCHECK_FLAG, heightAndName));
+
+    bool succeeded = WriteBatch(batch, true);
 
     LogPrint(BCLog::REWARDS, "%s : Removal of snapshot for '%s' %s!\n",
         __func__,
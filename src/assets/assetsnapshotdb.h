@@ -6,11 +6,16 @@
 #ifndef ASSETSNAPSHOTDB_H
 #define ASSETSNAPSHOTDB_H
 
+#include <functional>
 #include <set>
+#include <vector>
 
 #include <dbwrapper.h>
 #include "amount.h"
 
+//  Maximum number of owners stored in one chunk record of a snapshot
+static const size_t SNAPSHOT_CHUNK_SIZE = 1000;
+
 class CAssetSnapshotDBEntry
 {
 public:
@@ -54,9 +59,50 @@ public:
     }
 };
 
+//  Summary of a chunked snapshot. It is written after all of the chunks, so a snapshot without it is ignored.
+class CAssetSnapshotHeader
+{
+public:
+    int height;
+    std::string assetName;
+    uint32_t nChunks;
+    uint64_t nOwners;
+    CAmount nTotalAmount;
+
+    CAssetSnapshotHeader()
+    {
+        SetNull();
+    }
+
+    void SetNull()
+    {
+        height = 0;
+        assetName = "";
+        nChunks = 0;
+        nOwners = 0;
+        nTotalAmount = 0;
+    }
+
+    // Serialization methods
+    ADD_SERIALIZE_METHODS;
+
+    template<typename Stream, typename Operation>
+    inline void SerializationOp(Stream &s, Operation ser_action)
+    {
+        READWRITE(height);
+        READWRITE(assetName);
+        READWRITE(nChunks);
+        READWRITE(nOwners);
+        READWRITE(nTotalAmount);
+    }
+};
+
+typedef std::vector<std::pair<std::string, CAmount>> SnapshotChunk;
+
 class CAssetSnapshotDB  : public CDBWrapper {
 public:
     explicit CAssetSnapshotDB(size_t nCacheSize, bool fMemory = false, bool fWipe = false);
+    CAssetSnapshotDB(const fs::path& path, size_t nCacheSize, bool fMemory, bool fWipe);
 
     CAssetSnapshotDB(const CAssetSnapshotDB&) = delete;
     CAssetSnapshotDB& operator=(const CAssetSnapshotDB&) = delete;
@@ -65,6 +111,16 @@ public:
     bool AddAssetOwnershipSnapshot(
         const std::string & p_assetName, int p_height);
 
+    //  Call p_func on each chunk of owners of the snapshot at the specified height, in address order.
+    //      Stops and returns false if p_func does. Snapshots from before chunking are passed as one chunk.
+    bool ForEachOwnershipSnapshotChunk(
+        const std::string & p_assetName, int p_height,
+        const std::function<bool(const SnapshotChunk &)> & p_func);
+
+    //  Return true if a snapshot exists at the specified height
+    bool HasOwnershipSnapshot(
+        const std::string & p_assetName, int p_height);
+
     //  Read all of the entries at a specified height
     bool RetrieveOwnershipSnapshot(
         const std::string & p_assetName, int p_height,
@@ -73,7 +129,35 @@ public:
     //  Remove the asset snapshot at the specified height
     bool RemoveOwnershipSnapshot(
         const std::string & p_assetName, int p_height);
+
+private:
+    friend class CAssetSnapshotWriter;
+
+    bool ReadSnapshotHeader(const std::string & p_assetName, int p_height, CAssetSnapshotHeader & p_header);
 };
 
+//  Writes a snapshot one chunk at a time, so only a chunk and the pending database batch are held in memory
+class CAssetSnapshotWriter
+{
+public:
+    CAssetSnapshotWriter(CAssetSnapshotDB & p_db, const std::string & p_assetName, int p_height);
+
+    //  Owners have to be added in address order, each one once
+    bool Add(const std::string & p_address, CAmount p_amount);
+
+    //  Write the last chunk and the header. Returns false without writing anything if no owner was added.
+    bool Finish();
+
+    const CAssetSnapshotHeader & GetHeader() const { return header; }
+
+private:
+    CAssetSnapshotDB & db;
+    CDBBatch batch;
+    CAssetSnapshotHeader header;
+    uint32_t nPreviousChunks;
+    SnapshotChunk chunk;
+
+    bool WriteChunk();
+};
 
 #endif //ASSETSNAPSHOTDB_H
@@ -6,13 +6,18 @@
 #ifndef ENERGYCOIN_NEWASSET_H
 #define ENERGYCOIN_NEWASSET_H
 
+#include <array>
+#include <limits>
 #include <string>
 #include <sstream>
 #include <list>
 #include <unordered_map>
+#include <vector>
 #include "amount.h"
 #include "script/standard.h"
 #include "primitives/transaction.h"
+#include "memusage.h"
+#include "sync.h"
 
 #define MAX_UNIT 8
 #define MIN_UNIT 0
@@ -536,15 +541,30 @@ struct CAssetCacheRestrictedVerifiers
 };
 
 // Least Recently Used Cache
+//
+// The entries live in a pool of nodes linked into an intrusive doubly linked
+// list by index, most recently used first. Erased and evicted nodes are kept on
+// a free list and reused, so once the cache is warm Put and Get don't allocate
+// beyond what the key and value themselves need. Not thread safe, see
+// CShardedLRUCache for a version that can be shared between threads.
 template<typename cache_key_t, typename cache_value_t>
 class CLRUCache
 {
-public:
-    typedef typename std::pair<cache_key_t, cache_value_t> key_value_pair_t;
-    typedef typename std::list<key_value_pair_t>::iterator list_iterator_t;
+private:
+    static constexpr uint32_t NULL_NODE = std::numeric_limits<uint32_t>::max();
+
+    struct Node
+    {
+        cache_key_t key;
+        cache_value_t value;
+        uint32_t prev;
+        uint32_t next;
+    };
 
+public:
     CLRUCache(size_t max_size) : maxSize(max_size)
     {
+        Clear();
     }
     CLRUCache()
     {
@@ -554,45 +574,74 @@ public:
     void Put(const cache_key_t& key, const cache_value_t& value)
     {
         auto it = cacheItemsMap.find(key);
-        cacheItemsList.push_front(key_value_pair_t(key, value));
-        if (it != cacheItemsMap.end())
-        {
-            cacheItemsList.erase(it->second);
-            cacheItemsMap.erase(it);
+        if (it != cacheItemsMap.end()) {
+            vNodes[it->second].value = value;
+            MoveToFront(it->second);
+            return;
         }
-        cacheItemsMap[key] = cacheItemsList.begin();
-
-        if (cacheItemsMap.size() > maxSize)
-        {
-            auto last = cacheItemsList.end();
-            last--;
-            cacheItemsMap.erase(last->first);
-            cacheItemsList.pop_back();
+
+        if (maxSize == 0)
+            return;
+
+        uint32_t node;
+        if (cacheItemsMap.size() >= maxSize) {
+            // Reuse the least recently used node
+            node = nTail;
+            cacheItemsMap.erase(vNodes[node].key);
+            Unlink(node);
+            nEvictions++;
+        } else if (nFree != NULL_NODE) {
+            node = nFree;
+            nFree = vNodes[node].next;
+        } else {
+            node = vNodes.size();
+            vNodes.emplace_back();
         }
+
+        vNodes[node].key = key;
+        vNodes[node].value = value;
+        LinkFront(node);
+        cacheItemsMap.emplace(key, node);
     }
 
     void Erase(const cache_key_t& key)
     {
         auto it = cacheItemsMap.find(key);
-        if (it != cacheItemsMap.end())
-        {
-            cacheItemsList.erase(it->second);
+        if (it != cacheItemsMap.end()) {
+            uint32_t node = it->second;
             cacheItemsMap.erase(it);
+            Unlink(node);
+            vNodes[node].key = cache_key_t();
+            vNodes[node].value = cache_value_t();
+            vNodes[node].next = nFree;
+            nFree = node;
         }
     }
 
     const cache_value_t& Get(const cache_key_t& key)
     {
         auto it = cacheItemsMap.find(key);
-        if (it == cacheItemsMap.end())
-        {
+        if (it == cacheItemsMap.end()) {
+            nMisses++;
             throw std::range_error("There is no such key in cache");
         }
-        else
-        {
-            cacheItemsList.splice(cacheItemsList.begin(), cacheItemsList, it->second);
-            return it->second->second;
+        nHits++;
+        MoveToFront(it->second);
+        return vNodes[it->second].value;
+    }
+
+    /** Copy the value of key into value and mark it as recently used. Returns false if key isn't cached. */
+    bool TryGet(const cache_key_t& key, cache_value_t& value)
+    {
+        auto it = cacheItemsMap.find(key);
+        if (it == cacheItemsMap.end()) {
+            nMisses++;
+            return false;
         }
+        nHits++;
+        MoveToFront(it->second);
+        value = vNodes[it->second].value;
+        return true;
     }
 
     bool Exists(const cache_key_t& key) const
@@ -609,7 +658,9 @@ public:
     void Clear()
     {
         cacheItemsMap.clear();
-        cacheItemsList.clear();
+        vNodes.clear();
+        nHead = nTail = nFree = NULL_NODE;
+        nHits = nMisses = nEvictions = 0;
     }
 
     void SetNull()
@@ -627,29 +678,197 @@ public:
     void SetSize(const size_t size)
     {
         maxSize = size;
+        while (cacheItemsMap.size() > maxSize)
+            Erase(vNodes[nTail].key);
     }
 
-   const std::unordered_map<cache_key_t, list_iterator_t>& GetItemsMap()
+    uint64_t Hits() const { return nHits; }
+    uint64_t Misses() const { return nMisses; }
+    uint64_t Evictions() const { return nEvictions; }
+
+    /** Memory used by the node pool and the index, not counting memory owned by the keys and values */
+    size_t DynamicMemoryUsage() const
     {
-        return cacheItemsMap;
-    };
+        return memusage::DynamicUsage(vNodes) + memusage::DynamicUsage(cacheItemsMap);
+    }
 
-    const std::list<key_value_pair_t>& GetItemsList()
+    /** Call fn(key, value) for every entry, most recently used first */
+    template<typename Callable>
+    void ForEach(Callable fn) const
     {
-        return cacheItemsList;
-    };
+        for (uint32_t node = nHead; node != NULL_NODE; node = vNodes[node].next)
+            fn(vNodes[node].key, vNodes[node].value);
+    }
+
+private:
+    void Unlink(uint32_t node)
+    {
+        Node& n = vNodes[node];
+        if (n.prev != NULL_NODE)
+            vNodes[n.prev].next = n.next;
+        else
+            nHead = n.next;
+        if (n.next != NULL_NODE)
+            vNodes[n.next].prev = n.prev;
+        else
+            nTail = n.prev;
+    }
+
+    void LinkFront(uint32_t node)
+    {
+        vNodes[node].prev = NULL_NODE;
+        vNodes[node].next = nHead;
+        if (nHead != NULL_NODE)
+            vNodes[nHead].prev = node;
+        nHead = node;
+        if (nTail == NULL_NODE)
+            nTail = node;
+    }
+
+    void MoveToFront(uint32_t node)
+    {
+        if (node == nHead)
+            return;
+        Unlink(node);
+        LinkFront(node);
+    }
+
+    std::vector<Node> vNodes;
+    std::unordered_map<cache_key_t, uint32_t> cacheItemsMap;
+    uint32_t nHead;
+    uint32_t nTail;
+    uint32_t nFree;
+    size_t maxSize;
+    uint64_t nHits;
+    uint64_t nMisses;
+    uint64_t nEvictions;
+};
+
+/**
+ * Lock striped CLRUCache. Keys are spread over nShards independent caches by
+ * hash, each behind its own lock, so lookups from different threads rarely
+ * contend and none of them needs cs_main. Recency and eviction are tracked
+ * per shard, and each shard holds up to MaxSize() / nShards entries (rounded up).
+ */
+template<typename cache_key_t, typename cache_value_t, size_t nShards = 16>
+class CShardedLRUCache
+{
+public:
+    CShardedLRUCache(size_t max_size)
+    {
+        SetSize(max_size);
+    }
+    CShardedLRUCache()
+    {
+        SetNull();
+    }
+
+    void Put(const cache_key_t& key, const cache_value_t& value)
+    {
+        Shard& shard = GetShard(key);
+        LOCK(shard.cs);
+        shard.cache.Put(key, value);
+    }
+
+    void Erase(const cache_key_t& key)
+    {
+        Shard& shard = GetShard(key);
+        LOCK(shard.cs);
+        shard.cache.Erase(key);
+    }
+
+    /** Returns a copy of the value, as another thread may evict the entry as soon as the shard lock is released */
+    cache_value_t Get(const cache_key_t& key)
+    {
+        Shard& shard = GetShard(key);
+        LOCK(shard.cs);
+        return shard.cache.Get(key);
+    }
+
+    bool TryGet(const cache_key_t& key, cache_value_t& value)
+    {
+        Shard& shard = GetShard(key);
+        LOCK(shard.cs);
+        return shard.cache.TryGet(key, value);
+    }
+
+    bool Exists(const cache_key_t& key)
+    {
+        Shard& shard = GetShard(key);
+        LOCK(shard.cs);
+        return shard.cache.Exists(key);
+    }
+
+    size_t Size()
+    {
+        size_t nSize = 0;
+        for (Shard& shard : shards) {
+            LOCK(shard.cs);
+            nSize += shard.cache.Size();
+        }
+        return nSize;
+    }
+
+    void Clear()
+    {
+        for (Shard& shard : shards) {
+            LOCK(shard.cs);
+            shard.cache.Clear();
+        }
+    }
 
+    void SetNull()
+    {
+        SetSize(0);
+        Clear();
+    }
+
+    size_t MaxSize() const
+    {
+        return maxSize;
+    }
 
-    CLRUCache(const CLRUCache& cache)
+    void SetSize(const size_t size)
     {
-        this->cacheItemsList = cache.cacheItemsList;
-        this->cacheItemsMap = cache.cacheItemsMap;
-        this->maxSize = cache.maxSize;
+        maxSize = size;
+        for (Shard& shard : shards) {
+            LOCK(shard.cs);
+            shard.cache.SetSize((size + nShards - 1) / nShards);
+        }
     }
 
+    uint64_t Hits() { return Sum(&CLRUCache<cache_key_t, cache_value_t>::Hits); }
+    uint64_t Misses() { return Sum(&CLRUCache<cache_key_t, cache_value_t>::Misses); }
+    uint64_t Evictions() { return Sum(&CLRUCache<cache_key_t, cache_value_t>::Evictions); }
+    size_t DynamicMemoryUsage() { return Sum(&CLRUCache<cache_key_t, cache_value_t>::DynamicMemoryUsage); }
+
 private:
-    std::list<key_value_pair_t> cacheItemsList;
-    std::unordered_map<cache_key_t, list_iterator_t> cacheItemsMap;
+    struct Shard
+    {
+        CCriticalSection cs;
+        CLRUCache<cache_key_t, cache_value_t> cache;
+    };
+
+    Shard& GetShard(const cache_key_t& key)
+    {
+        // The shard caches index their entries with the same hash, so take the
+        // shard from the high bits to keep their bucket distribution intact
+        uint64_t nHash = std::hash<cache_key_t>()(key);
+        return shards[((nHash * 0x9E3779B97F4A7C15ULL) >> 32) % nShards];
+    }
+
+    template<typename R>
+    R Sum(R (CLRUCache<cache_key_t, cache_value_t>::*stat)() const)
+    {
+        R nTotal = 0;
+        for (Shard& shard : shards) {
+            LOCK(shard.cs);
+            nTotal += (shard.cache.*stat)();
+        }
+        return nTotal;
+    }
+
+    std::array<Shard, nShards> shards;
     size_t maxSize;
 };
 
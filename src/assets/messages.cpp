@@ -79,7 +79,8 @@ bool IsChannelSubscribed(const std::string &name)
         return false;
 
     // Check the Channel Cache and see if it is in the Cache
-    if (pMessageSubscribedChannelsCache->Exists(name))
+    int nCached;
+    if (pMessageSubscribedChannelsCache->TryGet(name, nCached))
         return true;
 
     // Check if we have already searched for this before
@@ -114,10 +115,8 @@ bool GetMessage(const COutPoint& out, CMessage& message)
         return false;
 
     // Check database cache
-    if (pMessagesCache->Exists(out.ToSerializedString())) {
-        message = pMessagesCache->Get(out.ToSerializedString());
+    if (pMessagesCache->TryGet(out.ToSerializedString(), message))
         return true;
-    }
 
     // Check the database
     if (pmessagedb->ReadMessage(out, message)) {
@@ -275,7 +274,8 @@ bool IsAddressSeen(const std::string &address)
     if (setDirtySeenAddressAdd.count(address)) // Check dirty set
         return true;
 
-    if (pMessagesSeenAddressCache->Exists(address)) {
+    int nCached;
+    if (pMessagesSeenAddressCache->TryGet(address, nCached)) {
         return true;
     }
 
@@ -18,6 +18,7 @@
 #include <utilmoneystr.h>
 #include "assets/rewards.h"
 #include "assetsnapshotdb.h"
+#include "arith_uint256.h"
 #include "wallet/wallet.h"
 
 std::map<uint256, CRewardSnapshot> mapRewardSnapshots;
@@ -42,6 +43,91 @@ bool AddDistributeRewardSnapshot(CRewardSnapshot& p_rewardSnapshot)
     return true;
 }
 
+//  10^n for the unit exponents an asset can have
+static const CAmount UNIT_DIVISORS[MAX_UNIT + 1] = {1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000};
+
+//  floor(a * b / c) without overflowing the intermediate product
+static CAmount MulDiv(CAmount a, CAmount b, CAmount c)
+{
+#ifdef __SIZEOF_INT128__
+    return static_cast<CAmount>(static_cast<unsigned __int128>(a) * static_cast<unsigned __int128>(b) / static_cast<unsigned __int128>(c));
+#else
+    arith_uint256 product = arith_uint256(a) * arith_uint256(b);
+    product /= arith_uint256(c);
+    return static_cast<CAmount>(product.GetLow64());
+#endif
+}
+
+bool CalculateDistribution(CAssetSnapshotDB& snapshotDb, const std::string& strOwnershipAsset, int nHeight,
+                           const std::set<std::string>& setExceptionAddresses, CAmount nPaymentUnits, CAmount nUnitDivisor,
+                           std::vector<OwnerAndAmount>& vecDistributionList)
+{
+    vecDistributionList.clear();
+
+    auto isPayable = [&setExceptionAddresses](const std::string& address) {
+        return !setExceptionAddresses.count(address) && !GetParams().IsBurnAddress(address);
+    };
+
+    //  First pass: the total amount held by the payable owners
+    CAmount totalAmtOwned = 0;
+    size_t nPayableOwners = 0;
+    bool fRead = snapshotDb.ForEachOwnershipSnapshotChunk(strOwnershipAsset, nHeight, [&](const SnapshotChunk& chunk) {
+        for (const auto& ownerAndAmount : chunk) {
+            if (ownerAndAmount.second > 0 && isPayable(ownerAndAmount.first)) {
+                totalAmtOwned += ownerAndAmount.second;
+                nPayableOwners++;
+            }
+        }
+        return true;
+    });
+    if (!fRead) {
+        LogPrint(BCLog::REWARDS, "%s: Failed to retrieve ownership snapshot list!\n", __func__);
+        return false;
+    }
+
+    //  Make sure we have some addresses to pay to
+    if (nPayableOwners == 0) {
+        LogPrint(BCLog::REWARDS, "%s: Ownership of '%s' includes only exception/burn addresses.\n", __func__,
+                 strOwnershipAsset.c_str());
+        return false;
+    }
+
+    LogPrint(BCLog::REWARDS, "%s: Total amount owned %d by %u addresses\n", __func__, totalAmtOwned, nPayableOwners);
+
+    //  Second pass: each owner gets its share of the payment, rounded down to whole units of the distribution asset
+    vecDistributionList.reserve(nPayableOwners);
+    CAmount totalSentAsRewards = 0;
+    fRead = snapshotDb.ForEachOwnershipSnapshotChunk(strOwnershipAsset, nHeight, [&](const SnapshotChunk& chunk) {
+        for (const auto& ownerAndAmount : chunk) {
+            if (ownerAndAmount.second <= 0 || !isPayable(ownerAndAmount.first))
+                continue;
+
+            CAmount rewardAmt = MulDiv(ownerAndAmount.second, nPaymentUnits, totalAmtOwned) * nUnitDivisor;
+            totalSentAsRewards += rewardAmt;
+
+            //  Save it into our list if the reward payment is above zero
+            if (rewardAmt > 0)
+                vecDistributionList.push_back(OwnerAndAmount(ownerAndAmount.first, rewardAmt));
+        }
+        return true;
+    });
+    if (!fRead) {
+        LogPrint(BCLog::REWARDS, "%s: Failed to retrieve ownership snapshot list!\n", __func__);
+        vecDistributionList.clear();
+        return false;
+    }
+
+    CAmount change = nPaymentUnits * nUnitDivisor - totalSentAsRewards;
+    if (change > 0) {
+        LogPrint(BCLog::REWARDS, "%s: Found change amount of %u\n", __func__, change);
+    }
+
+    //  Snapshots are stored in key order, payments have always been batched in address order
+    std::sort(vecDistributionList.begin(), vecDistributionList.end());
+
+    return true;
+}
+
 bool GenerateDistributionList(const CRewardSnapshot& p_rewardSnapshot, std::vector<OwnerAndAmount>& vecDistributionList)
 {
     vecDistributionList.clear();
@@ -59,122 +145,43 @@ bool GenerateDistributionList(const CRewardSnapshot& p_rewardSnapshot, std::vect
         return false;
     }
 
-    //  Get details on the specified source asset
+    //  Get details on the specified source asset, NRGC has the same units as an asset with MAX_UNIT
     CNewAsset distributionAsset;
-    UNUSED_VAR bool srcIsIndivisible = false;
-    CAmount srcUnitDivisor = COIN;  //  Default to divisor for NRGC
-    const int8_t COIN_DIGITS_PAST_DECIMAL = 8;
-
-    //  This value is in indivisible units of the source asset
-    CAmount modifiedPaymentInAssetUnits = p_rewardSnapshot.nDistributionAmount;
-
     if (p_rewardSnapshot.strDistributionAsset != "NRGC") {
         if (!passets->GetAssetMetaDataIfExists(p_rewardSnapshot.strDistributionAsset, distributionAsset)) {
             LogPrint(BCLog::REWARDS, "%s: Failed to retrieve asset details for '%s'\n", __func__, p_rewardSnapshot.strDistributionAsset.c_str());
             return false;
         }
-
-        //  If the token is indivisible, signal this to later code with a zero divisor
-        if (distributionAsset.units == 0) {
-            srcIsIndivisible = true;
-        }
-
-        srcUnitDivisor = static_cast<CAmount>(pow(10, distributionAsset.units));
-
-        CAmount srcDivisor = pow(10, COIN_DIGITS_PAST_DECIMAL - distributionAsset.units);
-        modifiedPaymentInAssetUnits /= srcDivisor;
-
-        LogPrint(BCLog::REWARDS, "%s: Distribution asset '%s' has units %d and divisor %d\n", __func__,
-                 p_rewardSnapshot.strDistributionAsset.c_str(), distributionAsset.units, srcUnitDivisor);
     }
-    else {
-        LogPrint(BCLog::REWARDS, "%s: Distribution is NRGC with divisor %d\n", __func__, srcUnitDivisor);
+
+    if (distributionAsset.units < 0 || distributionAsset.units > MAX_UNIT) {
+        LogPrint(BCLog::REWARDS, "%s: Distribution asset '%s' has invalid units %d\n", __func__,
+                 p_rewardSnapshot.strDistributionAsset.c_str(), distributionAsset.units);
+        return false;
     }
 
+    //  Satoshis in the smallest unit of the distribution asset, and the payment in those units
+    CAmount nUnitDivisor = UNIT_DIVISORS[MAX_UNIT - distributionAsset.units];
+    CAmount nPaymentUnits = p_rewardSnapshot.nDistributionAmount / nUnitDivisor;
+
+    LogPrint(BCLog::REWARDS, "%s: Distribution asset '%s' has units %d and divisor %d\n", __func__,
+             p_rewardSnapshot.strDistributionAsset.c_str(), distributionAsset.units, nUnitDivisor);
     LogPrint(BCLog::REWARDS, "%s: Scaled payment amount in %s is %d\n", __func__,
-             p_rewardSnapshot.strDistributionAsset.c_str(), modifiedPaymentInAssetUnits);
+             p_rewardSnapshot.strDistributionAsset.c_str(), nPaymentUnits);
 
-    //  Get details on the ownership asset
+    //  Make sure the ownership asset exists
     CNewAsset ownershipAsset;
-    CAmount tgtUnitDivisor = 0;
     if (!passets->GetAssetMetaDataIfExists(p_rewardSnapshot.strOwnershipAsset, ownershipAsset)) {
         LogPrint(BCLog::REWARDS, "%s: Failed to retrieve asset details for '%s'\n", __func__, p_rewardSnapshot.strOwnershipAsset.c_str());
         return false;
     }
 
-    //  Save the ownership asset's divisor
-    tgtUnitDivisor = static_cast<CAmount>(pow(10, COIN_DIGITS_PAST_DECIMAL - ownershipAsset.units));
-
-    LogPrint(BCLog::REWARDS, "%s: Ownership asset '%s' has units %d and divisor %d\n", __func__,
-             p_rewardSnapshot.strOwnershipAsset.c_str(), ownershipAsset.units, tgtUnitDivisor);
-
     //  Remove exception addresses & amounts from the list
     std::set<std::string> exceptionAddressSet;
     boost::split(exceptionAddressSet, p_rewardSnapshot.strExceptionAddresses, boost::is_any_of(ADDRESS_COMMA_DELIMITER));
 
-    std::set<OwnerAndAmount> nonExceptionOwnerships;
-    CAmount totalAmtOwned = 0;
-
-    CAssetSnapshotDBEntry snapshotEntry;
-    if (!pAssetSnapshotDb->RetrieveOwnershipSnapshot(p_rewardSnapshot.strOwnershipAsset, p_rewardSnapshot.nHeight, snapshotEntry)) {
-        LogPrint(BCLog::REWARDS, "%s: Failed to retrieve ownership snapshot list!\n", __func__);
-        return false;
-    }
-
-    for (auto const & currPair : snapshotEntry.ownersAndAmounts) {
-        //  Ignore exception and burn addresses
-        if (
-                exceptionAddressSet.find(currPair.first) == exceptionAddressSet.end()
-                && !GetParams().IsBurnAddress(currPair.first)
-                ) {
-            //  Address is valid so add it to the payment list
-            nonExceptionOwnerships.insert(OwnerAndAmount(currPair.first, currPair.second));
-            totalAmtOwned += currPair.second;
-        }
-    }
-
-    //  Make sure we have some addresses to pay to
-    if (nonExceptionOwnerships.size() == 0) {
-        LogPrint(BCLog::REWARDS, "%s: Ownership of '%s' includes only exception/burn addresses.\n", __func__,
-                 p_rewardSnapshot.strOwnershipAsset.c_str());
-        return false;
-    }
-
-    LogPrint(BCLog::REWARDS, "%s: Total amount owned %d\n", __func__,
-             totalAmtOwned);
-
-    LogPrint(BCLog::REWARDS, "%s: Total payout amount %d\n", __func__,
-             modifiedPaymentInAssetUnits);
-
-    CAmount totalSentAsRewards = 0;
-    //  Loop through asset owners
-    for (auto & ownership : nonExceptionOwnerships) {
-        // Get percentage of total ownership
-        long double percent = (long double)ownership.amount / (long double)totalAmtOwned;
-        // Caculate the reward with potentional unit inaccurancies e.g with units 4, 90054100 satoshis = 0.90054100
-        CAmount rewardAmt = percent * modifiedPaymentInAssetUnits * static_cast<CAmount>(pow(10, COIN_DIGITS_PAST_DECIMAL - distributionAsset.units));
-        // Remove all none accurate units e.g with units 4 90054100 => 9005
-        rewardAmt /= static_cast<CAmount>(pow(10, COIN_DIGITS_PAST_DECIMAL - distributionAsset.units));
-        // Replace all none accurate units back with zeros e.g with units 4 9005 => 90050000 satoshis = 0.90050000
-        rewardAmt *= static_cast<CAmount>(pow(10, COIN_DIGITS_PAST_DECIMAL - distributionAsset.units));
-
-        totalSentAsRewards += rewardAmt;
-
-        LogPrint(BCLog::REWARDS, "%s: Found ownership address for '%s': '%s' owns %d => reward %d\n", __func__,
-                 p_rewardSnapshot.strOwnershipAsset.c_str(), ownership.address.c_str(),
-                 ownership.amount, rewardAmt);
-
-        //  Save it into our list if the reward payment is above zero
-        if (rewardAmt > 0)
-            vecDistributionList.push_back(OwnerAndAmount(ownership.address, rewardAmt));
-    }
-
-    CAmount change = totalAmtOwned - totalSentAsRewards;
-    if (change > 0) {
-        LogPrint(BCLog::REWARDS, "%s: Found change amount of %u\n", __func__, change);
-    }
-
-    return true;
+    return CalculateDistribution(*pAssetSnapshotDb, p_rewardSnapshot.strOwnershipAsset, p_rewardSnapshot.nHeight,
+                                 exceptionAddressSet, nPaymentUnits, nUnitDivisor, vecDistributionList);
 }
 
 #ifdef ENABLE_WALLET
@@ -191,10 +198,8 @@ void DistributeRewardSnapshot(CWallet * p_wallet, const CRewardSnapshot& p_rewar
         return;
     }
 
-    //  Retrieve the asset snapshot entry for the target asset at the specified height
-    CAssetSnapshotDBEntry snapshotEntry;
-
-    if (!pAssetSnapshotDb->RetrieveOwnershipSnapshot(p_rewardSnapshot.strOwnershipAsset, p_rewardSnapshot.nHeight, snapshotEntry)) {
+    //  Make sure there is a snapshot for the target asset at the specified height
+    if (!pAssetSnapshotDb->HasOwnershipSnapshot(p_rewardSnapshot.strOwnershipAsset, p_rewardSnapshot.nHeight)) {
         LogPrint(BCLog::REWARDS, "Failed to retrieve ownership snapshot!\n");
         return;
     }
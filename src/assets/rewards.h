@@ -20,6 +20,7 @@
 class CRewardSnapshot;
 class CWallet;
 class CRewardSnapshot;
+class CAssetSnapshotDB;
 
 extern std::map<uint256, CRewardSnapshot> mapRewardSnapshots;
 
@@ -148,6 +149,11 @@ enum {
 };
 
 bool GenerateDistributionList(const CRewardSnapshot& p_rewardSnapshot, std::vector<OwnerAndAmount>& vecDistributionList);
+//  Split nPaymentUnits whole units of the distribution asset (each worth nUnitDivisor satoshis) between the holders in the
+//      snapshot, in proportion to their holdings. The list is sorted by address.
+bool CalculateDistribution(CAssetSnapshotDB& snapshotDb, const std::string& strOwnershipAsset, int nHeight,
+                           const std::set<std::string>& setExceptionAddresses, CAmount nPaymentUnits, CAmount nUnitDivisor,
+                           std::vector<OwnerAndAmount>& vecDistributionList);
 bool AddDistributeRewardSnapshot(CRewardSnapshot& p_rewardSnapshot);
 
 #ifdef ENABLE_WALLET
@@ -0,0 +1,51 @@
+// Copyright (c) 2023-2024 The Nrgc Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench.h"
+
+#include "assets/assets.h"
+#include "test/assets/asset_name_regex.h"
+
+#include <string>
+#include <vector>
+
+/* Number of names validated per iteration, names per second = ASSET_NAMES / time per iteration */
+static const size_t ASSET_NAMES = 1000;
+
+static std::vector<std::string> AssetNames()
+{
+    static const std::vector<std::string> names = {
+        "ASSET", "NRGC_COIN", "ROOT/SUB", "ROOT/SUB/SUBSUB", "ROOT#Unique-Tag_1", "ROOT~CHANNEL_1",
+        "ROOT/SUB!", "ROOT^VOTE", "#QUALIFIER", "#QUALIFIER/#SUB", "$RESTRICTED",
+        "AB", "lower", "A__B", "_ABC", "ABC.", "ROOT#BAD~TAG", "#Q/#A/#B", "$_X", "ENERGYCOIN"};
+    std::vector<std::string> vNames;
+    for (size_t i = 0; i < ASSET_NAMES; i++)
+        vNames.push_back(names[i % names.size()]);
+    return vNames;
+}
+
+static void AssetNameValidation(benchmark::State& state)
+{
+    const std::vector<std::string> vNames = AssetNames();
+    AssetType type;
+    std::string error;
+    while (state.KeepRunning()) {
+        for (const std::string& name : vNames)
+            IsAssetNameValid(name, type, error);
+    }
+}
+
+static void AssetNameValidation_Regex(benchmark::State& state)
+{
+    const std::vector<std::string> vNames = AssetNames();
+    AssetType type;
+    std::string error;
+    while (state.KeepRunning()) {
+        for (const std::string& name : vNames)
+            asset_name_regex::IsAssetNameValid(name, type, error);
+    }
+}
+
+BENCHMARK(AssetNameValidation);
+BENCHMARK(AssetNameValidation_Regex);
@@ -0,0 +1,57 @@
+// Copyright (c) 2023-2024 The Nrgc Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench.h"
+
+#include "assets/assetsnapshotdb.h"
+#include "assets/rewards.h"
+#include "tinyformat.h"
+
+#include <cassert>
+#include <set>
+#include <string>
+#include <vector>
+
+/* Holders of the snapshotted asset */
+static const int SNAPSHOT_HOLDERS = 1000000;
+static const int SNAPSHOT_HEIGHT = 1000;
+static const std::string SNAPSHOT_ASSET = "SNAPSHOT_ASSET";
+
+/* Paid out in an asset with 4 units */
+static const CAmount SNAPSHOT_PAYMENT = 1000000 * COIN;
+static const CAmount SNAPSHOT_UNIT_DIVISOR = 10000;
+
+static void WriteSnapshot(CAssetSnapshotDB& db)
+{
+    CAssetSnapshotWriter writer(db, SNAPSHOT_ASSET, SNAPSHOT_HEIGHT);
+    for (int i = 0; i < SNAPSHOT_HOLDERS; i++)
+        writer.Add(strprintf("holder%07d", i), (1 + i % 1000) * COIN);
+    writer.Finish();
+}
+
+// Writing a snapshot of all holders in chunks
+static void AssetSnapshotWrite(benchmark::State& state)
+{
+    CAssetSnapshotDB db(fs::path("assetsnapshot"), 8 << 20, true, false);
+    while (state.KeepRunning()) {
+        WriteSnapshot(db);
+    }
+}
+
+// Streaming the snapshot twice to compute the payment of every holder
+static void AssetSnapshotDistribution(benchmark::State& state)
+{
+    CAssetSnapshotDB db(fs::path("assetsnapshot"), 8 << 20, true, false);
+    WriteSnapshot(db);
+
+    std::set<std::string> setExceptions = {"holder0000000"};
+    std::vector<OwnerAndAmount> vecDistributionList;
+    while (state.KeepRunning()) {
+        CalculateDistribution(db, SNAPSHOT_ASSET, SNAPSHOT_HEIGHT, setExceptions, SNAPSHOT_PAYMENT / SNAPSHOT_UNIT_DIVISOR, SNAPSHOT_UNIT_DIVISOR, vecDistributionList);
+        assert(vecDistributionList.size() == SNAPSHOT_HOLDERS - 1);
+    }
+}
+
+BENCHMARK(AssetSnapshotWrite);
+BENCHMARK(AssetSnapshotDistribution);
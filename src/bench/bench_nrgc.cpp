@@ -7,6 +7,7 @@
 #include <chainparamsbase.h>
 #include <chainparams.h>
 #include "bench.h"
+#include "algo/x16r_multi.h"
 #include "crypto/sha256.h"
 #include "key.h"
 #include "validation.h"
@@ -17,6 +18,7 @@ int
 main(int argc, char **argv)
 {
     SHA256AutoDetect();
+    X16RMultiAutoDetect();
     RandomInit();
     ECC_Start();
     SetupEnvironment();
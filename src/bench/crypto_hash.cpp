@@ -9,6 +9,7 @@
 #include "bench.h"
 #include "bloom.h"
 #include "hash.h"
+#include "primitives/block.h"
 #include "random.h"
 #include "uint256.h"
 #include "utiltime.h"
@@ -17,6 +18,8 @@
 #include "crypto/sha256.h"
 #include "crypto/sha512.h"
 
+#include <crypto/ethash/include/ethash/progpow.hpp>
+
 /* Number of bytes to hash per iteration */
 static const uint64_t BUFFER_SIZE = 1000*1000;
 
@@ -94,6 +97,104 @@ static void FastRandom_1bit(benchmark::State& state)
     }
 }
 
+/* Number of headers hashed per iteration by the X16R benchmarks */
+static const size_t X16R_HEADERS = 512;
+
+static std::vector<CBlockHeader> RandomX16RHeaders()
+{
+    FastRandomContext rng(true);
+    std::vector<CBlockHeader> headers(X16R_HEADERS);
+    for (CBlockHeader& header : headers) {
+        header.nVersion = 0x20000000;
+        header.hashPrevBlock = rng.rand256();
+        header.hashMerkleRoot = rng.rand256();
+        header.nTime = rng.randbool() ? 1514764800 : 1569945600; // X16R or X16RV2
+        header.nBits = 0x1e00ffff;
+        header.nNonce = rng.rand32();
+    }
+    return headers;
+}
+
+static void X16R_Headers_Serial(benchmark::State& state)
+{
+    std::vector<CBlockHeader> headers = RandomX16RHeaders();
+    uint256 hash;
+    while (state.KeepRunning()) {
+        for (const CBlockHeader& header : headers) {
+            hash = header.GetHash();
+        }
+    }
+}
+
+static void X16R_Headers_Multi(benchmark::State& state)
+{
+    std::vector<CBlockHeader> headers = RandomX16RHeaders();
+    std::vector<uint256> hashes;
+    while (state.KeepRunning()) {
+        GetBlockHeaderHashes(headers, hashes);
+    }
+}
+
+/* Number of KAWPOW hashes per iteration, all at a height of the first epoch so its context is built only once */
+static const int KAWPOW_HASHES = 16;
+static const uint32_t KAWPOW_BENCH_HEIGHT = 1000;
+
+static std::vector<uint256> RandomKAWPOWHeaderHashes()
+{
+    FastRandomContext rng(true);
+    std::vector<uint256> hashes(KAWPOW_HASHES);
+    for (uint256& hash : hashes)
+        hash = rng.rand256();
+    return hashes;
+}
+
+/* The conversions the KAWPOW hashing used to do, through hex strings */
+static void KAWPOW_Hash_HexStrings(benchmark::State& state)
+{
+    std::vector<uint256> header_hashes = RandomKAWPOWHeaderHashes();
+    const ethash::epoch_context& context = ethash::get_global_epoch_context(ethash::get_epoch_number(KAWPOW_BENCH_HEIGHT));
+    uint256 mix_hash, hash;
+    while (state.KeepRunning()) {
+        for (int i = 0; i < KAWPOW_HASHES; i++) {
+            const auto result = progpow::hash(context, KAWPOW_BENCH_HEIGHT, to_hash256(header_hashes[i].GetHex()), i);
+            mix_hash = uint256S(to_hex(result.mix_hash));
+            hash = uint256S(to_hex(result.final_hash));
+        }
+    }
+}
+
+static void KAWPOW_Hash(benchmark::State& state)
+{
+    std::vector<uint256> header_hashes = RandomKAWPOWHeaderHashes();
+    // Build the context before timing
+    ethash::get_global_epoch_context(ethash::get_epoch_number(KAWPOW_BENCH_HEIGHT));
+    uint256 mix_hash, hash;
+    while (state.KeepRunning()) {
+        for (int i = 0; i < KAWPOW_HASHES; i++)
+            hash = KAWPOWHash(header_hashes[i], KAWPOW_BENCH_HEIGHT, i, mix_hash);
+    }
+}
+
+static void KAWPOW_OnlyMix_HexStrings(benchmark::State& state)
+{
+    std::vector<uint256> header_hashes = RandomKAWPOWHeaderHashes();
+    uint256 mix_hash = header_hashes[0], hash;
+    while (state.KeepRunning()) {
+        for (int i = 0; i < KAWPOW_HASHES; i++)
+            hash = uint256S(to_hex(progpow::hash_no_verify(KAWPOW_BENCH_HEIGHT, to_hash256(header_hashes[i].GetHex()), to_hash256(mix_hash.GetHex()), i)));
+    }
+}
+
+static void KAWPOW_OnlyMix(benchmark::State& state)
+{
+    std::vector<uint256> header_hashes = RandomKAWPOWHeaderHashes();
+    uint256 mix_hash = header_hashes[0], hash;
+    while (state.KeepRunning()) {
+        for (int i = 0; i < KAWPOW_HASHES; i++)
+            hash = KAWPOWHash_OnlyMix(header_hashes[i], KAWPOW_BENCH_HEIGHT, i, mix_hash);
+    }
+}
+
 BENCHMARK(RIPEMD160);
 BENCHMARK(SHA1);
 BENCHMARK(SHA256);
@@ -103,3 +204,11 @@ BENCHMARK(SHA256_32b);
 BENCHMARK(SipHash_32b);
 BENCHMARK(FastRandom_32bit);
 BENCHMARK(FastRandom_1bit);
+
+BENCHMARK(X16R_Headers_Serial);
+BENCHMARK(X16R_Headers_Multi);
+
+BENCHMARK(KAWPOW_Hash_HexStrings);
+BENCHMARK(KAWPOW_Hash);
+BENCHMARK(KAWPOW_OnlyMix_HexStrings);
+BENCHMARK(KAWPOW_OnlyMix);
@@ -9,6 +9,7 @@
 #include "txmempool.h"
 
 #include <list>
+#include <string>
 #include <vector>
 
 static void AddTx(const CTransaction& tx, const CAmount& nFee, CTxMemPool& pool)
@@ -114,3 +115,54 @@ static void MempoolEviction(benchmark::State& state)
 }
 
 BENCHMARK(MempoolEviction);
+
+// Restricted asset transfers and tag/freeze transactions, with the bookkeeping AcceptToMemoryPool does for
+// them, added to and then removed from the mempool
+static void MempoolAssetRestrictions(benchmark::State& state)
+{
+    typedef CMemPoolRestrictionIndex::Kind Kind;
+    const int nTxs = 1000;
+    const int nAssets = 10;
+    const int nAddresses = 100;
+
+    std::vector<CTransactionRef> vTxs;
+    for (int i = 0; i < nTxs; i++) {
+        CMutableTransaction tx;
+        tx.vin.resize(1);
+        tx.vin[0].prevout = COutPoint(uint256(), i);
+        tx.vin[0].scriptSig = CScript() << OP_1;
+        tx.vout.resize(1);
+        tx.vout[0].scriptPubKey = CScript() << OP_1 << OP_EQUAL;
+        tx.vout[0].nValue = 10 * COIN;
+        vTxs.push_back(MakeTransactionRef(tx));
+    }
+
+    CTxMemPool pool;
+    LOCK(pool.cs);
+
+    while (state.KeepRunning()) {
+        for (int i = 0; i < nTxs; i++) {
+            const CTransaction& tx = *vTxs[i];
+            const uint256& hash = tx.GetHash();
+            AddTx(tx, 1000LL, pool);
+
+            std::string strAsset = "$RESTRICTED" + std::to_string(i % nAssets);
+            std::string strAddress = "address" + std::to_string(i % nAddresses);
+            if (i % 10 == 0) {
+                // Every tenth transaction tags an address or freezes an asset
+                pool.restrictionIndex.Add(Kind::ADDRESS_ADDED_TAG, hash, strAddress, "#TAG" + std::to_string(i));
+                pool.restrictionIndex.Add(Kind::GLOBAL_FREEZING, hash, strAsset);
+            } else {
+                pool.restrictionIndex.Add(Kind::QUALIFIERS_CHANGED, hash, strAddress);
+                pool.restrictionIndex.Add(Kind::VERIFIER_CHANGED, hash, strAsset);
+                pool.restrictionIndex.Add(Kind::ASSET_GLOBAL_FROZEN, hash, strAsset);
+                pool.restrictionIndex.Add(Kind::ADDRESS_FROZEN, hash, strAddress, strAsset);
+            }
+        }
+
+        for (const auto& tx : vTxs)
+            pool.removeRecursive(*tx);
+    }
+}
+
+BENCHMARK(MempoolAssetRestrictions);
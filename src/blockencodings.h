@@ -219,6 +219,7 @@ public:
     std::string ipfs;
     int32_t nHeight;
 
+    SerializedAssetData() : units(0), amount(0), reissuable(0), hasIPFS(0), nHeight(-1) {}
     SerializedAssetData(const CDatabasedAssetData &assetData);
 
     ADD_SERIALIZE_METHODS;
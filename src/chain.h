@@ -434,7 +434,8 @@ public:
 
     }
 
-    uint256 GetBlockHash() const
+    //! The header this entry was built from; unlike GetBlockHeader() it does not need pprev
+    CBlockHeader GetDiskBlockHeader() const
     {
         CBlockHeader block;
         block.nVersion        = nVersion;
@@ -447,7 +448,12 @@ public:
         block.nHeight         = nHeight;
         block.nNonce64        = nNonce64;
         block.mix_hash        = mix_hash;
-        return block.GetHash();
+        return block;
+    }
+
+    uint256 GetBlockHash() const
+    {
+        return GetDiskBlockHeader().GetHash();
     }
 
 
@@ -605,7 +605,7 @@ bool Consensus::CheckTxInputs(const CTransaction& tx, CValidationState& state, c
 }
 
 //! Check to make sure that the inputs and outputs CAmount match exactly.
-bool Consensus::CheckTxAssets(const CTransaction& tx, CValidationState& state, const CCoinsViewCache& inputs, CAssetsCache* assetCache, bool fCheckMempool, std::vector<std::pair<std::string, uint256> >& vPairReissueAssets, const bool fRunningUnitTests, std::set<CMessage>* setMessages, int64_t nBlocktime,   std::vector<std::pair<std::string, CNullAssetTxData>>* myNullAssetData)
+bool Consensus::CheckTxAssets(const CTransaction& tx, CValidationState& state, const CCoinsViewCache& inputs, CAssetsCache* assetCache, bool fCheckMempool, std::vector<std::pair<std::string, uint256> >& vPairReissueAssets, const bool fRunningUnitTests, std::set<CMessage>* setMessages, int64_t nBlocktime,   std::vector<std::pair<std::string, CNullAssetTxData>>* myNullAssetData, std::vector<CAssetCheck>* pvAssetChecks)
 {
     // are the actual inputs available?
     if (!inputs.HaveInputs(tx)) {
@@ -639,7 +639,9 @@ bool Consensus::CheckTxAssets(const CTransaction& tx, CValidationState& state, c
             }
 
             if (IsAssetNameAnRestricted(data.assetName)) {
-                if (assetCache->CheckForAddressRestriction(data.assetName, EncodeDestination(data.destination), true)) {
+                if (pvAssetChecks) {
+                    pvAssetChecks->emplace_back(CAssetCheck::FROZEN_ADDRESS, data.assetName, EncodeDestination(data.destination), assetCache, tx.GetHash());
+                } else if (assetCache->CheckForAddressRestriction(data.assetName, EncodeDestination(data.destination), true)) {
                     return state.DoS(100, false, REJECT_INVALID, "bad-txns-restricted-asset-transfer-from-frozen-address", false, "", tx.GetHash());
                 }
             }
@@ -690,9 +692,13 @@ bool Consensus::CheckTxAssets(const CTransaction& tx, CValidationState& state, c
             if (!TransferAssetFromScript(txout.scriptPubKey, transfer, address))
                 return state.DoS(100, false, REJECT_INVALID, "bad-tx-asset-transfer-bad-deserialize", false, "", tx.GetHash());
 
-            if (!ContextualCheckTransferAsset(assetCache, transfer, address, strError))
+            // The restrictions of the asset are checked on the asset check queue when it is given one
+            if (!ContextualCheckTransferAsset(assetCache, transfer, address, strError, !pvAssetChecks))
                 return state.DoS(100, false, REJECT_INVALID, strError, false, "", tx.GetHash());
 
+            if (pvAssetChecks && IsAssetNameAnRestricted(transfer.strName))
+                pvAssetChecks->emplace_back(CAssetCheck::RESTRICTED_TRANSFER, transfer.strName, address, assetCache, tx.GetHash());
+
             // Add to the total value of assets in the outputs
             if (totalOutputs.count(transfer.strName))
                 totalOutputs.at(transfer.strName) += transfer.nAmount;
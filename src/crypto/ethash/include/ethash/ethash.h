@@ -105,9 +105,26 @@ void ethash_destroy_epoch_context_full(struct ethash_epoch_context_full* context
 
 /**
  * Get global shared epoch context.
+ *
+ * If the context is not built yet it is built (or loaded from the storage set with
+ * ethash::set_global_epoch_context_storage()) in the calling thread. If another
+ * thread is already building it, this waits for that thread instead.
  */
 const struct ethash_epoch_context* ethash_get_global_epoch_context(int epoch_number) NOEXCEPT;
 
+/**
+ * Get global shared epoch context only if it is already built.
+ *
+ * @return  Pointer to the context or null if it is not built yet or is still being built.
+ */
+const struct ethash_epoch_context* ethash_try_get_global_epoch_context(int epoch_number) NOEXCEPT;
+
+/**
+ * Build the global shared epoch context in the calling thread so that later
+ * ethash_get_global_epoch_context() calls for the epoch find it ready.
+ */
+void ethash_prebuild_global_epoch_context(int epoch_number) NOEXCEPT;
+
 /**
  * Get global shared epoch context with full dataset initialized.
  */
@@ -164,6 +164,31 @@ inline const epoch_context& get_global_epoch_context(int epoch_number) noexcept
     return *ethash_get_global_epoch_context(epoch_number);
 }
 
+/// Get global shared epoch context if it is already built, null otherwise.
+inline const epoch_context* try_get_global_epoch_context(int epoch_number) noexcept
+{
+    return ethash_try_get_global_epoch_context(epoch_number);
+}
+
+/// Build the global shared epoch context ahead of time.
+inline void prebuild_global_epoch_context(int epoch_number) noexcept
+{
+    ethash_prebuild_global_epoch_context(epoch_number);
+}
+
+/// Loads a previously stored epoch context, returns null if there is none.
+using epoch_context_load_fn = std::shared_ptr<epoch_context> (*)(int epoch_number);
+
+/// Stores a freshly built epoch context.
+using epoch_context_store_fn = void (*)(const epoch_context& context);
+
+/// Set the persistent storage used for the global shared epoch contexts.
+///
+/// Before building a context, get_global_epoch_context() first asks load_fn for it,
+/// and every context it has to build is handed to store_fn afterwards.
+void set_global_epoch_context_storage(
+    epoch_context_load_fn load_fn, epoch_context_store_fn store_fn) noexcept;
+
 /// Get global shared epoch context with full dataset initialized.
 inline const epoch_context_full& get_global_epoch_context_full(int epoch_number) noexcept
 {
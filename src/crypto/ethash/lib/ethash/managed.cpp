@@ -5,6 +5,8 @@
 #include "crypto/ethash/lib/ethash/ethash-internal.hpp"
 #include "sync.h"
 
+#include <future>
+#include <map>
 #include <memory>
 
 #if !defined(__has_cpp_attribute)
@@ -24,39 +26,100 @@ using namespace ethash;
 namespace
 {
 
+using shared_context_future = std::shared_future<std::shared_ptr<epoch_context>>;
+
+/// Number of epoch contexts kept in shared_contexts, enough for the current epoch,
+/// the next one being prebuilt and the previous one for reorgs across the boundary.
+constexpr size_t max_shared_contexts = 3;
+
 CCriticalSection shared_context_cs;
-std::shared_ptr<epoch_context> shared_context;
+/// Contexts of the recently used epochs, including ones still being built.
+/// Building happens outside shared_context_cs, so threads needing an epoch that is
+/// already built never wait for the build of another one.
+std::map<int, shared_context_future> shared_contexts;
+epoch_context_load_fn context_load_fn = nullptr;
+epoch_context_store_fn context_store_fn = nullptr;
 thread_local std::shared_ptr<epoch_context> thread_local_context;
 
 CCriticalSection shared_context_full_cs;
 std::shared_ptr<epoch_context_full> shared_context_full;
 thread_local std::shared_ptr<epoch_context_full> thread_local_context_full;
 
+/// Load the context from the storage, or build it and hand it to the storage.
+std::shared_ptr<epoch_context> build_shared_context(int epoch_number)
+{
+    epoch_context_load_fn load_fn;
+    epoch_context_store_fn store_fn;
+    {
+        LOCK(shared_context_cs);
+        load_fn = context_load_fn;
+        store_fn = context_store_fn;
+    }
+
+    std::shared_ptr<epoch_context> context;
+    if (load_fn)
+        context = load_fn(epoch_number);
+    if (!context)
+    {
+        context = create_epoch_context(epoch_number);
+        if (context && store_fn)
+            store_fn(*context);
+    }
+    return context;
+}
+
+/// Get the shared context of the epoch, building it in this thread if no other thread
+/// has started to. Returns null if wait is false and the context is not ready yet.
+std::shared_ptr<epoch_context> get_shared_context(int epoch_number, bool wait)
+{
+    std::promise<std::shared_ptr<epoch_context>> promise;
+    shared_context_future future;
+    bool build = false;
+    {
+        LOCK(shared_context_cs);
+        auto it = shared_contexts.find(epoch_number);
+        if (it != shared_contexts.end())
+            future = it->second;
+        else if (wait)
+        {
+            future = promise.get_future().share();
+            shared_contexts.emplace(epoch_number, future);
+            build = true;
+
+            // Drop the epoch furthest away from this one. Threads still using it
+            // keep it alive through their own references.
+            while (shared_contexts.size() > max_shared_contexts)
+            {
+                if (epoch_number - shared_contexts.begin()->first >
+                    shared_contexts.rbegin()->first - epoch_number)
+                    shared_contexts.erase(shared_contexts.begin());
+                else
+                    shared_contexts.erase(std::prev(shared_contexts.end()));
+            }
+        }
+        else
+            return nullptr;
+    }
+
+    if (build)
+        promise.set_value(build_shared_context(epoch_number));
+    else if (!wait && future.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+        return nullptr;
+
+    return future.get();
+}
+
 /// Update thread local epoch context.
 ///
 /// This function is on the slow path. It's separated to allow inlining the fast
 /// path.
-///
-/// @todo: Redesign to guarantee deallocation before new allocation.
 ATTRIBUTE_NOINLINE
 void update_local_context(int epoch_number)
 {
     // Release the shared pointer of the obsoleted context.
     thread_local_context.reset();
 
-    // Local context invalid, check the shared context.
-    LOCK(shared_context_cs);
-
-    if (!shared_context || shared_context->epoch_number != epoch_number)
-    {
-        // Release the shared pointer of the obsoleted context.
-        shared_context.reset();
-
-        // Build new context.
-        shared_context = create_epoch_context(epoch_number);
-    }
-
-    thread_local_context = shared_context;
+    thread_local_context = get_shared_context(epoch_number, true);
 }
 
 ATTRIBUTE_NOINLINE
@@ -90,6 +153,32 @@ const ethash_epoch_context* ethash_get_global_epoch_context(int epoch_number) no
     return thread_local_context.get();
 }
 
+const ethash_epoch_context* ethash_try_get_global_epoch_context(int epoch_number) noexcept
+{
+    if (!thread_local_context || thread_local_context->epoch_number != epoch_number)
+    {
+        std::shared_ptr<epoch_context> context = get_shared_context(epoch_number, false);
+        if (!context)
+            return nullptr;
+        thread_local_context = std::move(context);
+    }
+
+    return thread_local_context.get();
+}
+
+void ethash_prebuild_global_epoch_context(int epoch_number) noexcept
+{
+    get_shared_context(epoch_number, true);
+}
+
+void ethash::set_global_epoch_context_storage(
+    epoch_context_load_fn load_fn, epoch_context_store_fn store_fn) noexcept
+{
+    LOCK(shared_context_cs);
+    context_load_fn = load_fn;
+    context_store_fn = store_fn;
+}
+
 const ethash_epoch_context_full* ethash_get_global_epoch_context_full(int epoch_number) noexcept
 {
     // Check if local context matches epoch number.
@@ -362,10 +362,15 @@ result hash(const epoch_context_full& context, int block_number, const hash256&
         auto* full_dataset_1024 = static_cast<const epoch_context_full&>(ctx).full_dataset;
         auto* full_dataset_2048 = reinterpret_cast<hash2048*>(full_dataset_1024);
         hash2048& item = full_dataset_2048[index];
-        if (item.word64s[0] == 0)
+        if (__atomic_load_n(&item.word64s[0], __ATOMIC_ACQUIRE) == 0)
         {
-            // TODO: Copy elision here makes it thread-safe?
-            item = calculate_dataset_item_2048(ctx, index);
+            // Mining threads share the full dataset, so publish a computed item by storing its first
+            // word last. A reader seeing a non-zero first word then also sees the rest of the item.
+            const hash2048 computed = calculate_dataset_item_2048(ctx, index);
+            for (size_t i = 1; i < sizeof(item.word64s) / sizeof(item.word64s[0]); ++i)
+                item.word64s[i] = computed.word64s[i];
+            __atomic_store_n(&item.word64s[0], computed.word64s[0], __ATOMIC_RELEASE);
+            return computed;
         }
 
         return item;
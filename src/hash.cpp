@@ -256,38 +256,38 @@ uint64_t SipHashUint256Extra(uint64_t k0, uint64_t k1, const uint256& val, uint3
     return v0 ^ v1 ^ v2 ^ v3;
 }
 
-uint256 KAWPOWHash(const CBlockHeader& blockHeader, uint256& mix_hash)
+uint256 KAWPOWHash(const uint256& header_hash, uint32_t nHeight, uint64_t nNonce, uint256& mix_hash)
 {
-    static ethash::epoch_context_ptr context{nullptr, nullptr};
+    // Get the context from the block height. The global context is shared between threads and
+    // cached per thread, so headers can be verified concurrently (see CHeaderCheck).
+    const auto epoch_number = ethash::get_epoch_number(nHeight);
+    const ethash::epoch_context& context = ethash::get_global_epoch_context(epoch_number);
 
-    // Get the context from the block height
-    const auto epoch_number = ethash::get_epoch_number(blockHeader.nHeight);
+    return KAWPOWHash(context, header_hash, nHeight, nNonce, mix_hash);
+}
 
-    if (!context || context->epoch_number != epoch_number)
-        context = ethash::create_epoch_context(epoch_number);
+uint256 KAWPOWHash(const ethash::epoch_context& context, const uint256& header_hash, uint32_t nHeight, uint64_t nNonce, uint256& mix_hash)
+{
+    const auto result = progpow::hash(context, nHeight, ToEthashHash(header_hash), nNonce);
 
-    // Build the header_hash
-    uint256 nHeaderHash = blockHeader.GetKAWPOWHeaderHash();
-    const auto header_hash = to_hash256(nHeaderHash.GetHex());
+    mix_hash = FromEthashHash(result.mix_hash);
+    return FromEthashHash(result.final_hash);
+}
 
-    // ProgPow hash
-    const auto result = progpow::hash(*context, blockHeader.nHeight, header_hash, blockHeader.nNonce64);
+uint256 KAWPOWHash_OnlyMix(const uint256& header_hash, uint32_t nHeight, uint64_t nNonce, const uint256& mix_hash)
+{
+    return FromEthashHash(progpow::hash_no_verify(nHeight, ToEthashHash(header_hash), ToEthashHash(mix_hash), nNonce));
+}
 
-    mix_hash = uint256S(to_hex(result.mix_hash));
-    return uint256S(to_hex(result.final_hash));
+uint256 KAWPOWHash(const CBlockHeader& blockHeader, uint256& mix_hash)
+{
+    return KAWPOWHash(blockHeader.GetKAWPOWHeaderHash(), blockHeader.nHeight, blockHeader.nNonce64, mix_hash);
 }
 
 
 uint256 KAWPOWHash_OnlyMix(const CBlockHeader& blockHeader)
 {
-    // Build the header_hash
-    uint256 nHeaderHash = blockHeader.GetKAWPOWHeaderHash();
-    const auto header_hash = to_hash256(nHeaderHash.GetHex());
-
-    // ProgPow hash
-    const auto result = progpow::hash_no_verify(blockHeader.nHeight, header_hash, to_hash256(blockHeader.mix_hash.GetHex()), blockHeader.nNonce64);
-
-    return uint256S(to_hex(result));
+    return KAWPOWHash_OnlyMix(blockHeader.GetKAWPOWHeaderHash(), blockHeader.nHeight, blockHeader.nNonce64, blockHeader.mix_hash);
 }
 
 
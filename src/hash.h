@@ -606,6 +606,34 @@ inline uint256 HashX16RV2(const T1 pbegin, const T1 pend, const uint256 PrevBloc
     return hash[15].trim256();
 }
 
+/** The ethash form of a uint256. ethash hashes hold their bytes in the order uint256::GetHex() prints them */
+inline ethash::hash256 ToEthashHash(const uint256& hash)
+{
+    ethash::hash256 result;
+    for (size_t i = 0; i < sizeof(result.bytes); i++)
+        result.bytes[i] = hash.begin()[sizeof(result.bytes) - 1 - i];
+    return result;
+}
+
+inline uint256 FromEthashHash(const ethash::hash256& hash)
+{
+    uint256 result;
+    for (size_t i = 0; i < sizeof(hash.bytes); i++)
+        result.begin()[sizeof(hash.bytes) - 1 - i] = hash.bytes[i];
+    return result;
+}
+
+/**
+ * KAWPOW hashes of a header hash (see CBlockHeader::GetKAWPOWHeaderHash) at nHeight with nNonce. They work on the
+ * binary hashes, and the epoch contexts come from the global context manager, which shares them between threads.
+ * So they can be called concurrently from validation, RPC and mining threads.
+ */
+uint256 KAWPOWHash(const uint256& header_hash, uint32_t nHeight, uint64_t nNonce, uint256& mix_hash);
+/** As above with the epoch context of nHeight given, for callers that hash many nonces */
+uint256 KAWPOWHash(const ethash::epoch_context& context, const uint256& header_hash, uint32_t nHeight, uint64_t nNonce, uint256& mix_hash);
+/** The final hash given the mix hash, without checking that the mix hash is correct */
+uint256 KAWPOWHash_OnlyMix(const uint256& header_hash, uint32_t nHeight, uint64_t nNonce, const uint256& mix_hash);
+
 uint256 KAWPOWHash(const CBlockHeader& blockHeader, uint256& mix_hash);
 uint256 KAWPOWHash_OnlyMix(const CBlockHeader& blockHeader);
 
@@ -12,6 +12,7 @@
 #include "init.h"
 
 #include "addrman.h"
+#include "algo/x16r_multi.h"
 #include "amount.h"
 #include "chain.h"
 #include "chainparams.h"
@@ -21,6 +22,7 @@
 #include "fs.h"
 #include "httpserver.h"
 #include "httprpc.h"
+#include "kawpowcache.h"
 #include "key.h"
 #include "validation.h"
 #include "miner.h"
@@ -212,6 +214,7 @@ void PrepareShutdown()
     // Because these depend on each-other, we make sure that neither can be
     // using the other before destroying them.
     UnregisterValidationInterface(peerLogic.get());
+    StopKawpowEpochCache();
     if(g_connman) g_connman->Stop();
     peerLogic.reset();
     g_connman.reset();
@@ -295,6 +298,9 @@ void PrepareShutdown()
         delete passetsVerifierCache;
         passetsVerifierCache = nullptr;
 
+        delete passetsCompiledVerifierCache;
+        passetsCompiledVerifierCache = nullptr;
+
         delete passetsQualifierCache;
         passetsQualifierCache = nullptr;
 
@@ -451,6 +457,7 @@ std::string HelpMessage(HelpMessageMode mode)
     strUsage += HelpMessageOpt("-disablemessaging", strprintf(_("Turn off the databasing the messages sent with assets (default: %u)"), false));
     if (showDebug)
         strUsage += HelpMessageOpt("-feefilter", strprintf("Tell other nodes to filter invs to us by our mempool min fee (default: %u)", DEFAULT_FEEFILTER));
+    strUsage += HelpMessageOpt("-kawpowcache", strprintf(_("Keep generated KAWPOW epoch caches in <datadir>/kawpow and map them on startup instead of generating them again (default: %u)"), DEFAULT_KAWPOW_CACHE));
     strUsage += HelpMessageOpt("-loadblock=<file>", _("Imports blocks from external blk000??.dat file on startup"));
     strUsage += HelpMessageOpt("-maxreorg=<n>", strprintf(_("Set the Maximum reorg depth (default: %u)"), defaultChainParams->MaxReorganizationDepth()));
     strUsage += HelpMessageOpt("-minreorgpeers=<n>", strprintf(_("Set the Minimum amount of peers required to disallow reorg of chains of depth >= maxreorg. Peers must be greater than. (default: %u)"), defaultChainParams->MinReorganizationPeers()));
@@ -604,6 +611,7 @@ std::string HelpMessage(HelpMessageMode mode)
     strUsage += HelpMessageOpt("-blockmaxweight=<n>", strprintf(_("Set maximum BIP141 block weight (default: %d)"), MAX_BLOCK_WEIGHT - 4000));
     strUsage += HelpMessageOpt("-blockmaxsize=<n>", _("Set maximum BIP141 block weight to this * 4. Deprecated, use blockmaxweight"));
     strUsage += HelpMessageOpt("-blockmintxfee=<amt>", strprintf(_("Set lowest fee rate (in %s/kB) for transactions to be included in block creation. (default: %s)"), CURRENCY_UNIT, FormatMoney(DEFAULT_BLOCK_MIN_TX_FEE)));
+    strUsage += HelpMessageOpt("-minerdagmemory=<n>", strprintf(_("Let the built-in miner build the full KAWPOW dataset if it fits in <n> MiB, otherwise it hashes from the light cache (default: %u)"), DEFAULT_MINER_DAG_MEMORY));
     if (showDebug)
         strUsage += HelpMessageOpt("-blockversion=<n>", "Override block version to test forking scenarios");
 
@@ -1297,6 +1305,8 @@ bool AppInitSanityChecks()
     // Initialize elliptic curve code
     std::string sha256_algo = SHA256AutoDetect();
     LogPrintf("Using the '%s' SHA256 implementation\n", sha256_algo);
+    std::string x16r_algo = X16RMultiAutoDetect();
+    LogPrintf("Using the '%s' X16R multi-lane implementation\n", x16r_algo);
     RandomInit();
     ECC_Start();
     globalVerifyHandle.reset(new ECCVerifyHandle());
@@ -1349,10 +1359,13 @@ bool AppInitMain(boost::thread_group& threadGroup, CScheduler& scheduler)
     InitSignatureCache();
     InitScriptExecutionCache();
 
-    LogPrintf("Using %u threads for script verification\n", nScriptCheckThreads);
+    LogPrintf("Using %u threads for script, header proof of work and restricted asset verification\n", nScriptCheckThreads);
     if (nScriptCheckThreads) {
-        for (int i=0; i<nScriptCheckThreads-1; i++)
+        for (int i=0; i<nScriptCheckThreads-1; i++) {
             threadGroup.create_thread(&ThreadScriptCheck);
+            threadGroup.create_thread(&ThreadHeaderCheck);
+            threadGroup.create_thread(&ThreadAssetCheck);
+        }
     }
 
     // Start the lightweight task scheduler thread
@@ -1563,6 +1576,7 @@ bool AppInitMain(boost::thread_group& threadGroup, CScheduler& scheduler)
                     // Restricted assets
                     delete prestricteddb;
                     delete passetsVerifierCache;
+                    delete passetsCompiledVerifierCache;
                     delete passetsQualifierCache;
                     delete passetsRestrictionCache;
                     delete passetsGlobalRestrictionCache;
@@ -1575,12 +1589,12 @@ bool AppInitMain(boost::thread_group& threadGroup, CScheduler& scheduler)
                     // Basic assets
                     passetsdb = new CAssetsDB(nBlockTreeDBCache, false, fReset);
                     passets = new CAssetsCache();
-                    passetsCache = new CLRUCache<std::string, CDatabasedAssetData>(MAX_CACHE_ASSETS_SIZE);
+                    passetsCache = new CShardedLRUCache<std::string, CDatabasedAssetData>(MAX_CACHE_ASSETS_SIZE);
 
                     // Messaging assets
-                    pMessagesCache = new CLRUCache<std::string, CMessage>(1000);
-                    pMessageSubscribedChannelsCache = new CLRUCache<std::string, int>(1000);
-                    pMessagesSeenAddressCache = new CLRUCache<std::string, int>(1000);
+                    pMessagesCache = new CShardedLRUCache<std::string, CMessage>(1000);
+                    pMessageSubscribedChannelsCache = new CShardedLRUCache<std::string, int>(1000);
+                    pMessagesSeenAddressCache = new CShardedLRUCache<std::string, int>(1000);
                     pmessagedb = new CMessageDB(nBlockTreeDBCache, false, false);
                     pmessagechanneldb = new CMessageChannelDB(nBlockTreeDBCache, false, false);
 
@@ -1589,11 +1603,13 @@ bool AppInitMain(boost::thread_group& threadGroup, CScheduler& scheduler)
 
                     // Restricted assets
                     prestricteddb = new CRestrictedDB(nBlockTreeDBCache, false, fReset);
-                    passetsVerifierCache = new CLRUCache<std::string, CNullAssetTxVerifierString>(
+                    passetsVerifierCache = new CShardedLRUCache<std::string, CNullAssetTxVerifierString>(
+                            MAX_CACHE_ASSETS_SIZE);
+                    passetsCompiledVerifierCache = new CShardedLRUCache<std::string, std::shared_ptr<const CCompiledVerifierString>>(
                             MAX_CACHE_ASSETS_SIZE);
-                    passetsQualifierCache = new CLRUCache<std::string, int8_t>(MAX_CACHE_ASSETS_SIZE);
-                    passetsRestrictionCache = new CLRUCache<std::string, int8_t>(MAX_CACHE_ASSETS_SIZE);
-                    passetsGlobalRestrictionCache = new CLRUCache<std::string, int8_t>(MAX_CACHE_ASSETS_SIZE);
+                    passetsQualifierCache = new CShardedLRUCache<std::string, int8_t>(MAX_CACHE_ASSETS_SIZE);
+                    passetsRestrictionCache = new CShardedLRUCache<std::string, int8_t>(MAX_CACHE_ASSETS_SIZE);
+                    passetsGlobalRestrictionCache = new CShardedLRUCache<std::string, int8_t>(MAX_CACHE_ASSETS_SIZE);
 
                     // Rewards
                     pSnapshotRequestDb = new CSnapshotRequestDB(nBlockTreeDBCache, false, false);
@@ -1608,6 +1624,11 @@ bool AppInitMain(boost::thread_group& threadGroup, CScheduler& scheduler)
                         break;
                     }
 
+                    if (fAssetIndex && !passetsdb->BuildAssetHolderCounts()) {
+                        strLoadError = _("Failed to count asset holders");
+                        break;
+                    }
+
                     if (!passetsdb->ReadReissuedMempoolState())
                         LogPrintf(
                                 "Database failed to load last Reissued Mempool State. Will have to start from empty state");
@@ -1850,6 +1871,14 @@ bool AppInitMain(boost::thread_group& threadGroup, CScheduler& scheduler)
         vImportFiles.push_back(strFile);
     }
 
+    // Get the KAWPOW epoch contexts of the tip ready before ThreadImport starts connecting blocks
+    StartKawpowEpochCache(threadGroup, gArgs.GetBoolArg("-kawpowcache", DEFAULT_KAWPOW_CACHE));
+    {
+        LOCK(cs_main);
+        if (chainActive.Tip() && chainActive.Tip()->nTime >= nKAWPOWActivationTime)
+            PrebuildKawpowEpochContexts(chainActive.Height());
+    }
+
     threadGroup.create_thread(boost::bind(&ThreadImport, vImportFiles));
 
     // Wait for genesis block to be processed
@@ -0,0 +1,254 @@
+// Copyright (c) 2023-2024 The Nrgc Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "kawpowcache.h"
+
+#include "chain.h"
+#include "crypto/sha256.h"
+#include "fs.h"
+#include "primitives/block.h"
+#include "sync.h"
+#include "tinyformat.h"
+#include "util.h"
+#include "validationinterface.h"
+
+#include <crypto/ethash/include/ethash/ethash.hpp>
+#include <crypto/ethash/include/ethash/progpow.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <set>
+
+#include <boost/thread.hpp>
+
+#ifndef WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+/** Layout of an epoch cache file: this header, the light cache, then the progpow L1 cache. */
+struct KawpowCacheFileHeader
+{
+    char magic[8];
+    int32_t nEpoch;
+    int32_t nLightCacheItems;
+    uint32_t nL1CacheSize;
+    uint32_t nReserved;
+    //! SHA256 of the light cache and L1 cache
+    unsigned char checksum[CSHA256::OUTPUT_SIZE];
+    unsigned char padding[8];
+};
+static_assert(sizeof(KawpowCacheFileHeader) == ethash::light_cache_item_size, "light cache must stay item aligned");
+
+const char KAWPOW_CACHE_MAGIC[8] = {'N', 'R', 'G', 'C', 'K', 'P', 'W', '1'};
+
+boost::mutex csPrebuild;
+CConditionVariable condPrebuild;
+std::set<int> setPrebuildEpochs;
+
+fs::path GetKawpowCacheDir()
+{
+    return GetDataDir() / "kawpow";
+}
+
+fs::path GetKawpowCachePath(int nEpoch)
+{
+    return GetKawpowCacheDir() / strprintf("epoch%05d.dat", nEpoch);
+}
+
+void ComputeChecksum(const ethash::epoch_context& context, unsigned char* checksum)
+{
+    CSHA256()
+        .Write((const unsigned char*)context.light_cache, ethash::get_light_cache_size(context.light_cache_num_items))
+        .Write((const unsigned char*)context.l1_cache, progpow::l1_cache_size)
+        .Finalize(checksum);
+}
+
+/** Remove the cache files beyond KAWPOW_CACHE_MAX_FILES, keeping the newest epochs and nEpochKeep. */
+void PruneKawpowCache(int nEpochKeep)
+{
+    std::vector<std::pair<int, fs::path>> vFiles;
+    try {
+        for (fs::directory_iterator it(GetKawpowCacheDir()); it != fs::directory_iterator(); ++it) {
+            int nEpoch;
+            if (fs::is_regular_file(*it) && sscanf(it->path().filename().string().c_str(), "epoch%d.dat", &nEpoch) == 1 && nEpoch != nEpochKeep)
+                vFiles.emplace_back(nEpoch, it->path());
+        }
+        std::sort(vFiles.rbegin(), vFiles.rend());
+        for (size_t i = KAWPOW_CACHE_MAX_FILES - 1; i < vFiles.size(); i++)
+            fs::remove(vFiles[i].second);
+    } catch (const fs::filesystem_error& e) {
+        LogPrintf("%s: %s\n", __func__, e.what());
+    }
+}
+
+void StoreEpochContext(const ethash::epoch_context& context)
+{
+    KawpowCacheFileHeader header = {};
+    memcpy(header.magic, KAWPOW_CACHE_MAGIC, sizeof(header.magic));
+    header.nEpoch = context.epoch_number;
+    header.nLightCacheItems = context.light_cache_num_items;
+    header.nL1CacheSize = progpow::l1_cache_size;
+    ComputeChecksum(context, header.checksum);
+
+    TryCreateDirectories(GetKawpowCacheDir());
+    fs::path path = GetKawpowCachePath(context.epoch_number);
+    fs::path pathTmp = path;
+    pathTmp += ".tmp";
+    FILE* file = fsbridge::fopen(pathTmp, "wb");
+    if (!file) {
+        LogPrintf("%s: Failed to open file %s\n", __func__, pathTmp.string());
+        return;
+    }
+    bool fOk = fwrite(&header, sizeof(header), 1, file) == 1 &&
+               fwrite(context.light_cache, ethash::get_light_cache_size(context.light_cache_num_items), 1, file) == 1 &&
+               fwrite(context.l1_cache, progpow::l1_cache_size, 1, file) == 1;
+    if (fOk)
+        FileCommit(file);
+    fclose(file);
+    if (!fOk || !RenameOver(pathTmp, path)) {
+        LogPrintf("%s: Failed to write %s\n", __func__, path.string());
+        fs::remove(pathTmp);
+        return;
+    }
+    LogPrintf("Stored KAWPOW epoch %d cache in %s\n", context.epoch_number, path.string());
+
+    PruneKawpowCache(context.epoch_number);
+}
+
+std::shared_ptr<ethash::epoch_context> LoadEpochContext(int nEpoch)
+{
+#ifdef WIN32
+    return nullptr;
+#else
+    fs::path path = GetKawpowCachePath(nEpoch);
+    int fd = open(path.string().c_str(), O_RDONLY);
+    if (fd < 0)
+        return nullptr;
+
+    const int nLightCacheItems = ethash::calculate_light_cache_num_items(nEpoch);
+    const size_t nLightCacheSize = ethash::get_light_cache_size(nLightCacheItems);
+    const size_t nSize = sizeof(KawpowCacheFileHeader) + nLightCacheSize + progpow::l1_cache_size;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size != nSize) {
+        close(fd);
+        LogPrintf("%s: Unexpected size of %s, ignoring it\n", __func__, path.string());
+        return nullptr;
+    }
+    void* pmap = mmap(nullptr, nSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (pmap == MAP_FAILED) {
+        LogPrintf("%s: Failed to map %s\n", __func__, path.string());
+        return nullptr;
+    }
+
+    const unsigned char* pdata = static_cast<const unsigned char*>(pmap);
+    const KawpowCacheFileHeader* pheader = reinterpret_cast<const KawpowCacheFileHeader*>(pdata);
+    std::shared_ptr<ethash::epoch_context> context(
+        new ethash::epoch_context{
+            nEpoch,
+            nLightCacheItems,
+            reinterpret_cast<const ethash::hash512*>(pdata + sizeof(KawpowCacheFileHeader)),
+            reinterpret_cast<const uint32_t*>(pdata + sizeof(KawpowCacheFileHeader) + nLightCacheSize),
+            ethash::calculate_full_dataset_num_items(nEpoch)},
+        [pmap, nSize](ethash::epoch_context* p) {
+            delete p;
+            munmap(pmap, nSize);
+        });
+
+    unsigned char checksum[CSHA256::OUTPUT_SIZE];
+    ComputeChecksum(*context, checksum);
+    if (memcmp(pheader->magic, KAWPOW_CACHE_MAGIC, sizeof(pheader->magic)) != 0 || pheader->nEpoch != nEpoch ||
+        pheader->nLightCacheItems != nLightCacheItems || pheader->nL1CacheSize != progpow::l1_cache_size ||
+        memcmp(pheader->checksum, checksum, sizeof(checksum)) != 0) {
+        LogPrintf("%s: %s is corrupted, ignoring it\n", __func__, path.string());
+        return nullptr;
+    }
+
+    LogPrintf("Loaded KAWPOW epoch %d cache from %s\n", nEpoch, path.string());
+    return context;
+#endif
+}
+
+void ThreadKawpowPrebuild()
+{
+    RenameThread("nrgc-kawpow");
+    while (true) {
+        int nEpoch;
+        {
+            boost::unique_lock<boost::mutex> lock(csPrebuild);
+            while (setPrebuildEpochs.empty())
+                condPrebuild.wait(lock);
+            nEpoch = *setPrebuildEpochs.begin();
+        }
+
+        int64_t nStart = GetTimeMillis();
+        ethash::prebuild_global_epoch_context(nEpoch);
+        LogPrint(BCLog::BENCH, "Prebuilt KAWPOW epoch %d context: %dms\n", nEpoch, GetTimeMillis() - nStart);
+
+        {
+            boost::unique_lock<boost::mutex> lock(csPrebuild);
+            setPrebuildEpochs.erase(nEpoch);
+        }
+        boost::this_thread::interruption_point();
+    }
+}
+
+class CKawpowEpochPrebuilder : public CValidationInterface
+{
+protected:
+    void UpdatedBlockTip(const CBlockIndex* pindexNew, const CBlockIndex* pindexFork, bool fInitialDownload) override
+    {
+        if (pindexNew->nTime >= nKAWPOWActivationTime)
+            PrebuildKawpowEpochContexts(pindexNew->nHeight);
+    }
+};
+
+std::unique_ptr<CKawpowEpochPrebuilder> pkawpowPrebuilder;
+
+} // namespace
+
+void PrebuildKawpowEpochContext(int nEpoch)
+{
+    // Nothing to do if the context is already built
+    if (ethash::try_get_global_epoch_context(nEpoch))
+        return;
+
+    {
+        boost::unique_lock<boost::mutex> lock(csPrebuild);
+        setPrebuildEpochs.insert(nEpoch);
+    }
+    condPrebuild.notify_one();
+}
+
+void PrebuildKawpowEpochContexts(int nHeight)
+{
+    PrebuildKawpowEpochContext(ethash::get_epoch_number(nHeight));
+    if (ethash::get_epoch_number(nHeight + KAWPOW_PREBUILD_BLOCKS) != ethash::get_epoch_number(nHeight))
+        PrebuildKawpowEpochContext(ethash::get_epoch_number(nHeight + KAWPOW_PREBUILD_BLOCKS));
+}
+
+void StartKawpowEpochCache(boost::thread_group& threadGroup, bool fPersist)
+{
+    if (fPersist)
+        ethash::set_global_epoch_context_storage(LoadEpochContext, StoreEpochContext);
+
+    threadGroup.create_thread(&ThreadKawpowPrebuild);
+
+    pkawpowPrebuilder.reset(new CKawpowEpochPrebuilder());
+    RegisterValidationInterface(pkawpowPrebuilder.get());
+}
+
+void StopKawpowEpochCache()
+{
+    if (pkawpowPrebuilder) {
+        UnregisterValidationInterface(pkawpowPrebuilder.get());
+        pkawpowPrebuilder.reset();
+    }
+}
@@ -0,0 +1,37 @@
+// Copyright (c) 2023-2024 The Nrgc Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef NRGC_KAWPOWCACHE_H
+#define NRGC_KAWPOWCACHE_H
+
+namespace boost
+{
+    class thread_group;
+} // namespace boost
+
+/** Default for -kawpowcache */
+static const bool DEFAULT_KAWPOW_CACHE = true;
+/** How many blocks before an epoch boundary the context of the next epoch is prebuilt */
+static const int KAWPOW_PREBUILD_BLOCKS = 100;
+/** Maximum number of epoch cache files kept under <datadir>/kawpow */
+static const unsigned int KAWPOW_CACHE_MAX_FILES = 3;
+
+/**
+ * Start the thread that builds KAWPOW epoch contexts in the background, and prebuild
+ * the contexts needed around the current tip. With fPersist, built contexts are also
+ * written to <datadir>/kawpow and memory mapped from there on the next start instead
+ * of being generated again.
+ */
+void StartKawpowEpochCache(boost::thread_group& threadGroup, bool fPersist);
+
+/** Stop following the block tip. The prebuild thread is stopped with threadGroup. */
+void StopKawpowEpochCache();
+
+/** Queue a background build of the context of an epoch. */
+void PrebuildKawpowEpochContext(int nEpoch);
+
+/** Queue the contexts needed at nHeight: its own epoch and, close to the boundary, the next one. */
+void PrebuildKawpowEpochContexts(int nHeight);
+
+#endif // NRGC_KAWPOWCACHE_H
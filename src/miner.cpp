@@ -16,6 +16,7 @@
 #include "consensus/tx_verify.h"
 #include "consensus/merkle.h"
 #include "consensus/validation.h"
+#include "core_memusage.h"
 #include "hash.h"
 #include "validation.h"
 #include "net.h"
@@ -30,12 +31,16 @@
 #include "utilmoneystr.h"
 #include "validationinterface.h"
 
+#include "crypto/ethash/include/ethash/progpow.hpp"
 #include "wallet/wallet.h"
 //#include "wallet/rpcwallet.h"
 
 
 #include <boost/thread.hpp>
 #include <algorithm>
+#include <atomic>
+#include <limits>
+#include <mutex>
 #include <queue>
 #include <utility>
 
@@ -54,9 +59,46 @@ extern std::vector<CWalletRef> vpwallets;
 
 uint64_t nLastBlockTx = 0;
 uint64_t nLastBlockWeight = 0;
-uint64_t nMiningTimeStart = 0;
-uint64_t nHashesPerSec = 0;
-uint64_t nHashesDone = 0;
+
+/** Nonces a mining thread tries between checks for a new tip, a stop request or a clock update */
+static const uint64_t MINER_NONCE_BATCH = 0x100;
+/** KAWPOW hashes from the light cache are much slower, so use smaller batches to keep the checks frequent */
+static const uint64_t MINER_NONCE_BATCH_LIGHT = 0x10;
+
+struct CMinerThreadCounters
+{
+    std::atomic<uint64_t> nHashesDone{0};
+    std::atomic<uint64_t> nHashesPerSec{0};
+    // Only touched by the mining thread itself
+    int64_t nRateStart{0};
+    uint64_t nRateHashes{0};
+
+    void AddHashes(uint64_t nHashes)
+    {
+        nHashesDone += nHashes;
+        nRateHashes += nHashes;
+        int64_t nNow = GetTimeMicros();
+        if (nRateStart == 0) {
+            nRateStart = nNow;
+        } else if (nNow - nRateStart >= 1000000) {
+            nHashesPerSec = nRateHashes * 1000000 / (nNow - nRateStart);
+            nRateStart = nNow;
+            nRateHashes = 0;
+        }
+    }
+};
+
+static std::mutex cs_minerThreadCounters;
+static std::vector<std::shared_ptr<CMinerThreadCounters>> vMinerThreadCounters;
+
+std::vector<CMinerThreadStats> GetMinerThreadStats()
+{
+    std::lock_guard<std::mutex> lock(cs_minerThreadCounters);
+    std::vector<CMinerThreadStats> vStats;
+    for (const auto& counters : vMinerThreadCounters)
+        vStats.push_back({counters->nHashesDone.load(), counters->nHashesPerSec.load()});
+    return vStats;
+}
 
 
 int64_t UpdateTime(CBlockHeader* pblock, const Consensus::Params& consensusParams, const CBlockIndex* pindexPrev)
@@ -120,6 +162,73 @@ void BlockAssembler::resetBlock()
     nFees = 0;
 }
 
+/** How long CreateNewBlock keeps adding to the last template before it selects all transactions again */
+static const int64_t MAX_TEMPLATE_REUSE_TIME = 30;
+
+/**
+ * The transactions of the last template that passed TestBlockValidity and the context it was built in. While that
+ * context doesn't change, the transactions are still valid in the same order, so the next template starts with them
+ * and only selects packages for the space left. Their asset checks can't give a different result either, so
+ * TestBlockValidity skips them. Guarded by cs_main.
+ */
+struct CLastTemplate
+{
+    uint256 hashPrevBlock;
+    int nHeight = 0;
+    int64_t nLockTimeCutoff = 0;
+    bool fIncludeWitness = false;
+    unsigned int nBlockMaxWeight = 0;
+    CFeeRate blockMinFeeRate;
+    int64_t nTimeFirstBuilt = 0;
+    std::vector<uint256> vTxHashes;
+};
+
+static CLastTemplate lastTemplate;
+
+unsigned int BlockAssembler::AddLastTemplateTxs(const CBlockIndex* pindexPrev)
+{
+    AssertLockHeld(cs_main);
+    AssertLockHeld(mempool.cs);
+
+    if (lastTemplate.hashPrevBlock != pindexPrev->GetBlockHash() || lastTemplate.nHeight != nHeight ||
+            lastTemplate.nLockTimeCutoff != nLockTimeCutoff || lastTemplate.fIncludeWitness != fIncludeWitness ||
+            lastTemplate.nBlockMaxWeight != nBlockMaxWeight || lastTemplate.blockMinFeeRate != blockMinFeeRate ||
+            GetTime() - lastTemplate.nTimeFirstBuilt > MAX_TEMPLATE_REUSE_TIME)
+        return 0;
+
+    // A transaction that left the mempool may have been replaced by a conflicting one, so start over without it
+    std::vector<CTxMemPool::txiter> vEntries;
+    vEntries.reserve(lastTemplate.vTxHashes.size());
+    for (const uint256& hash : lastTemplate.vTxHashes) {
+        CTxMemPool::txiter it = mempool.mapTx.find(hash);
+        if (it == mempool.mapTx.end())
+            return 0;
+        vEntries.push_back(it);
+    }
+
+    for (CTxMemPool::txiter it : vEntries)
+        AddToBlock(it);
+    return vEntries.size();
+}
+
+void BlockAssembler::SetLastTemplateTxs(const CBlockIndex* pindexPrev, unsigned int nLastTemplateTxs)
+{
+    AssertLockHeld(cs_main);
+
+    if (nLastTemplateTxs == 0)
+        lastTemplate.nTimeFirstBuilt = GetTime();
+
+    lastTemplate.hashPrevBlock = pindexPrev->GetBlockHash();
+    lastTemplate.nHeight = nHeight;
+    lastTemplate.nLockTimeCutoff = nLockTimeCutoff;
+    lastTemplate.fIncludeWitness = fIncludeWitness;
+    lastTemplate.nBlockMaxWeight = nBlockMaxWeight;
+    lastTemplate.blockMinFeeRate = blockMinFeeRate;
+    lastTemplate.vTxHashes.clear();
+    for (size_t i = 1; i < pblock->vtx.size(); i++)
+        lastTemplate.vTxHashes.push_back(pblock->vtx[i]->GetHash());
+}
+
 std::unique_ptr<CBlockTemplate> BlockAssembler::CreateNewBlock(const CScript& scriptPubKeyIn, bool fMineWitnessTx)
 {
     int64_t nTimeStart = GetTimeMicros();
@@ -163,6 +272,8 @@ std::unique_ptr<CBlockTemplate> BlockAssembler::CreateNewBlock(const CScript& sc
     // transaction (which in most cases can be a no-op).
     fIncludeWitness = IsWitnessEnabled(pindexPrev, chainparams.GetConsensus()) && fMineWitnessTx;
 
+    unsigned int nLastTemplateTxs = AddLastTemplateTxs(pindexPrev);
+
     int nPackagesSelected = 0;
     int nDescendantsUpdated = 0;
     addPackageTxs(nPackagesSelected, nDescendantsUpdated);
@@ -220,7 +331,8 @@ std::unique_ptr<CBlockTemplate> BlockAssembler::CreateNewBlock(const CScript& sc
     pblocktemplate->vTxSigOpsCost[0] = WITNESS_SCALE_FACTOR * GetLegacySigOpCount(*pblock->vtx[0]);
 
     CValidationState state;
-    if (!TestBlockValidity(state, chainparams, *pblock, pindexPrev, false, false)) {
+    if (!TestBlockValidity(state, chainparams, *pblock, pindexPrev, false, false, nLastTemplateTxs)) {
+        lastTemplate.vTxHashes.clear();
         if (state.IsTransactionError()) {
             if (gArgs.GetBoolArg("-autofixmempool", false)) {
                 {
@@ -246,9 +358,10 @@ std::unique_ptr<CBlockTemplate> BlockAssembler::CreateNewBlock(const CScript& sc
         }
         throw std::runtime_error(strprintf("%s: TestBlockValidity failed: %s", __func__, FormatStateMessage(state)));
     }
+    SetLastTemplateTxs(pindexPrev, nLastTemplateTxs);
     int64_t nTime2 = GetTimeMicros();
 
-    LogPrint(BCLog::BENCH, "CreateNewBlock() packages: %.2fms (%d packages, %d updated descendants), validity: %.2fms (total %.2fms)\n", 0.001 * (nTime1 - nTimeStart), nPackagesSelected, nDescendantsUpdated, 0.001 * (nTime2 - nTime1), 0.001 * (nTime2 - nTimeStart));
+    LogPrint(BCLog::BENCH, "CreateNewBlock() packages: %.2fms (%u reused txs, %d packages, %d updated descendants), validity: %.2fms (total %.2fms)\n", 0.001 * (nTime1 - nTimeStart), nLastTemplateTxs, nPackagesSelected, nDescendantsUpdated, 0.001 * (nTime2 - nTime1), 0.001 * (nTime2 - nTimeStart));
 
     return std::move(pblocktemplate);
 }
@@ -548,6 +661,114 @@ static bool ProcessBlockFound(const CBlock* pblock, const CChainParams& chainpar
     return true;
 }
 
+CKAWPOWTemplateStore kawpowTemplateStore;
+
+void CKAWPOWTemplateStore::Add(const uint256& header_hash, std::shared_ptr<const CBlock> block)
+{
+    LOCK(cs);
+    auto it = mapTemplates.find(header_hash);
+    if (it != mapTemplates.end())
+        Erase(it->second);
+
+    if (nMaxTemplates == 0)
+        return;
+    while (mapTemplates.size() >= nMaxTemplates) {
+        Erase(std::prev(lruList.end()));
+        nEvictions++;
+    }
+
+    size_t nUsage = RecursiveDynamicUsage(*block);
+    lruList.push_front({header_hash, std::move(block), nUsage});
+    mapTemplates.emplace(header_hash, lruList.begin());
+    nMemoryUsage += nUsage;
+}
+
+std::shared_ptr<const CBlock> CKAWPOWTemplateStore::Get(const uint256& header_hash)
+{
+    LOCK(cs);
+    auto it = mapTemplates.find(header_hash);
+    if (it == mapTemplates.end()) {
+        nMisses++;
+        return nullptr;
+    }
+    nHits++;
+    lruList.splice(lruList.begin(), lruList, it->second);
+    return it->second->block;
+}
+
+bool CKAWPOWTemplateStore::Exists(const uint256& header_hash) const
+{
+    LOCK(cs);
+    return mapTemplates.count(header_hash) > 0;
+}
+
+void CKAWPOWTemplateStore::RemoveBelowHeight(uint32_t nHeight)
+{
+    LOCK(cs);
+    for (auto it = lruList.begin(); it != lruList.end(); ) {
+        if (it->block->nHeight < nHeight)
+            Erase(it++);
+        else
+            ++it;
+    }
+}
+
+void CKAWPOWTemplateStore::Clear()
+{
+    LOCK(cs);
+    lruList.clear();
+    mapTemplates.clear();
+    nMemoryUsage = 0;
+}
+
+CKAWPOWTemplateStore::Stats CKAWPOWTemplateStore::GetStats() const
+{
+    LOCK(cs);
+    return {mapTemplates.size(), nMemoryUsage, nHits, nMisses, nEvictions};
+}
+
+void CKAWPOWTemplateStore::Erase(std::list<Entry>::iterator it)
+{
+    nMemoryUsage -= it->nMemoryUsage;
+    mapTemplates.erase(it->header_hash);
+    lruList.erase(it);
+}
+
+bool ScanBlockNonces(CBlock* pblock, const arith_uint256& hashTarget, uint64_t nNonceStart, uint64_t nNonceCount, uint64_t& nHashesDone, bool fFullDataset)
+{
+    nHashesDone = 0;
+    if (pblock->nTime < nKAWPOWActivationTime) {
+        for (uint64_t nNonce = nNonceStart; nNonce < nNonceStart + nNonceCount; nNonce++) {
+            pblock->nNonce = (uint32_t)nNonce;
+            nHashesDone++;
+            if (UintToArith256(pblock->GetHash()) <= hashTarget)
+                return true;
+        }
+        return false;
+    }
+
+    // Only the nonce changes between the hashes, so hash the rest of the header once
+    const ethash::hash256 header_hash = ToEthashHash(pblock->GetKAWPOWHeaderHash());
+    const ethash::hash256 boundary = ToEthashHash(ArithToUint256(hashTarget));
+    const int epoch_number = ethash::get_epoch_number(pblock->nHeight);
+
+    progpow::search_result result;
+    if (fFullDataset)
+        result = progpow::search(ethash::get_global_epoch_context_full(epoch_number), pblock->nHeight, header_hash, boundary, nNonceStart, nNonceCount);
+    else
+        result = progpow::search_light(ethash::get_global_epoch_context(epoch_number), pblock->nHeight, header_hash, boundary, nNonceStart, nNonceCount);
+
+    if (!result.solution_found) {
+        nHashesDone = nNonceCount;
+        return false;
+    }
+
+    nHashesDone = result.nonce - nNonceStart + 1;
+    pblock->nNonce64 = result.nonce;
+    pblock->mix_hash = FromEthashHash(result.mix_hash);
+    return true;
+}
+
 CWallet *GetFirstWallet() {
 #ifdef ENABLE_WALLET
     while(vpwallets.size() == 0){
@@ -561,9 +782,9 @@ CWallet *GetFirstWallet() {
     return(NULL);
 }
 
-void static NrgcMiner(const CChainParams& chainparams)
+void static NrgcMiner(const CChainParams& chainparams, int nThread, int nThreads, std::shared_ptr<CMinerThreadCounters> counters)
 {
-    LogPrintf("NrgcMiner -- started\n");
+    LogPrintf("NrgcMiner -- thread %d started\n", nThread);
     SetThreadPriority(THREAD_PRIORITY_LOWEST);
     RenameThread("nrgc-miner");
 
@@ -653,38 +874,43 @@ void static NrgcMiner(const CChainParams& chainparams)
             //
             int64_t nStart = GetTime();
             arith_uint256 hashTarget = arith_uint256().SetCompact(pblock->nBits);
+
+            // Every thread mines the same template, so each searches its own slice of the nonces
+            bool fKAWPOW = pblock->nTime >= nKAWPOWActivationTime;
+            uint64_t nNonceSpace = fKAWPOW ? std::numeric_limits<uint64_t>::max() : 0xffff0000;
+            uint64_t nNonce = nNonceSpace / nThreads * nThread;
+            uint64_t nNonceEnd = nThread == nThreads - 1 ? nNonceSpace : nNonceSpace / nThreads * (nThread + 1);
+
+            // Hash against the full dataset only if it fits in the memory the user allows for it
+            bool fFullDataset = false;
+            if (fKAWPOW) {
+                const ethash::epoch_context& context = ethash::get_global_epoch_context(ethash::get_epoch_number(pblock->nHeight));
+                uint64_t nDatasetSize = ethash::get_full_dataset_size(context.full_dataset_num_items);
+                fFullDataset = nDatasetSize <= (uint64_t)std::max<int64_t>(0, gArgs.GetArg("-minerdagmemory", DEFAULT_MINER_DAG_MEMORY)) * 1024 * 1024;
+            }
+            uint64_t nBatch = fKAWPOW && !fFullDataset ? MINER_NONCE_BATCH_LIGHT : MINER_NONCE_BATCH;
+
             while (true)
             {
-
-                uint256 hash;
-                uint256 mix_hash;
-                while (true)
+                uint64_t nHashes = 0;
+                bool fFound = ScanBlockNonces(pblock, hashTarget, nNonce, std::min(nBatch, nNonceEnd - nNonce), nHashes, fFullDataset);
+                counters->AddHashes(nHashes);
+                nNonce += nHashes;
+                if (fFound)
                 {
-                    hash = pblock->GetHashFull(mix_hash);
-                    if (UintToArith256(hash) <= hashTarget)
-                    {
-                        pblock->mix_hash = mix_hash;
-                        // Found a solution
-                        SetThreadPriority(THREAD_PRIORITY_NORMAL);
-                        LogPrintf("NrgcMiner:\n  proof-of-work found\n  hash: %s\n  target: %s\n", hash.GetHex(), hashTarget.GetHex());
-                        ProcessBlockFound(pblock, chainparams);
-                        SetThreadPriority(THREAD_PRIORITY_LOWEST);
-                        coinbaseScript->KeepScript();
-
-                        // In regression test mode, stop mining after a block is found. This
-                        // allows developers to controllably generate a block on demand.
-                        if (chainparams.MineBlocksOnDemand())
-                            throw boost::thread_interrupted();
+                    // Found a solution
+                    SetThreadPriority(THREAD_PRIORITY_NORMAL);
+                    LogPrintf("NrgcMiner:\n  proof-of-work found\n  hash: %s\n  target: %s\n", pblock->GetHash().GetHex(), hashTarget.GetHex());
+                    ProcessBlockFound(pblock, chainparams);
+                    SetThreadPriority(THREAD_PRIORITY_LOWEST);
+                    coinbaseScript->KeepScript();
+
+                    // In regression test mode, stop mining after a block is found. This
+                    // allows developers to controllably generate a block on demand.
+                    if (chainparams.MineBlocksOnDemand())
+                        throw boost::thread_interrupted();
 
-                        break;
-                    }
-                    pblock->nNonce += 1;
-                    nHashesDone += 1;
-                    if (nHashesDone % 500000 == 0) {   //Calculate hashing speed
-                        nHashesPerSec = nHashesDone / (((GetTimeMicros() - nMiningTimeStart) / 1000000) + 1);
-                    } 
-                    if ((pblock->nNonce & 0xFF) == 0)
-                        break;
+                    break;
                 }
 
                 // Check for stop or if block needs to be rebuilt
@@ -692,7 +918,7 @@ void static NrgcMiner(const CChainParams& chainparams)
                 // Regtest mode doesn't require peers
                 //if (vNodes.empty() && chainparams.MiningRequiresPeers())
                 //    break;
-                if (pblock->nNonce >= 0xffff0000)
+                if (nNonce >= nNonceEnd)
                     break;
                 if (mempool.GetTransactionsUpdated() != nTransactionsUpdatedLast && GetTime() - nStart > 60)
                     break;
@@ -739,18 +965,21 @@ int GenerateNrgcs(bool fGenerate, int nThreads, const CChainParams& chainparams)
         minerThreads = NULL;
     }
 
+    {
+        std::lock_guard<std::mutex> lock(cs_minerThreadCounters);
+        vMinerThreadCounters.clear();
+    }
+
     if (nThreads == 0 || !fGenerate)
         return numCores;
 
     minerThreads = new boost::thread_group();
-    
-    //Reset metrics
-    nMiningTimeStart = GetTimeMicros();
-    nHashesDone = 0;
-    nHashesPerSec = 0;
 
+    std::lock_guard<std::mutex> lock(cs_minerThreadCounters);
+    vMinerThreadCounters.clear();
     for (int i = 0; i < nThreads; i++){
-        minerThreads->create_thread(boost::bind(&NrgcMiner, boost::cref(chainparams)));
+        vMinerThreadCounters.push_back(std::make_shared<CMinerThreadCounters>());
+        minerThreads->create_thread(boost::bind(&NrgcMiner, boost::cref(chainparams), i, nThreads, vMinerThreadCounters.back()));
     }
 
     return(numCores);
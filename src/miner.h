@@ -9,13 +9,17 @@
 #define NRGC_MINER_H
 
 #include "primitives/block.h"
+#include "sync.h"
 #include "txmempool.h"
 
 #include <stdint.h>
+#include <list>
 #include <memory>
+#include <unordered_map>
 #include <boost/multi_index_container.hpp>
 #include <boost/multi_index/ordered_index.hpp>
 
+class arith_uint256;
 class CBlockIndex;
 class CChainParams;
 class CScript;
@@ -23,6 +27,10 @@ class CScript;
 namespace Consensus { struct Params; };
 
 static const bool DEFAULT_PRINTPRIORITY = false;
+/** Templates getblocktemplate keeps for KAWPOW miners to submit solutions against */
+static const size_t MAX_KAWPOW_TEMPLATES = 64;
+/** Default for -minerdagmemory, the MiB a miner may use for the full KAWPOW dataset (0 = hash from the light cache) */
+static const int64_t DEFAULT_MINER_DAG_MEMORY = 0;
 
 struct CBlockTemplate
 {
@@ -175,6 +183,11 @@ private:
     void resetBlock();
     /** Add a tx to the block */
     void AddToBlock(CTxMemPool::txiter iter);
+    /** Add the transactions of the last valid template if it was built for the same chain context and options.
+      * Returns how many were added. */
+    unsigned int AddLastTemplateTxs(const CBlockIndex* pindexPrev);
+    /** Remember the transactions of a template that passed TestBlockValidity */
+    void SetLastTemplateTxs(const CBlockIndex* pindexPrev, unsigned int nLastTemplateTxs);
 
     // Methods for how to add transactions to a block.
     /** Add transactions based on feerate including unconfirmed ancestors
@@ -203,6 +216,79 @@ private:
     int UpdatePackagesForAdded(const CTxMemPool::setEntries& alreadyAdded, indexed_modified_transaction_set &mapModifiedTx);
 };
 
+/**
+ * The block templates getblocktemplate handed out to KAWPOW miners, by KAWPOW header hash, so pprpcsb can find the block
+ * a solution belongs to. Templates are shared, not copied. The store holds at most nMaxTemplates, evicting the least
+ * recently used, and templates below a height can be dropped once the chain moved past it. It has its own lock, so a
+ * lookup doesn't wait for cs_main.
+ */
+class CKAWPOWTemplateStore
+{
+public:
+    struct Stats
+    {
+        size_t nTemplates;
+        size_t nMemoryUsage;
+        uint64_t nHits;
+        uint64_t nMisses;
+        uint64_t nEvictions;
+    };
+
+    explicit CKAWPOWTemplateStore(size_t nMaxTemplatesIn = MAX_KAWPOW_TEMPLATES) : nMaxTemplates(nMaxTemplatesIn) {}
+
+    void Add(const uint256& header_hash, std::shared_ptr<const CBlock> block);
+    /** The template of header_hash, or nullptr if it isn't (or no longer) stored */
+    std::shared_ptr<const CBlock> Get(const uint256& header_hash);
+    bool Exists(const uint256& header_hash) const;
+    /** Drop the templates for blocks below nHeight */
+    void RemoveBelowHeight(uint32_t nHeight);
+    void Clear();
+    Stats GetStats() const;
+
+private:
+    struct Entry
+    {
+        uint256 header_hash;
+        std::shared_ptr<const CBlock> block;
+        size_t nMemoryUsage;
+    };
+    struct HeaderHasher
+    {
+        size_t operator()(const uint256& hash) const { return hash.GetCheapHash(); }
+    };
+
+    void Erase(std::list<Entry>::iterator it);
+
+    mutable CCriticalSection cs;
+    const size_t nMaxTemplates;
+    // Most recently used first
+    std::list<Entry> lruList;
+    std::unordered_map<uint256, std::list<Entry>::iterator, HeaderHasher> mapTemplates;
+    size_t nMemoryUsage = 0;
+    uint64_t nHits = 0;
+    uint64_t nMisses = 0;
+    uint64_t nEvictions = 0;
+};
+
+extern CKAWPOWTemplateStore kawpowTemplateStore;
+
+/** Hash counters of one mining thread */
+struct CMinerThreadStats
+{
+    uint64_t nHashesDone;
+    uint64_t nHashesPerSec;
+};
+
+/**
+ * Try nNonceCount nonces of pblock starting at nNonceStart, using nNonce64 for KAWPOW blocks and nNonce before.
+ * The KAWPOW header hash is computed once for all of them. On success pblock holds the winning nonce (and mix
+ * hash). nHashesDone is set to the number of nonces tried, including the winning one.
+ */
+bool ScanBlockNonces(CBlock* pblock, const arith_uint256& hashTarget, uint64_t nNonceStart, uint64_t nNonceCount, uint64_t& nHashesDone, bool fFullDataset = false);
+
+/** Snapshot of the counters of the running mining threads, in thread order */
+std::vector<CMinerThreadStats> GetMinerThreadStats();
+
 /** Modify the extranonce in a block */
 void IncrementExtraNonce(CBlock* pblock, const CBlockIndex* pindexPrev, unsigned int& nExtraNonce);
 int64_t UpdateTime(CBlockHeader* pblock, const Consensus::Params& consensusParams, const CBlockIndex* pindexPrev);
@@ -633,6 +633,11 @@ public:
 
     std::deque<CInv> vRecvGetData;
     std::deque<CInvAsset> vRecvAssetGetData;
+    // getassetbtch requests waiting to be answered, by request id
+    std::deque<std::pair<uint32_t, std::vector<CInvAsset>>> vRecvAssetBatches;
+    // Asset lookups the peer may still make before it has to wait, refilled over time
+    double dAssetLookupTokens{0};
+    int64_t nAssetLookupTokensTime{0};
     uint64_t nRecvBytes;
     std::atomic<int> nRecvVersion;
 
@@ -692,6 +697,9 @@ public:
 
     bool fGetAssetData;
     std::set<std::string> setInventoryAssetsSend;
+    // getassetbtch requests sent to the peer that it hasn't answered yet, request id -> time sent in microseconds
+    uint32_t nNextAssetBatchId{0};
+    std::map<uint32_t, int64_t> mapAssetBatchesInFlight;
 
     // inventory based relay
     CRollingBloomFilter filterInventoryKnown;
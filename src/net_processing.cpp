@@ -1194,67 +1194,72 @@ void static ProcessGetData(CNode* pfrom, const Consensus::Params& consensusParam
 void static ProcessAssetGetData(CNode* pfrom, const Consensus::Params& consensusParams, CConnman* connman, const std::atomic<bool>& interruptMsgProc)
 {
     std::deque<CInvAsset>::iterator it = pfrom->vRecvAssetGetData.begin();
-    std::vector<CInvAsset> vNotFound;
     const CNetMsgMaker msgMaker(pfrom->GetSendVersion());
-    LOCK(cs_main);
+    std::shared_ptr<const CAssetMetaDataSnapshot> snapshot = GetAssetMetaDataSnapshot();
 
     while (it != pfrom->vRecvAssetGetData.end()) {
         // Don't bother if send buffer is too full to respond anyway
         if (pfrom->fPauseSend)
             break;
 
-        const CInvAsset &inv = *it;
-        {
-            if (interruptMsgProc)
-                return;
-
-            it++;
-
-            if (!IsAssetNameValid(inv.name)) {
-                vNotFound.push_back(inv);
-                continue;
-            }
+        if (interruptMsgProc)
+            return;
 
-            UNUSED_VAR bool push = false;
-            auto currentActiveAssetCache = GetCurrentAssetCache();
-            if (currentActiveAssetCache) {
-                CNewAsset asset;
-                int height;
-                uint256 hash;
-                if (currentActiveAssetCache->GetAssetMetaDataIfExists(inv.name, asset, height, hash)) {
-                    auto data = CDatabasedAssetData(asset, height, hash);
-                    passetsCache->Put(inv.name, data);
-                    connman->PushMessage(pfrom, msgMaker.Make(NetMsgType::ASSETDATA, SerializedAssetData(data)));
-                    push = true;
-                } else {
-                    CDatabasedAssetData data;
-                    data.asset.strName = "_NF"; // Return _NF for NOT Found
-                    connman->PushMessage(pfrom, msgMaker.Make(NetMsgType::ASSETDATA, SerializedAssetData(data)));
-                }
-            }
+        const CInvAsset &inv = *it;
+        it++;
 
-//            if (!push) {
-//                vNotFound.push_back(inv);
-//            }
+        // Names that aren't valid are never in the snapshot and get _NF like any other unknown asset
+        CDatabasedAssetData data;
+        if (!snapshot->GetAssetMetaData(inv.name, data)) {
+            data.SetNull();
+            data.asset.strName = "_NF"; // Return _NF for NOT Found
         }
+        connman->PushMessage(pfrom, msgMaker.Make(NetMsgType::ASSETDATA, SerializedAssetData(data)));
     }
 
     pfrom->vRecvAssetGetData.erase(pfrom->vRecvAssetGetData.begin(), it);
+}
+
+void static ProcessAssetBatches(CNode* pfrom, CConnman* connman, const std::atomic<bool>& interruptMsgProc)
+{
+    // Refill the peer's lookup tokens for the time that passed since the last batch
+    int64_t nNow = GetTimeMicros();
+    pfrom->dAssetLookupTokens = std::min(MAX_ASSET_LOOKUP_BURST, pfrom->dAssetLookupTokens + (nNow - pfrom->nAssetLookupTokensTime) * MAX_ASSET_LOOKUPS_PER_SECOND / 1000000.0);
+    pfrom->nAssetLookupTokensTime = nNow;
 
-//    if (!vNotFound.empty()) {
-//        // Let the peer know that we didn't find what it asked for, so it doesn't
-//        // have to wait around forever. Currently only SPV clients actually care
-//        // about this message: it's needed when they are recursively walking the
-//        // dependencies of relevant unconfirmed transactions. SPV clients want to
-//        // do that because they want to know about (and store and rebroadcast and
-//        // risk analyze) the dependencies of transactions relevant to them, without
-//        // having to download the entire memory pool.
-//        for (auto assetinv : vNotFound) {
-//            CDatabasedAssetData data;
-//            data.asset.strName = "_NF"; // Return _NF for NOT Found
-//            connman->PushMessage(pfrom, msgMaker.Make(NetMsgType::ASSETDATA, SerializedAssetData(data)));
-//        }
-//    }
+    const CNetMsgMaker msgMaker(pfrom->GetSendVersion());
+    std::shared_ptr<const CAssetMetaDataSnapshot> snapshot;
+
+    while (!pfrom->vRecvAssetBatches.empty()) {
+        // Don't bother if send buffer is too full to respond anyway
+        if (pfrom->fPauseSend || interruptMsgProc)
+            break;
+
+        const std::pair<uint32_t, std::vector<CInvAsset>>& request = pfrom->vRecvAssetBatches.front();
+        // The rest waits in the queue until the peer has earned enough tokens, ProcessMessages comes back for it
+        if (pfrom->dAssetLookupTokens < request.second.size())
+            break;
+        pfrom->dAssetLookupTokens -= request.second.size();
+
+        if (!snapshot)
+            snapshot = GetAssetMetaDataSnapshot();
+
+        std::vector<SerializedAssetData> vFound;
+        std::vector<CInvAsset> vNotFound;
+        vFound.reserve(request.second.size());
+        for (const CInvAsset& inv : request.second) {
+            // Names that aren't valid are never in the snapshot, so there's no need to run them through IsAssetNameValid
+            CDatabasedAssetData data;
+            if (snapshot->GetAssetMetaData(inv.name, data))
+                vFound.emplace_back(data);
+            else
+                vNotFound.push_back(inv);
+        }
+
+        LogPrint(BCLog::NET, "sending assetbatch %u (%u found, %u not found) peer=%d\n", request.first, vFound.size(), vNotFound.size(), pfrom->GetId());
+        connman->PushMessage(pfrom, msgMaker.Make(NetMsgType::ASSETBATCH, request.first, vFound, vNotFound));
+        pfrom->vRecvAssetBatches.pop_front();
+    }
 }
 
 uint32_t GetFetchFlags(CNode* pfrom) {
@@ -1292,6 +1297,10 @@ bool static ProcessHeadersMessage(CNode *pfrom, CConnman *connman, const std::ve
         return true;
     }
 
+    // Hash the whole batch once, before taking cs_main; the hashes are reused by ProcessNewBlockHeaders.
+    std::vector<uint256> vHeaderHashes;
+    GetBlockHeaderHashes(headers, vHeaderHashes);
+
     bool received_new_header = false;
     const CBlockIndex *pindexLast = nullptr;
     {
@@ -1310,14 +1319,14 @@ bool static ProcessHeadersMessage(CNode *pfrom, CConnman *connman, const std::ve
             nodestate->nUnconnectingHeaders++;
             connman->PushMessage(pfrom, msgMaker.Make(NetMsgType::GETHEADERS, chainActive.GetLocator(pindexBestHeader), uint256()));
             LogPrint(BCLog::NET, "received header %s: missing prev block %s, sending getheaders (%d) to end (peer=%d, nUnconnectingHeaders=%d)\n",
-                     headers[0].GetHash().ToString(),
+                     vHeaderHashes.front().ToString(),
                     headers[0].hashPrevBlock.ToString(),
                     pindexBestHeader->nHeight,
                     pfrom->GetId(), nodestate->nUnconnectingHeaders);
             // Set hashLastUnknownBlock for this peer, so that if we
             // eventually get the headers - even from a different peer -
             // we can use this peer to download.
-            UpdateBlockAvailability(pfrom->GetId(), headers.back().GetHash());
+            UpdateBlockAvailability(pfrom->GetId(), vHeaderHashes.back());
 
             if (nodestate->nUnconnectingHeaders % MAX_UNCONNECTING_HEADERS == 0) {
                 Misbehaving(pfrom->GetId(), 20);
@@ -1326,12 +1335,12 @@ bool static ProcessHeadersMessage(CNode *pfrom, CConnman *connman, const std::ve
         }
 
         uint256 hashLastBlock;
-        for (const CBlockHeader& header : headers) {
-            if (!hashLastBlock.IsNull() && header.hashPrevBlock != hashLastBlock) {
+        for (size_t i = 0; i < nCount; i++) {
+            if (!hashLastBlock.IsNull() && headers[i].hashPrevBlock != hashLastBlock) {
                 Misbehaving(pfrom->GetId(), 20);
                 return error("non-continuous headers sequence");
             }
-            hashLastBlock = header.GetHash();
+            hashLastBlock = vHeaderHashes[i];
         }
 
         // If we don't have the last header, then they'll have given us
@@ -1343,7 +1352,7 @@ bool static ProcessHeadersMessage(CNode *pfrom, CConnman *connman, const std::ve
 
     CValidationState state;
     CBlockHeader first_invalid_header;
-    if (!ProcessNewBlockHeaders(headers, state, chainparams, &pindexLast, &first_invalid_header)) {
+    if (!ProcessNewBlockHeaders(headers, state, chainparams, &pindexLast, &first_invalid_header, &vHeaderHashes)) {
         int nDoS;
         if (state.IsInvalid(nDoS)) {
             LOCK(cs_main);
@@ -1988,6 +1997,65 @@ bool static ProcessMessage(CNode* pfrom, const std::string& strCommand, CDataStr
         ProcessAssetGetData(pfrom, chainparams.GetConsensus(), connman, interruptMsgProc);
     }
 
+    else if (strCommand == NetMsgType::GETASSETBATCH)
+    {
+        if (IsInitialBlockDownload()) {
+            LogPrint(BCLog::NET, "Ignoring getassetbtch from peer=%d because node is in initial block download\n", pfrom->GetId());
+            return true;
+        }
+
+        uint32_t nRequestId;
+        std::vector<CInvAsset> vInvAsset;
+        vRecv >> nRequestId >> vInvAsset;
+
+        if (vInvAsset.size() > MAX_ASSET_INV_SZ)
+        {
+            LOCK(cs_main);
+            Misbehaving(pfrom->GetId(), 20);
+            return error("message getassetbtch size() = %u", vInvAsset.size());
+        }
+
+        for (const auto& item : vInvAsset) {
+            if (item.name.size() > MAX_ASSET_LENGTH) {
+                LOCK(cs_main);
+                Misbehaving(pfrom->GetId(), 100);
+                return error("message getassetbtch assetname size() = %u", item.name.size());
+            }
+        }
+
+        if (pfrom->vRecvAssetBatches.size() >= MAX_ASSET_BATCH_QUEUE) {
+            LOCK(cs_main);
+            Misbehaving(pfrom->GetId(), 20);
+            return error("message getassetbtch, peer=%d already has %u requests waiting", pfrom->GetId(), pfrom->vRecvAssetBatches.size());
+        }
+
+        LogPrint(BCLog::NET, "received getassetbtch %u (%u invassetsz) peer=%d\n", nRequestId, vInvAsset.size(), pfrom->GetId());
+
+        pfrom->vRecvAssetBatches.emplace_back(nRequestId, std::move(vInvAsset));
+        ProcessAssetBatches(pfrom, connman, interruptMsgProc);
+    }
+
+    else if (strCommand == NetMsgType::ASSETBATCH)
+    {
+        uint32_t nRequestId;
+        std::vector<SerializedAssetData> vFound;
+        std::vector<CInvAsset> vNotFound;
+        vRecv >> nRequestId >> vFound >> vNotFound;
+
+        if (!pfrom->mapAssetBatchesInFlight.erase(nRequestId)) {
+            LogPrint(BCLog::NET, "received unrequested assetbatch %u peer=%d\n", nRequestId, pfrom->GetId());
+            return true;
+        }
+
+        if (vFound.size() + vNotFound.size() > MAX_ASSET_INV_SZ) {
+            LOCK(cs_main);
+            Misbehaving(pfrom->GetId(), 20);
+            return error("message assetbatch size() = %u", vFound.size() + vNotFound.size());
+        }
+
+        LogPrint(BCLog::NET, "received assetbatch %u (%u found, %u not found) peer=%d\n", nRequestId, vFound.size(), vNotFound.size(), pfrom->GetId());
+    }
+
     else if (strCommand == NetMsgType::GETBLOCKS)
     {
         CBlockLocator locator;
@@ -2985,6 +3053,11 @@ bool PeerLogicValidation::ProcessMessages(CNode* pfrom, std::atomic<bool>& inter
     if (!pfrom->vRecvGetData.empty())
         ProcessGetData(pfrom, chainparams.GetConsensus(), connman, interruptMsgProc);
 
+    // Rate limited getassetbtch requests. These don't set fMoreWork, the message handler comes back within
+    // 100ms anyway and the tokens refill over time
+    if (!pfrom->vRecvAssetBatches.empty())
+        ProcessAssetBatches(pfrom, connman, interruptMsgProc);
+
     if (pfrom->fDisconnect)
         return false;
 
@@ -3319,10 +3392,43 @@ bool PeerLogicValidation::SendMessages(CNode* pto, std::atomic<bool>& interruptM
                 pto->vAddrToSend.shrink_to_fit();
         }
 
+        //
+        // Message: getassetbtch
+        //
+        if (pto->nVersion >= ASSETDATA_BATCH_VERSION && pto->fGetAssetData) {
+            LOCK(pto->cs_inventory);
+
+            // Give up on requests the peer didn't answer, so they don't block the pipeline forever
+            int64_t nNow = GetTimeMicros();
+            for (auto it = pto->mapAssetBatchesInFlight.begin(); it != pto->mapAssetBatchesInFlight.end();) {
+                if (nNow - it->second > ASSET_BATCH_TIMEOUT * 1000000) {
+                    LogPrint(BCLog::NET, "getassetbtch %u timed out, peer=%d\n", it->first, pto->GetId());
+                    it = pto->mapAssetBatchesInFlight.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+
+            // Keep up to MAX_ASSET_BATCHES_IN_FLIGHT requests in flight, the rest is sent as answers come in
+            auto itAsset = pto->setInventoryAssetsSend.begin();
+            while (itAsset != pto->setInventoryAssetsSend.end() && pto->mapAssetBatchesInFlight.size() < MAX_ASSET_BATCHES_IN_FLIGHT) {
+                std::vector<CInvAsset> vInvAssets;
+                vInvAssets.reserve(std::min<size_t>(pto->setInventoryAssetsSend.size(), MAX_ASSET_INV_SZ));
+                for (; itAsset != pto->setInventoryAssetsSend.end() && vInvAssets.size() < MAX_ASSET_INV_SZ; ++itAsset)
+                    vInvAssets.push_back(CInvAsset(*itAsset));
+
+                uint32_t nRequestId = pto->nNextAssetBatchId++;
+                pto->mapAssetBatchesInFlight.emplace(nRequestId, nNow);
+                connman->PushMessage(pto, msgMaker.Make(NetMsgType::GETASSETBATCH, nRequestId, vInvAssets));
+            }
+            pto->setInventoryAssetsSend.erase(pto->setInventoryAssetsSend.begin(), itAsset);
+            pto->fGetAssetData = !pto->setInventoryAssetsSend.empty();
+        }
+
         //
         // Message: getassetdata
         //
-        if (pto->nVersion >= ASSETDATA_VERSION && pto->fGetAssetData) {
+        if (pto->nVersion >= ASSETDATA_VERSION && pto->nVersion < ASSETDATA_BATCH_VERSION && pto->fGetAssetData) {
             LOCK(pto->cs_inventory);
 
             pto->fGetAssetData = false;
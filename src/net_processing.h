@@ -36,6 +36,16 @@ static constexpr int64_t STALE_CHECK_INTERVAL = 10 * 60; // 10 minutes
 static constexpr int64_t EXTRA_PEER_CHECK_INTERVAL = 45;
 /** Minimum time an outbound-peer-eviction candidate must be connected for, in order to evict, in seconds */
 static constexpr int64_t MINIMUM_CONNECT_TIME = 30;
+/** Asset metadata lookups a peer may make per second with getassetbtch */
+static constexpr double MAX_ASSET_LOOKUPS_PER_SECOND = 4096;
+/** Asset metadata lookups a peer may make at once after it has been quiet */
+static constexpr double MAX_ASSET_LOOKUP_BURST = 4 * 1024;
+/** getassetbtch requests a peer may have waiting for an answer before it's misbehaving */
+static constexpr size_t MAX_ASSET_BATCH_QUEUE = 16;
+/** getassetbtch requests we keep in flight to a peer */
+static constexpr size_t MAX_ASSET_BATCHES_IN_FLIGHT = 4;
+/** How long we wait for an assetbatch before sending the next getassetbtch instead, in seconds */
+static constexpr int64_t ASSET_BATCH_TIMEOUT = 60;
 
 class PeerLogicValidation final: public CValidationInterface, public NetEventsInterface {
 private:
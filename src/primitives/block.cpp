@@ -8,6 +8,7 @@
 #include "primitives/block.h"
 
 #include <hash.h>
+#include "algo/x16r_multi.h"
 #include "tinyformat.h"
 #include "utilstrencodings.h"
 #include "crypto/common.h"
@@ -36,16 +37,21 @@ void BlockNetwork::SetNetwork(const std::string& net)
     }
 }
 
+static bool IsX16RV2Time(uint32_t nTime)
+{
+    uint32_t nTimeToUse = MAINNET_X16RV2ACTIVATIONTIME;
+    if (bNetwork.fOnTestnet) {
+        nTimeToUse = TESTNET_X16RV2ACTIVATIONTIME;
+    } else if (bNetwork.fOnRegtest) {
+        nTimeToUse = REGTEST_X16RV2ACTIVATIONTIME;
+    }
+    return nTime >= nTimeToUse;
+}
+
 uint256 CBlockHeader::GetHash() const
 {
     if (nTime < nKAWPOWActivationTime) {
-        uint32_t nTimeToUse = MAINNET_X16RV2ACTIVATIONTIME;
-        if (bNetwork.fOnTestnet) {
-            nTimeToUse = TESTNET_X16RV2ACTIVATIONTIME;
-        } else if (bNetwork.fOnRegtest) {
-            nTimeToUse = REGTEST_X16RV2ACTIVATIONTIME;
-        }
-        if (nTime >= nTimeToUse) {
+        if (IsX16RV2Time(nTime)) {
             return HashX16RV2(BEGIN(nVersion), END(nNonce), hashPrevBlock);
         }
 
@@ -58,13 +64,7 @@ uint256 CBlockHeader::GetHash() const
 uint256 CBlockHeader::GetHashFull(uint256& mix_hash) const
 {
     if (nTime < nKAWPOWActivationTime) {
-        uint32_t nTimeToUse = MAINNET_X16RV2ACTIVATIONTIME;
-        if (bNetwork.fOnTestnet) {
-            nTimeToUse = TESTNET_X16RV2ACTIVATIONTIME;
-        } else if (bNetwork.fOnRegtest) {
-            nTimeToUse = REGTEST_X16RV2ACTIVATIONTIME;
-        }
-        if (nTime >= nTimeToUse) {
+        if (IsX16RV2Time(nTime)) {
             return HashX16RV2(BEGIN(nVersion), END(nNonce), hashPrevBlock);
         }
 
@@ -74,6 +74,33 @@ uint256 CBlockHeader::GetHashFull(uint256& mix_hash) const
     }
 }
 
+void GetBlockHeaderHashes(const std::vector<CBlockHeader>& vHeaders, std::vector<uint256>& vHashes)
+{
+    vHashes.resize(vHeaders.size());
+
+    std::vector<X16RMultiJob> vJobs;
+    std::vector<size_t> vJobIndex;
+    vJobs.reserve(vHeaders.size());
+    vJobIndex.reserve(vHeaders.size());
+    for (size_t i = 0; i < vHeaders.size(); i++) {
+        const CBlockHeader& header = vHeaders[i];
+        if (header.nTime < nKAWPOWActivationTime) {
+            vJobs.emplace_back((const unsigned char*)BEGIN(header.nVersion), (const unsigned char*)END(header.nNonce),
+                               header.hashPrevBlock, IsX16RV2Time(header.nTime));
+            vJobIndex.push_back(i);
+        } else {
+            vHashes[i] = KAWPOWHash_OnlyMix(header);
+        }
+    }
+
+    if (vJobs.empty())
+        return;
+
+    HashX16RMulti(vJobs);
+    for (size_t j = 0; j < vJobs.size(); j++)
+        vHashes[vJobIndex[j]] = vJobs[j].hash;
+}
+
 
 
 
@@ -112,6 +112,13 @@ public:
     }
 };
 
+/**
+ * Compute GetHash() for every header in vHeaders. Pre-KAWPOW headers are
+ * hashed together through HashX16RMulti, which is considerably faster than
+ * hashing them one at a time when many headers are processed in bulk.
+ */
+void GetBlockHeaderHashes(const std::vector<CBlockHeader>& vHeaders, std::vector<uint256>& vHashes);
+
 
 class CBlock : public CBlockHeader
 {
@@ -44,6 +44,8 @@ const char *BLOCKTXN="blocktxn";
 const char *GETASSETDATA="getassetdata";
 const char *ASSETDATA="assetdata";
 const char *ASSETNOTFOUND ="asstnotfound";
+const char *GETASSETBATCH="getassetbtch";
+const char *ASSETBATCH="assetbatch";
 } // namespace NetMsgType
 
 /** All known message types. Keep this in the same order as the list of
@@ -78,7 +80,9 @@ const static std::string allNetMessageTypes[] = {
     NetMsgType::BLOCKTXN,
     NetMsgType::GETASSETDATA,
     NetMsgType::ASSETDATA,
-    NetMsgType::ASSETNOTFOUND
+    NetMsgType::ASSETNOTFOUND,
+    NetMsgType::GETASSETBATCH,
+    NetMsgType::ASSETBATCH
 };
 const static std::vector<std::string> allNetMessageTypesVec(allNetMessageTypes, allNetMessageTypes+ARRAYLEN(allNetMessageTypes));
 
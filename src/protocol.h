@@ -263,6 +263,20 @@ extern const char *ASSETDATA;
  * @since protocol version 70018.
  */
     extern const char *ASSETNOTFOUND;
+
+/**
+ * Contains a request id and up to MAX_ASSET_INV_SZ CInvAssets.
+ * Peer should respond with one assetbatch carrying the same request id.
+ * @since protocol version 70029
+ */
+extern const char *GETASSETBATCH;
+
+/**
+ * Contains the request id of a getassetbtch message, the SerializedAssetData of
+ * the assets that were found and the CInvAssets of those that weren't.
+ * @since protocol version 70029
+ */
+extern const char *ASSETBATCH;
 };
 
 /* Get a vector of all valid message types (see above) */
@@ -114,6 +114,29 @@ UniValue UnitValueFromAmount(const CAmount& amount, const std::string asset_name
     return ValueFromAmount(amount, units);
 }
 
+UniValue AssetMetaDataToJSON(const CNewAsset& asset, const CNullAssetTxVerifierString* pverifier)
+{
+    UniValue result(UniValue::VOBJ);
+    result.push_back(Pair("name", asset.strName));
+    result.push_back(Pair("amount", ValueFromAmount(asset.nAmount, IsAssetNameAnOwner(asset.strName) ? OWNER_UNITS : asset.units)));
+    result.push_back(Pair("units", asset.units));
+    result.push_back(Pair("reissuable", asset.nReissuable));
+    result.push_back(Pair("has_ipfs", asset.nHasIPFS));
+
+    if (asset.nHasIPFS) {
+        if (asset.strIPFSHash.size() == 32) {
+            result.push_back(Pair("txid", EncodeAssetData(asset.strIPFSHash)));
+        } else {
+            result.push_back(Pair("ipfs_hash", EncodeAssetData(asset.strIPFSHash)));
+        }
+    }
+
+    if (pverifier)
+        result.push_back(Pair("verifier_string", pverifier->verifier_string));
+
+    return result;
+}
+
 #ifdef ENABLE_WALLET
 UniValue UpdateAddressTag(const JSONRPCRequest &request, const int8_t &flag)
 {
@@ -345,11 +368,11 @@ UniValue UpdateGlobalRestrictedAsset(const JSONRPCRequest &request, const int8_t
         throw JSONRPCError(RPC_INVALID_PARAMETER, std::string("Unsupported asset type: ") + AssetTypeToString(assetType));
     }
 
-    if (flag == 1 && mempool.mapGlobalFreezingAssetTransactions.count(restricted_name)){
+    if (flag == 1 && mempool.restrictionIndex.Contains(CMemPoolRestrictionIndex::Kind::GLOBAL_FREEZING, restricted_name)){
         throw JSONRPCError(RPC_TRANSACTION_REJECTED, std::string("Freezing transaction already in mempool"));
     }
 
-    if (flag == 0 && mempool.mapGlobalUnFreezingAssetTransactions.count(restricted_name)){
+    if (flag == 0 && mempool.restrictionIndex.Contains(CMemPoolRestrictionIndex::Kind::GLOBAL_UNFREEZING, restricted_name)){
         throw JSONRPCError(RPC_TRANSACTION_REJECTED, std::string("Unfreezing transaction already in mempool"));
     }
 
@@ -754,7 +777,8 @@ UniValue listassetbalancesbyaddress(const JSONRPCRequest& request)
             "1. \"address\"                  (string, required) a nrgc address\n"
             "2. \"onlytotal\"                (boolean, optional, default=false) when false result is just a list of assets balances -- when true the result is just a single number representing the number of assets\n"
             "3. \"count\"                    (integer, optional, default=50000, MAX=50000) truncates results to include only the first _count_ assets found\n"
-            "4. \"start\"                    (integer, optional, default=0) results skip over the first _start_ assets found (if negative it skips back from the end)\n"
+            "4. \"start\"                    (integer or string, optional, default=0) results skip over the first _start_ assets found (if negative it skips back from the end)\n"
+            "                                 when a string, results start after the asset of that name, pass the last one of the previous page to get the next page\n"
 
             "\nResult:\n"
             "{\n"
@@ -789,8 +813,12 @@ UniValue listassetbalancesbyaddress(const JSONRPCRequest& request)
     }
 
     long start = 0;
+    std::string strStartAfter;
     if (request.params.size() > 3) {
-        start = request.params[3].get_int();
+        if (request.params[3].isStr())
+            strStartAfter = request.params[3].get_str();
+        else
+            start = request.params[3].get_int();
     }
 
     if (!passetsdb)
@@ -799,7 +827,10 @@ UniValue listassetbalancesbyaddress(const JSONRPCRequest& request)
     LOCK(cs_main);
     std::vector<std::pair<std::string, CAmount> > vecAssetAmounts;
     int nTotalEntries = 0;
-    if (!passetsdb->AddressDir(vecAssetAmounts, nTotalEntries, fOnlyTotal, address, count, start))
+    bool fRead = strStartAfter.empty() || fOnlyTotal ?
+            passetsdb->AddressDir(vecAssetAmounts, nTotalEntries, fOnlyTotal, address, count, start) :
+            passetsdb->AddressDir(vecAssetAmounts, address, strStartAfter, count);
+    if (!fRead)
         throw JSONRPCError(RPC_INTERNAL_ERROR, "couldn't retrieve address asset directory.");
 
     // If only the number of addresses is wanted return it
@@ -846,8 +877,18 @@ UniValue getassetdata(const JSONRPCRequest& request)
 
     std::string asset_name = request.params[0].get_str();
 
+    // The database caches never hold data older than the tip, so an asset found there
+    // can be returned without cs_main. Only restricted assets have a verifier string.
+    CDatabasedAssetData data;
+    CNullAssetTxVerifierString verifier;
+    if (passetsCache && passetsCache->TryGet(asset_name, data)) {
+        if (!IsAssetNameAnRestricted(asset_name))
+            return AssetMetaDataToJSON(data.asset, nullptr);
+        if (passetsVerifierCache && passetsVerifierCache->TryGet(asset_name, verifier))
+            return AssetMetaDataToJSON(data.asset, &verifier);
+    }
+
     LOCK(cs_main);
-    UniValue result (UniValue::VOBJ);
 
     auto currentActiveAssetCache = GetCurrentAssetCache();
     if (currentActiveAssetCache) {
@@ -855,26 +896,8 @@ UniValue getassetdata(const JSONRPCRequest& request)
         if (!currentActiveAssetCache->GetAssetMetaDataIfExists(asset_name, asset))
             return NullUniValue;
 
-        result.push_back(Pair("name", asset.strName));
-        result.push_back(Pair("amount", UnitValueFromAmount(asset.nAmount, asset.strName)));
-        result.push_back(Pair("units", asset.units));
-        result.push_back(Pair("reissuable", asset.nReissuable));
-        result.push_back(Pair("has_ipfs", asset.nHasIPFS));
-
-        if (asset.nHasIPFS) {
-            if (asset.strIPFSHash.size() == 32) {
-                result.push_back(Pair("txid", EncodeAssetData(asset.strIPFSHash)));
-            } else {
-                result.push_back(Pair("ipfs_hash", EncodeAssetData(asset.strIPFSHash)));
-            }
-        }
-
-        CNullAssetTxVerifierString verifier;
-        if (currentActiveAssetCache->GetAssetVerifierStringIfExists(asset.strName, verifier)) {
-            result.push_back(Pair("verifier_string", verifier.verifier_string));
-        }
-
-        return result;
+        bool fHasVerifier = currentActiveAssetCache->GetAssetVerifierStringIfExists(asset.strName, verifier);
+        return AssetMetaDataToJSON(asset, fHasVerifier ? &verifier : nullptr);
     }
 
     return NullUniValue;
@@ -1087,7 +1110,8 @@ UniValue listaddressesbyasset(const JSONRPCRequest &request)
                 "1. \"asset_name\"               (string, required) name of asset\n"
                 "2. \"onlytotal\"                (boolean, optional, default=false) when false result is just a list of addresses with balances -- when true the result is just a single number representing the number of addresses\n"
                 "3. \"count\"                    (integer, optional, default=50000, MAX=50000) truncates results to include only the first _count_ assets found\n"
-                "4. \"start\"                    (integer, optional, default=0) results skip over the first _start_ assets found (if negative it skips back from the end)\n"
+                "4. \"start\"                    (integer or string, optional, default=0) results skip over the first _start_ addresses found (if negative it skips back from the end)\n"
+                "                                 when a string, results start after the address of that name, pass the last one of the previous page to get the next page\n"
 
                 "\nResult:\n"
                 "[ "
@@ -1099,6 +1123,7 @@ UniValue listaddressesbyasset(const JSONRPCRequest &request)
                 + HelpExampleCli("listaddressesbyasset", "\"ASSET_NAME\" false 2 0")
                 + HelpExampleCli("listaddressesbyasset", "\"ASSET_NAME\" true")
                 + HelpExampleCli("listaddressesbyasset", "\"ASSET_NAME\"")
+                + HelpExampleCli("listaddressesbyasset", "\"ASSET_NAME\" false 1000 '\"last_address\"'")
         );
 
     LOCK(cs_main);
@@ -1116,8 +1141,12 @@ UniValue listaddressesbyasset(const JSONRPCRequest &request)
     }
 
     long start = 0;
+    std::string strStartAfter;
     if (request.params.size() > 3) {
-        start = request.params[3].get_int();
+        if (request.params[3].isStr())
+            strStartAfter = request.params[3].get_str();
+        else
+            start = request.params[3].get_int();
     }
 
     if (!IsAssetNameValid(asset_name))
@@ -1126,7 +1155,10 @@ UniValue listaddressesbyasset(const JSONRPCRequest &request)
     LOCK(cs_main);
     std::vector<std::pair<std::string, CAmount> > vecAddressAmounts;
     int nTotalEntries = 0;
-    if (!passetsdb->AssetAddressDir(vecAddressAmounts, nTotalEntries, fOnlyTotal, asset_name, count, start))
+    bool fRead = strStartAfter.empty() || fOnlyTotal ?
+            passetsdb->AssetAddressDir(vecAddressAmounts, nTotalEntries, fOnlyTotal, asset_name, count, start) :
+            passetsdb->AssetAddressDir(vecAddressAmounts, asset_name, strStartAfter, count);
+    if (!fRead)
         throw JSONRPCError(RPC_INTERNAL_ERROR, "couldn't retrieve address asset directory.");
 
     // If only the number of addresses is wanted return it
@@ -1682,7 +1714,8 @@ UniValue listassets(const JSONRPCRequest& request)
                 "1. \"asset\"                    (string, optional, default=\"*\") filters results -- must be an asset name or a partial asset name followed by '*' ('*' matches all trailing characters)\n"
                 "2. \"verbose\"                  (boolean, optional, default=false) when false result is just a list of asset names -- when true results are asset name mapped to metadata\n"
                 "3. \"count\"                    (integer, optional, default=ALL) truncates results to include only the first _count_ assets found\n"
-                "4. \"start\"                    (integer, optional, default=0) results skip over the first _start_ assets found (if negative it skips back from the end)\n"
+                "4. \"start\"                    (integer or string, optional, default=0) results skip over the first _start_ assets found (if negative it skips back from the end)\n"
+                "                                 when a string, results start after the asset of that name, pass the last one of the previous page to get the next page\n"
 
                 "\nResult (verbose=false):\n"
                 "[\n"
@@ -1734,12 +1767,20 @@ UniValue listassets(const JSONRPCRequest& request)
     }
 
     long start = 0;
+    std::string strStartAfter;
     if (request.params.size() > 3) {
-        start = request.params[3].get_int();
+        if (request.params[3].isStr())
+            strStartAfter = request.params[3].get_str();
+        else
+            start = request.params[3].get_int();
     }
 
+    LOCK(cs_main);
     std::vector<CDatabasedAssetData> assets;
-    if (!passetsdb->AssetDir(assets, filter, count, start))
+    bool fRead = strStartAfter.empty() ?
+            passetsdb->AssetDir(assets, filter, count, start) :
+            passetsdb->AssetDir(assets, filter, strStartAfter, count, 0);
+    if (!fRead)
         throw JSONRPCError(RPC_INTERNAL_ERROR, "couldn't retrieve asset directory.");
 
     UniValue result;
@@ -1772,6 +1813,19 @@ UniValue listassets(const JSONRPCRequest& request)
     return result;
 }
 
+template <typename Cache>
+static UniValue LRUCacheInfoToJSON(Cache& cache)
+{
+    UniValue info(UniValue::VOBJ);
+    info.push_back(Pair("size", (int)cache.Size()));
+    info.push_back(Pair("max size", (int)cache.MaxSize()));
+    info.push_back(Pair("memory usage (est)", (int)cache.DynamicMemoryUsage()));
+    info.push_back(Pair("hits", cache.Hits()));
+    info.push_back(Pair("misses", cache.Misses()));
+    info.push_back(Pair("evictions", cache.Evictions()));
+    return info;
+}
+
 UniValue getcacheinfo(const JSONRPCRequest& request)
 {
     if (request.fHelp || !AreAssetsDeployed() || request.params.size())
@@ -1790,6 +1844,12 @@ UniValue getcacheinfo(const JSONRPCRequest& request)
                 "  asset metadata map:\n"
                 "  asset metadata list (est):\n"
                 "  dirty cache (est):\n"
+                "  dirty cache V2 (est):\n"
+                "  database caches: {\n"
+                "    (cache name): {\n"
+                "      size, max size, memory usage (est), hits, misses, evictions\n"
+                "    }, ...\n"
+                "  }\n"
 
 
                 "]\n"
@@ -1822,11 +1882,31 @@ UniValue getcacheinfo(const JSONRPCRequest& request)
 
     info.push_back(Pair("reissue tracking (memory only)", (int)memusage::DynamicUsage(mapReissuedAssets) + (int)memusage::DynamicUsage(mapReissuedTx)));
     info.push_back(Pair("asset data", descendants));
-    info.push_back(Pair("asset metadata map",  (int)memusage::DynamicUsage(passetsCache->GetItemsMap())));
-    info.push_back(Pair("asset metadata list (est)",  (int)passetsCache->GetItemsList().size() * (32 + 80))); // Max 32 bytes for asset name, 80 bytes max for asset data
+    info.push_back(Pair("asset metadata map",  (int)passetsCache->DynamicMemoryUsage()));
+    info.push_back(Pair("asset metadata list (est)",  (int)passetsCache->Size() * (32 + 80))); // Max 32 bytes for asset name, 80 bytes max for asset data
     info.push_back(Pair("dirty cache (est)",  (int)currentActiveAssetCache->GetCacheSize()));
     info.push_back(Pair("dirty cache V2 (est)",  (int)currentActiveAssetCache->GetCacheSizeV2()));
 
+    UniValue lru(UniValue::VOBJ);
+    lru.push_back(Pair("asset metadata", LRUCacheInfoToJSON(*passetsCache)));
+    if (passetsVerifierCache)
+        lru.push_back(Pair("verifier string", LRUCacheInfoToJSON(*passetsVerifierCache)));
+    if (passetsCompiledVerifierCache)
+        lru.push_back(Pair("compiled verifier", LRUCacheInfoToJSON(*passetsCompiledVerifierCache)));
+    if (passetsQualifierCache)
+        lru.push_back(Pair("address qualifier", LRUCacheInfoToJSON(*passetsQualifierCache)));
+    if (passetsRestrictionCache)
+        lru.push_back(Pair("address restriction", LRUCacheInfoToJSON(*passetsRestrictionCache)));
+    if (passetsGlobalRestrictionCache)
+        lru.push_back(Pair("global restriction", LRUCacheInfoToJSON(*passetsGlobalRestrictionCache)));
+    if (pMessagesCache)
+        lru.push_back(Pair("messages", LRUCacheInfoToJSON(*pMessagesCache)));
+    if (pMessageSubscribedChannelsCache)
+        lru.push_back(Pair("subscribed channels", LRUCacheInfoToJSON(*pMessageSubscribedChannelsCache)));
+    if (pMessagesSeenAddressCache)
+        lru.push_back(Pair("seen addresses", LRUCacheInfoToJSON(*pMessagesSeenAddressCache)));
+    info.push_back(Pair("database caches", lru));
+
     result.push_back(info);
     return result;
 }
@@ -2248,6 +2328,12 @@ UniValue checkaddresstag(const JSONRPCRequest& request)
     if (!IsValidDestination(dest))
         throw JSONRPCError(RPC_INVALID_PARAMETER, std::string("Not valid NRGC address: ") + address);
 
+    // A tag found in the qualifier cache is current as of the tip, no need for cs_main
+    int8_t nCached;
+    if (passetsQualifierCache->TryGet(CAssetCacheQualifierAddress(qualifier_name, address, QualifierType::ADD_QUALIFIER).GetHash().GetHex(), nCached))
+        return true;
+
+    LOCK(cs_main);
     return passets->CheckForAddressQualifier(qualifier_name, address);
 }
 
@@ -2961,22 +3047,23 @@ UniValue getsnapshot(const JSONRPCRequest& request)
     LOCK(cs_main);
     UniValue result (UniValue::VOBJ);
 
-    CAssetSnapshotDBEntry snapshotDbEntry;
-
-    if (pAssetSnapshotDb->RetrieveOwnershipSnapshot(asset_name, block_height, snapshotDbEntry)) {
-        result.push_back(Pair("name", snapshotDbEntry.assetName));
-        result.push_back(Pair("height", snapshotDbEntry.height));
-
-        UniValue entries(UniValue::VARR);
-        for (auto const & ownerAndAmt : snapshotDbEntry.ownersAndAmounts) {
+    // Stream the snapshot a chunk at a time instead of loading all of its owners first
+    UniValue entries(UniValue::VARR);
+    bool fFound = pAssetSnapshotDb->ForEachOwnershipSnapshotChunk(asset_name, block_height, [&](const SnapshotChunk& chunk) {
+        for (auto const & ownerAndAmt : chunk) {
             UniValue entry(UniValue::VOBJ);
 
             entry.push_back(Pair("address", ownerAndAmt.first));
-            entry.push_back(Pair("amount_owned", UnitValueFromAmount(ownerAndAmt.second, snapshotDbEntry.assetName)));
+            entry.push_back(Pair("amount_owned", UnitValueFromAmount(ownerAndAmt.second, asset_name)));
 
             entries.push_back(entry);
         }
+        return true;
+    });
 
+    if (fFound) {
+        result.push_back(Pair("name", asset_name));
+        result.push_back(Pair("height", block_height));
         result.push_back(Pair("owners", entries));
 
         return result;
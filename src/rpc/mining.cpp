@@ -14,6 +14,7 @@
 #include "consensus/validation.h"
 #include "core_io.h"
 #include "init.h"
+#include "kawpowcache.h"
 #include "validation.h"
 #include "miner.h"
 #include "net.h"
@@ -36,10 +37,6 @@
 #include <consensus/merkle.h>
 #include <crypto/ethash/include/ethash/progpow.hpp>
 
-extern uint64_t nHashesPerSec;
-
-std::map<std::string, CBlock> mapNRGCKAWBlockTemplates;
-
 unsigned int ParseConfirmTarget(const UniValue& value)
 {
     int target = value.get_int();
@@ -137,26 +134,17 @@ UniValue generateBlocks(std::shared_ptr<CReserveScript> coinbaseScript, int nGen
             LOCK(cs_main);
             IncrementExtraNonce(pblock, chainActive.Tip(), nExtraNonce);
         }
-        uint256 mix_hash;
-        while (nMaxTries > 0 && pblock->nNonce < nInnerLoopCount && !CheckProofOfWork(pblock->GetHashFull(mix_hash), pblock->nBits,
-                                                                                      GetParams().GetConsensus())) {
-            if (pblock->nTime < nKAWPOWActivationTime) {
-                ++pblock->nNonce;
-            } else  {
-                ++pblock->nNonce64;
-            }
-            --nMaxTries;
-        }
+        uint64_t nHashes = 0;
+        bool fFound = ScanBlockNonces(pblock, arith_uint256().SetCompact(pblock->nBits), 0, std::min<uint64_t>(nMaxTries, nInnerLoopCount), nHashes);
+        // Only the failed tries count against nMaxTries
+        nMaxTries -= fFound ? nHashes - 1 : nHashes;
         if (nMaxTries == 0) {
             break;
         }
-        if (pblock->nNonce == nInnerLoopCount || pblock->nNonce64 == nInnerLoopCount) {
+        if (!fFound) {
             continue;
         }
 
-        // KAWPOW Assign the mix_hash to the block that was found
-        pblock->mix_hash = mix_hash;
-
         std::shared_ptr<const CBlock> shared_pblock = std::make_shared<const CBlock>(*pblock);
         if (!ProcessNewBlock(GetParams(), shared_pblock, true, nullptr))
             throw JSONRPCError(RPC_INTERNAL_ERROR, "ProcessNewBlock, block not accepted");
@@ -220,6 +208,19 @@ UniValue getmininginfo(const JSONRPCRequest& request)
             "  \"difficulty\": xxx.xxxxx    (numeric) The current difficulty\n"
             "  \"networkhashps\": nnn,      (numeric) The network hashes per second\n"
             "  \"hashespersec\": nnn,       (numeric) The hashes per second of built-in miner\n"
+            "  \"minerthreads\": [           (array) The counters of each thread of the built-in miner\n"
+            "    {\n"
+            "      \"hashes\": nnn,           (numeric) The hashes done by the thread since mining started\n"
+            "      \"hashespersec\": nnn      (numeric) The hashes per second of the thread\n"
+            "    }, ...\n"
+            "  ],\n"
+            "  \"kawpowtemplates\": {        (json object) The block templates kept for pprpcsb\n"
+            "    \"templates\": nnn,          (numeric) The number of templates\n"
+            "    \"memory\": nnn,             (numeric) The memory they use, in bytes\n"
+            "    \"hits\": nnn,               (numeric) The submissions that found their template\n"
+            "    \"misses\": nnn,             (numeric) The submissions that didn't\n"
+            "    \"evictions\": nnn           (numeric) The templates dropped to make room for newer ones\n"
+            "  },\n"
             "  \"pooledtx\": n              (numeric) The size of the mempool\n"
             "  \"chain\": \"xxxx\",           (string) current network name as defined in BIP70 (main, test, regtest)\n"
             "  \"warnings\": \"...\"          (string) any network and blockchain warnings\n"
@@ -238,7 +239,25 @@ UniValue getmininginfo(const JSONRPCRequest& request)
     obj.push_back(Pair("currentblocktx",   (uint64_t)nLastBlockTx));
     obj.push_back(Pair("difficulty",       (double)GetDifficulty()));
     obj.push_back(Pair("networkhashps",    getnetworkhashps(request)));
-    obj.push_back(Pair("hashespersec",     (uint64_t)nHashesPerSec));
+    uint64_t nHashesPerSec = 0;
+    UniValue minerThreads(UniValue::VARR);
+    for (const CMinerThreadStats& stats : GetMinerThreadStats()) {
+        UniValue thread(UniValue::VOBJ);
+        thread.push_back(Pair("hashes",       stats.nHashesDone));
+        thread.push_back(Pair("hashespersec", stats.nHashesPerSec));
+        minerThreads.push_back(thread);
+        nHashesPerSec += stats.nHashesPerSec;
+    }
+    obj.push_back(Pair("hashespersec",     nHashesPerSec));
+    obj.push_back(Pair("minerthreads",     minerThreads));
+    CKAWPOWTemplateStore::Stats templateStats = kawpowTemplateStore.GetStats();
+    UniValue kawpowTemplates(UniValue::VOBJ);
+    kawpowTemplates.push_back(Pair("templates", (uint64_t)templateStats.nTemplates));
+    kawpowTemplates.push_back(Pair("memory",    (uint64_t)templateStats.nMemoryUsage));
+    kawpowTemplates.push_back(Pair("hits",      templateStats.nHits));
+    kawpowTemplates.push_back(Pair("misses",    templateStats.nMisses));
+    kawpowTemplates.push_back(Pair("evictions", templateStats.nEvictions));
+    obj.push_back(Pair("kawpowtemplates",  kawpowTemplates));
     obj.push_back(Pair("pooledtx",         (uint64_t)mempool.size()));
     obj.push_back(Pair("chain", GetParams().NetworkIDString()));
     if (IsDeprecatedRPCEnabled("getmininginfo")) {
@@ -538,7 +557,6 @@ UniValue getblocktemplate(const JSONRPCRequest& request)
     {
         // Clear pindexPrev so future calls make a new block, despite any failures from here on
         pindexPrev = nullptr;
-        mapNRGCKAWBlockTemplates.clear();
 
         // Store the pindexBest used before CreateNewBlock, to avoid races
         nTransactionsUpdatedLast = mempool.GetTransactionsUpdated();
@@ -722,20 +740,23 @@ UniValue getblocktemplate(const JSONRPCRequest& request)
     if (pblock->nTime >= nKAWPOWActivationTime) {
         std::string address = gArgs.GetArg("-miningaddress", "");
         if (IsValidDestinationString(address)) {
-            static std::string lastheader = "";
-            if (mapNRGCKAWBlockTemplates.count(lastheader)) {
-                if (pblock->nTime - 30 < mapNRGCKAWBlockTemplates.at(lastheader).nTime) {
-                    result.pushKV("pprpcheader", lastheader);
-                    result.pushKV("pprpcepoch", ethash::get_epoch_number(pblock->nHeight));
-                    return result;
-                }
+            static uint256 lastheader;
+            static uint32_t nLastHeaderTime = 0;
+            if (kawpowTemplateStore.Exists(lastheader) && pblock->nTime - 30 < nLastHeaderTime) {
+                result.pushKV("pprpcheader", lastheader.GetHex());
+                result.pushKV("pprpcepoch", ethash::get_epoch_number(pblock->nHeight));
+                return result;
             }
 
+            // Solutions for templates of the previous tip can't be used any more
+            kawpowTemplateStore.RemoveBelowHeight(pblock->nHeight);
+
             pblock->hashMerkleRoot = BlockMerkleRoot(*pblock);
-            result.pushKV("pprpcheader", pblock->GetKAWPOWHeaderHash().GetHex());
+            lastheader = pblock->GetKAWPOWHeaderHash();
+            nLastHeaderTime = pblock->nTime;
+            result.pushKV("pprpcheader", lastheader.GetHex());
             result.pushKV("pprpcepoch", ethash::get_epoch_number(pblock->nHeight));
-            mapNRGCKAWBlockTemplates[pblock->GetKAWPOWHeaderHash().GetHex()] = *pblock;
-            lastheader = pblock->GetKAWPOWHeaderHash().GetHex();
+            kawpowTemplateStore.Add(lastheader, std::make_shared<const CBlock>(*pblock));
         }
     }
 
@@ -800,18 +821,20 @@ static UniValue getkawpowhash(const JSONRPCRequest& request) {
         fCheckTarget = true;
     }
 
-    static ethash::epoch_context_ptr context{nullptr, nullptr};
-
-    // Get the context from the block height
+    // Get the context from the block height. Never stall the caller while the epoch
+    // context is generated, let the prebuild thread do it and report back instead.
     const auto epoch_number = ethash::get_epoch_number(nHeight);
-    if (!context || context->epoch_number != epoch_number)
-        context = ethash::create_epoch_context(epoch_number);
+    const ethash::epoch_context* context = ethash::try_get_global_epoch_context(epoch_number);
+    if (!context) {
+        PrebuildKawpowEpochContext(epoch_number);
+        throw JSONRPCError(RPC_IN_WARMUP, strprintf("KAWPOW epoch %d context is being generated, try again shortly", epoch_number));
+    }
 
     // ProgPow hash
     const auto result = progpow::hash(*context, nHeight, header_hash, nNonce);
 
-    uint256 mined_mix_hash = uint256S(to_hex(result.mix_hash));
-    uint256 mined_final_hash = uint256S(to_hex(result.final_hash));
+    uint256 mined_mix_hash = FromEthashHash(result.mix_hash);
+    uint256 mined_final_hash = FromEthashHash(result.final_hash);
 
     bool mix_hash_match = false;
     bool final_hash_meets_target = false;
@@ -863,11 +886,12 @@ static UniValue pprpcsb(const JSONRPCRequest& request) {
     if (!ParseUInt64(str_nonce, &nonce, 16))
         throw JSONRPCError(RPC_INVALID_PARAMS, "Invalid hex nonce");
 
-    if (!mapNRGCKAWBlockTemplates.count(header_hash))
+    std::shared_ptr<const CBlock> blocktemplate = kawpowTemplateStore.Get(uint256S(header_hash));
+    if (!blocktemplate)
         throw JSONRPCError(RPC_INVALID_PARAMS, "Block header hash not found in block data");
 
-    std::shared_ptr<CBlock> blockptr = std::make_shared<CBlock>();
-    *blockptr = mapNRGCKAWBlockTemplates.at(header_hash);
+    // Copies the header and the transaction pointers, the transactions themselves stay shared
+    std::shared_ptr<CBlock> blockptr = std::make_shared<CBlock>(*blocktemplate);
 
     blockptr->nNonce64 = nonce;
     blockptr->mix_hash = uint256S(mix_hash);
@@ -0,0 +1,291 @@
+// Copyright (c) 2023-2024 The Nrgc Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "assets/assets.h"
+#include "assets/assetdb.h"
+#include "assets/assetsnapshotdb.h"
+#include "assets/rewards.h"
+#include "validation.h"
+#include <boost/test/unit_test.hpp>
+#include <test/test_nrgc.h>
+
+BOOST_FIXTURE_TEST_SUITE(asset_db_tests, TestingSetup)
+
+static std::vector<std::string> PagedAssetNames(CAssetsDB& db, const std::string& filter, size_t nPageSize)
+{
+    std::vector<std::string> vNames;
+    std::string strStartAfter;
+    while (true) {
+        std::vector<CDatabasedAssetData> assets;
+        BOOST_CHECK(db.AssetDir(assets, filter, strStartAfter, nPageSize, 0));
+        for (const auto& data : assets)
+            vNames.push_back(data.asset.strName);
+        if (assets.size() < nPageSize)
+            return vNames;
+        strStartAfter = assets.back().asset.strName;
+    }
+}
+
+BOOST_AUTO_TEST_CASE(asset_dir_keyed_pages_test)
+{
+    LOCK(cs_main);
+    CAssetsDB db(1 << 20, true);
+
+    for (const std::string name : {"AB", "ABC", "ABD", "AC", "ABCD", "XYZ", "ABCDE", "ABZZZ", "BAB", "ZZ"})
+        BOOST_CHECK(db.WriteAssetData(CNewAsset(name, 1000), 1, uint256()));
+
+    std::vector<CDatabasedAssetData> all;
+    BOOST_CHECK(db.AssetDir(all, "*", MAX_SIZE, 0));
+    BOOST_CHECK_EQUAL(all.size(), 10U);
+
+    // Every page size walks the same names in the same order as the offset listing
+    for (size_t nPageSize = 1; nPageSize <= 11; nPageSize++) {
+        std::vector<std::string> vNames = PagedAssetNames(db, "*", nPageSize);
+        BOOST_REQUIRE_EQUAL(vNames.size(), all.size());
+        for (size_t i = 0; i < all.size(); i++)
+            BOOST_CHECK_EQUAL(vNames[i], all[i].asset.strName);
+    }
+
+    // Prefixes only return names starting with the prefix, across name lengths
+    std::vector<std::string> vPrefixed = PagedAssetNames(db, "AB*", 2);
+    BOOST_CHECK((vPrefixed == std::vector<std::string>{"AB", "ABC", "ABD", "ABCD", "ABCDE", "ABZZZ"}));
+
+    std::vector<CDatabasedAssetData> exact;
+    BOOST_CHECK(db.AssetDir(exact, "ABD", "", 10, 0));
+    BOOST_REQUIRE_EQUAL(exact.size(), 1U);
+    BOOST_CHECK_EQUAL(exact[0].asset.strName, "ABD");
+
+    // Tokens that are not in the table resume from where they would sort
+    std::vector<CDatabasedAssetData> assets;
+    BOOST_CHECK(db.AssetDir(assets, "AB*", "ABB", 10, 0));
+    BOOST_REQUIRE_EQUAL(assets.size(), 5U);
+    BOOST_CHECK_EQUAL(assets[0].asset.strName, "ABC");
+
+    assets.clear();
+    BOOST_CHECK(db.AssetDir(assets, "AB*", "AA", 10, 0));
+    BOOST_REQUIRE_EQUAL(assets.size(), 6U);
+    BOOST_CHECK_EQUAL(assets[0].asset.strName, "AB");
+
+    assets.clear();
+    BOOST_CHECK(db.AssetDir(assets, "AB*", "ACC", 10, 0));
+    BOOST_REQUIRE_EQUAL(assets.size(), 3U);
+    BOOST_CHECK_EQUAL(assets[0].asset.strName, "ABCD");
+
+    // Negative offsets still count back from the end
+    assets.clear();
+    BOOST_CHECK(db.AssetDir(assets, "AB*", 2, -2));
+    BOOST_REQUIRE_EQUAL(assets.size(), 2U);
+    BOOST_CHECK_EQUAL(assets[0].asset.strName, "ABCDE");
+}
+
+BOOST_AUTO_TEST_CASE(asset_holder_count_test)
+{
+    LOCK(cs_main);
+    CAssetsDB db(1 << 20, true);
+
+    for (int i = 0; i < 25; i++)
+        BOOST_CHECK(db.WriteAssetAddressQuantity("ASSET", strprintf("address%02d", i), 100 + i));
+    BOOST_CHECK(db.WriteAssetAddressQuantity("OTHER", "address00", 1));
+
+    // Rewriting a balance does not add a holder, erasing one removes it
+    BOOST_CHECK(db.WriteAssetAddressQuantity("ASSET", "address03", 5));
+    BOOST_CHECK(db.EraseAssetAddressQuantity("ASSET", "address04"));
+    BOOST_CHECK(db.EraseAssetAddressQuantity("ASSET", "address04"));
+
+    int nTotal = 0;
+    std::vector<std::pair<std::string, CAmount> > vec;
+    BOOST_CHECK(db.AssetAddressDir(vec, nTotal, true, "ASSET", 0, 0));
+    BOOST_CHECK_EQUAL(nTotal, 24);
+    BOOST_CHECK(db.AssetAddressDir(vec, nTotal, true, "OTHER", 0, 0));
+    BOOST_CHECK_EQUAL(nTotal, 1);
+    BOOST_CHECK(db.AssetAddressDir(vec, nTotal, true, "NONE", 0, 0));
+    BOOST_CHECK_EQUAL(nTotal, 0);
+
+    // Keyed pages cover every holder exactly once
+    std::vector<std::pair<std::string, CAmount> > vAll;
+    std::string strStartAfter;
+    do {
+        vec.clear();
+        BOOST_CHECK(db.AssetAddressDir(vec, "ASSET", strStartAfter, 7));
+        vAll.insert(vAll.end(), vec.begin(), vec.end());
+        if (!vec.empty())
+            strStartAfter = vec.back().first;
+    } while (vec.size() == 7);
+    BOOST_REQUIRE_EQUAL(vAll.size(), 24U);
+    BOOST_CHECK_EQUAL(vAll[0].first, "address00");
+    BOOST_CHECK_EQUAL(vAll[3].second, 5);
+    BOOST_CHECK_EQUAL(vAll[4].first, "address05");
+
+    // Counting from scratch matches the maintained counts
+    BOOST_CHECK(db.BuildAssetHolderCounts());
+    BOOST_CHECK(db.AssetAddressDir(vec, nTotal, true, "ASSET", 0, 0));
+    BOOST_CHECK_EQUAL(nTotal, 24);
+}
+
+static void WriteSnapshot(CAssetSnapshotDB& db, int nOwners)
+{
+    CAssetSnapshotWriter writer(db, "ASSET", 100);
+    for (int i = 0; i < nOwners; i++)
+        BOOST_CHECK(writer.Add(strprintf("address%05d", i), 1 + i));
+    BOOST_CHECK(writer.Finish());
+}
+
+BOOST_AUTO_TEST_CASE(asset_snapshot_chunks_test)
+{
+    CAssetSnapshotDB db(fs::path("assetsnapshot"), 1 << 20, true, false);
+    BOOST_CHECK(!db.HasOwnershipSnapshot("ASSET", 100));
+
+    // Empty snapshots aren't written
+    CAssetSnapshotWriter empty(db, "ASSET", 100);
+    BOOST_CHECK(!empty.Finish());
+    BOOST_CHECK(!db.HasOwnershipSnapshot("ASSET", 100));
+
+    WriteSnapshot(db, 2 * SNAPSHOT_CHUNK_SIZE + 5);
+    BOOST_CHECK(db.HasOwnershipSnapshot("ASSET", 100));
+    BOOST_CHECK(!db.HasOwnershipSnapshot("ASSET", 101));
+
+    std::vector<size_t> vChunkSizes;
+    std::string strLast;
+    bool fOrdered = true;
+    BOOST_CHECK(db.ForEachOwnershipSnapshotChunk("ASSET", 100, [&](const SnapshotChunk& chunk) {
+        vChunkSizes.push_back(chunk.size());
+        for (const auto& pair : chunk) {
+            fOrdered &= strLast < pair.first;
+            strLast = pair.first;
+        }
+        return true;
+    }));
+    BOOST_CHECK(fOrdered);
+    BOOST_CHECK((vChunkSizes == std::vector<size_t>{SNAPSHOT_CHUNK_SIZE, SNAPSHOT_CHUNK_SIZE, 5}));
+
+    // Rewriting a snapshot with fewer owners drops the chunks it doesn't use anymore
+    WriteSnapshot(db, SNAPSHOT_CHUNK_SIZE + 1);
+    CAssetSnapshotDBEntry entry;
+    BOOST_CHECK(db.RetrieveOwnershipSnapshot("ASSET", 100, entry));
+    BOOST_CHECK_EQUAL(entry.ownersAndAmounts.size(), SNAPSHOT_CHUNK_SIZE + 1);
+    BOOST_CHECK(db.Exists(std::make_pair('K', std::make_pair(std::make_pair(100, std::string("ASSET")), (uint32_t)1))));
+    BOOST_CHECK(!db.Exists(std::make_pair('K', std::make_pair(std::make_pair(100, std::string("ASSET")), (uint32_t)2))));
+
+    BOOST_CHECK(db.RemoveOwnershipSnapshot("ASSET", 100));
+    BOOST_CHECK(!db.HasOwnershipSnapshot("ASSET", 100));
+    BOOST_CHECK(!db.RetrieveOwnershipSnapshot("ASSET", 100, entry));
+}
+
+BOOST_AUTO_TEST_CASE(asset_snapshot_distribution_test)
+{
+    CAssetSnapshotDB db(fs::path("assetsnapshot"), 1 << 20, true, false);
+    std::vector<OwnerAndAmount> vecDistributionList;
+    BOOST_CHECK(!CalculateDistribution(db, "ASSET", 100, {}, 100, COIN, vecDistributionList));
+
+    CAssetSnapshotWriter writer(db, "ASSET", 100);
+    BOOST_CHECK(writer.Add("a", 1 * COIN));
+    BOOST_CHECK(writer.Add("b", 2 * COIN));
+    BOOST_CHECK(writer.Add("c", 3 * COIN));
+    BOOST_CHECK(writer.Add("d", 4 * COIN));
+    BOOST_CHECK(writer.Add("e", 0));
+    BOOST_CHECK(writer.Finish());
+
+    // Shares are rounded down to whole units of the distribution asset
+    BOOST_CHECK(CalculateDistribution(db, "ASSET", 100, {}, 15, COIN, vecDistributionList));
+    BOOST_REQUIRE_EQUAL(vecDistributionList.size(), 4U);
+    BOOST_CHECK_EQUAL(vecDistributionList[0].address, "a");
+    BOOST_CHECK_EQUAL(vecDistributionList[0].amount, 1 * COIN);
+    BOOST_CHECK_EQUAL(vecDistributionList[1].amount, 3 * COIN);
+    BOOST_CHECK_EQUAL(vecDistributionList[2].amount, 4 * COIN);
+    BOOST_CHECK_EQUAL(vecDistributionList[3].amount, 6 * COIN);
+
+    // Exception addresses are left out of the total as well, large payments don't overflow
+    BOOST_CHECK(CalculateDistribution(db, "ASSET", 100, {"d"}, MAX_MONEY, 1, vecDistributionList));
+    BOOST_REQUIRE_EQUAL(vecDistributionList.size(), 3U);
+    BOOST_CHECK_EQUAL(vecDistributionList[0].amount, MAX_MONEY / 6);
+    BOOST_CHECK_EQUAL(vecDistributionList[2].address, "c");
+    BOOST_CHECK_EQUAL(vecDistributionList[2].amount, MAX_MONEY / 2);
+
+    BOOST_CHECK(!CalculateDistribution(db, "ASSET", 100, {"a", "b", "c", "d"}, 15, COIN, vecDistributionList));
+    BOOST_CHECK(vecDistributionList.empty());
+}
+
+BOOST_AUTO_TEST_CASE(asset_cache_layers_test)
+{
+    LOCK(cs_main);
+    CAssetsCache child(passets);
+    CAssetsCache grandchild(&child);
+    BOOST_CHECK(child.Parent() == passets);
+    BOOST_CHECK(grandchild.Parent() == &child);
+    BOOST_CHECK(passets->Parent() == nullptr);
+
+    CNewAsset asset("LAYERED", 1000 * COIN);
+    BOOST_CHECK(child.AddNewAsset(asset, "address", 1, uint256()));
+    BOOST_CHECK(child.AddGlobalRestricted("$LAYERED", RestrictedType::GLOBAL_FREEZE));
+
+    // Lookups see the changes of every cache below them, but not of the ones above
+    CNewAsset found;
+    BOOST_CHECK(grandchild.CheckIfAssetExists("LAYERED"));
+    BOOST_CHECK(grandchild.GetAssetMetaDataIfExists("LAYERED", found));
+    BOOST_CHECK_EQUAL(found.nAmount, 1000 * COIN);
+    BOOST_CHECK(!passets->CheckIfAssetExists("LAYERED"));
+    BOOST_CHECK(grandchild.CheckForGlobalRestriction("$LAYERED"));
+    BOOST_CHECK(grandchild.CheckForGlobalRestriction("$LAYERED", true));
+    BOOST_CHECK(!child.CheckForGlobalRestriction("$LAYERED", true));
+
+    // Changes in a view stay there until it is flushed into its parent
+    BOOST_CHECK(grandchild.RemoveNewAsset(asset, "address"));
+    BOOST_CHECK(!grandchild.CheckIfAssetExists("LAYERED"));
+    BOOST_CHECK(child.CheckIfAssetExists("LAYERED"));
+    BOOST_CHECK(grandchild.Flush());
+    BOOST_CHECK(!child.CheckIfAssetExists("LAYERED"));
+
+    CAssetsCache other(passets);
+    BOOST_CHECK(other.AddNewAsset(CNewAsset("FLUSHED", 5 * COIN), "address", 2, uint256()));
+    BOOST_CHECK(other.Flush());
+    BOOST_CHECK(passets->CheckIfAssetExists("FLUSHED"));
+    BOOST_CHECK(child.CheckIfAssetExists("FLUSHED"));
+}
+
+BOOST_AUTO_TEST_CASE(asset_metadata_snapshot_test)
+{
+    CNewAsset asset("SNAPSHOT", 1000 * COIN);
+    {
+        LOCK(cs_main);
+        BOOST_CHECK(passets->AddNewAsset(asset, "address", 5, uint256()));
+        InvalidateAssetMetaDataSnapshot();
+    }
+
+    // Assets passets hasn't flushed yet are copied into the snapshot
+    std::shared_ptr<const CAssetMetaDataSnapshot> snapshot = GetAssetMetaDataSnapshot();
+    CDatabasedAssetData data;
+    BOOST_CHECK(snapshot->GetAssetMetaData("SNAPSHOT", data));
+    BOOST_CHECK_EQUAL(data.nHeight, 5);
+    BOOST_CHECK_EQUAL(data.asset.nAmount, 1000 * COIN);
+    BOOST_CHECK(!snapshot->GetAssetMetaData("MISSING", data));
+    BOOST_CHECK(!snapshot->GetAssetMetaData("not a valid name", data));
+    BOOST_CHECK(GetAssetMetaDataSnapshot() == snapshot);
+
+    // A reissue keeps the height of the issuance, the snapshot handed out before keeps the old data
+    CNewAsset reissued = asset;
+    reissued.nAmount = 1500 * COIN;
+    {
+        LOCK(cs_main);
+        passets->mapReissuedAssetData["SNAPSHOT"] = reissued;
+        InvalidateAssetMetaDataSnapshot();
+    }
+    std::shared_ptr<const CAssetMetaDataSnapshot> reissuedSnapshot = GetAssetMetaDataSnapshot();
+    BOOST_CHECK(reissuedSnapshot != snapshot);
+    BOOST_CHECK(reissuedSnapshot->GetAssetMetaData("SNAPSHOT", data));
+    BOOST_CHECK_EQUAL(data.nHeight, 5);
+    BOOST_CHECK_EQUAL(data.asset.nAmount, 1500 * COIN);
+    BOOST_CHECK(snapshot->GetAssetMetaData("SNAPSHOT", data));
+    BOOST_CHECK_EQUAL(data.asset.nAmount, 1000 * COIN);
+
+    // Removed assets aren't looked up any further
+    {
+        LOCK(cs_main);
+        passets->mapReissuedAssetData.clear();
+        BOOST_CHECK(passets->RemoveNewAsset(asset, "address"));
+        InvalidateAssetMetaDataSnapshot();
+    }
+    BOOST_CHECK(!GetAssetMetaDataSnapshot()->GetAssetMetaData("SNAPSHOT", data));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,390 @@
+// Copyright (c) 2023-2024 The Nrgc Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef NRGC_TEST_ASSETS_ASSET_NAME_REGEX_H
+#define NRGC_TEST_ASSETS_ASSET_NAME_REGEX_H
+
+#include "assets/assets.h"
+#include "assets/assettypes.h"
+
+#include <regex>
+#include <string>
+#include <vector>
+
+#include <boost/algorithm/string.hpp>
+
+/**
+ * The std::regex based asset name validation the table driven validator in
+ * assets/assets.cpp replaced, kept as the reference for the differential tests
+ * (asset_tests and test_nrgc_fuzzy). Only the calls taking an AssetType are
+ * qualified, so argument dependent lookup can't pick the replacements.
+ */
+namespace asset_name_regex {
+
+inline bool IsTypeCheckNameValid(const AssetType type, const std::string& name, std::string& error);
+
+// excluding owner tag ('!')
+static const auto MAX_NAME_LENGTH = 31;
+static const auto MAX_CHANNEL_NAME_LENGTH = 12;
+
+// min lengths are expressed by quantifiers
+static const std::regex ROOT_NAME_CHARACTERS("^[A-Z0-9._]{3,}$");
+static const std::regex SUB_NAME_CHARACTERS("^[A-Z0-9._]+$");
+static const std::regex UNIQUE_TAG_CHARACTERS("^[-A-Za-z0-9@$%&*()[\\]{}_.?:]+$");
+static const std::regex MSG_CHANNEL_TAG_CHARACTERS("^[A-Za-z0-9_]+$");
+static const std::regex VOTE_TAG_CHARACTERS("^[A-Z0-9._]+$");
+
+// Restricted assets
+static const std::regex QUALIFIER_NAME_CHARACTERS("#[A-Z0-9._]{3,}$");
+static const std::regex SUB_QUALIFIER_NAME_CHARACTERS("#[A-Z0-9._]+$");
+static const std::regex RESTRICTED_NAME_CHARACTERS("\\$[A-Z0-9._]{3,}$");
+
+static const std::regex DOUBLE_PUNCTUATION("^.*[._]{2,}.*$");
+static const std::regex LEADING_PUNCTUATION("^[._].*$");
+static const std::regex TRAILING_PUNCTUATION("^.*[._]$");
+static const std::regex QUALIFIER_LEADING_PUNCTUATION("^[#\\$][._].*$"); // Used for qualifier assets, and restricted asset only
+
+static const std::string SUB_NAME_DELIMITER = "/";
+static const std::string UNIQUE_TAG_DELIMITER = "#";
+static const std::string MSG_CHANNEL_TAG_DELIMITER = "~";
+static const std::string VOTE_TAG_DELIMITER = "^";
+static const std::string RESTRICTED_TAG_DELIMITER = "$";
+
+static const std::regex UNIQUE_INDICATOR(R"(^[^^~#!]+#[^~#!\/]+$)");
+static const std::regex MSG_CHANNEL_INDICATOR(R"(^[^^~#!]+~[^~#!\/]+$)");
+static const std::regex OWNER_INDICATOR(R"(^[^^~#!]+!$)");
+static const std::regex VOTE_INDICATOR(R"(^[^^~#!]+\^[^~#!\/]+$)");
+
+static const std::regex QUALIFIER_INDICATOR("^[#][A-Z0-9._]{3,}$"); // Starts with #
+static const std::regex SUB_QUALIFIER_INDICATOR("^#[A-Z0-9._]+\\/#[A-Z0-9._]+$"); // Starts with #
+static const std::regex RESTRICTED_INDICATOR("^[\\$][A-Z0-9._]{3,}$"); // Starts with $
+
+static const std::regex NRGC_NAMES("^NRGC$|^NRGC$|^ENERGYCOIN$|^#NRGC$|^#NRGC$|^#ENERGYCOIN$");
+
+inline bool IsRootNameValid(const std::string& name)
+{
+    return std::regex_match(name, ROOT_NAME_CHARACTERS)
+        && !std::regex_match(name, DOUBLE_PUNCTUATION)
+        && !std::regex_match(name, LEADING_PUNCTUATION)
+        && !std::regex_match(name, TRAILING_PUNCTUATION)
+        && !std::regex_match(name, NRGC_NAMES);
+}
+
+inline bool IsQualifierNameValid(const std::string& name)
+{
+    return std::regex_match(name, QUALIFIER_NAME_CHARACTERS)
+           && !std::regex_match(name, DOUBLE_PUNCTUATION)
+           && !std::regex_match(name, QUALIFIER_LEADING_PUNCTUATION)
+           && !std::regex_match(name, TRAILING_PUNCTUATION)
+           && !std::regex_match(name, NRGC_NAMES);
+}
+
+inline bool IsRestrictedNameValid(const std::string& name)
+{
+    return std::regex_match(name, RESTRICTED_NAME_CHARACTERS)
+           && !std::regex_match(name, DOUBLE_PUNCTUATION)
+           && !std::regex_match(name, LEADING_PUNCTUATION)
+           && !std::regex_match(name, TRAILING_PUNCTUATION)
+           && !std::regex_match(name, NRGC_NAMES);
+}
+
+inline bool IsSubQualifierNameValid(const std::string& name)
+{
+    return std::regex_match(name, SUB_QUALIFIER_NAME_CHARACTERS)
+           && !std::regex_match(name, DOUBLE_PUNCTUATION)
+           && !std::regex_match(name, LEADING_PUNCTUATION)
+           && !std::regex_match(name, TRAILING_PUNCTUATION);
+}
+
+inline bool IsSubNameValid(const std::string& name)
+{
+    return std::regex_match(name, SUB_NAME_CHARACTERS)
+        && !std::regex_match(name, DOUBLE_PUNCTUATION)
+        && !std::regex_match(name, LEADING_PUNCTUATION)
+        && !std::regex_match(name, TRAILING_PUNCTUATION);
+}
+
+inline bool IsUniqueTagValid(const std::string& tag)
+{
+    return std::regex_match(tag, UNIQUE_TAG_CHARACTERS);
+}
+
+inline bool IsVoteTagValid(const std::string& tag)
+{
+    return std::regex_match(tag, VOTE_TAG_CHARACTERS);
+}
+
+inline bool IsMsgChannelTagValid(const std::string &tag)
+{
+    return std::regex_match(tag, MSG_CHANNEL_TAG_CHARACTERS)
+        && !std::regex_match(tag, DOUBLE_PUNCTUATION)
+        && !std::regex_match(tag, LEADING_PUNCTUATION)
+        && !std::regex_match(tag, TRAILING_PUNCTUATION);
+}
+
+inline bool IsNameValidBeforeTag(const std::string& name)
+{
+    std::vector<std::string> parts;
+    boost::split(parts, name, boost::is_any_of(SUB_NAME_DELIMITER));
+
+    if (!IsRootNameValid(parts.front())) return false;
+
+    if (parts.size() > 1)
+    {
+        for (unsigned long i = 1; i < parts.size(); i++)
+        {
+            if (!IsSubNameValid(parts[i])) return false;
+        }
+    }
+
+    return true;
+}
+
+inline bool IsQualifierNameValidBeforeTag(const std::string& name)
+{
+    std::vector<std::string> parts;
+    boost::split(parts, name, boost::is_any_of(SUB_NAME_DELIMITER));
+
+    if (!IsQualifierNameValid(parts.front())) return false;
+
+    // Qualifiers can only have one sub qualifier under it
+    if (parts.size() > 2) {
+        return false;
+    }
+
+    if (parts.size() > 1)
+    {
+
+        for (unsigned long i = 1; i < parts.size(); i++)
+        {
+            if (!IsSubQualifierNameValid(parts[i])) return false;
+        }
+    }
+
+    return true;
+}
+
+inline bool IsAssetNameASubasset(const std::string& name)
+{
+    std::vector<std::string> parts;
+    boost::split(parts, name, boost::is_any_of(SUB_NAME_DELIMITER));
+
+    if (!IsRootNameValid(parts.front())) return false;
+
+    return parts.size() > 1;
+}
+
+inline bool IsAssetNameASubQualifier(const std::string& name)
+{
+    std::vector<std::string> parts;
+    boost::split(parts, name, boost::is_any_of(SUB_NAME_DELIMITER));
+
+    if (!IsQualifierNameValid(parts.front())) return false;
+
+    return parts.size() > 1;
+}
+
+
+inline bool IsAssetNameValid(const std::string& name, AssetType& assetType, std::string& error)
+{
+    // Do a max length check first to stop the possibility of a stack exhaustion.
+    // We check for a value that is larger than the max asset name
+    if (name.length() > 40)
+        return false;
+
+    assetType = AssetType::INVALID;
+    if (std::regex_match(name, UNIQUE_INDICATOR))
+    {
+        bool ret = asset_name_regex::IsTypeCheckNameValid(AssetType::UNIQUE, name, error);
+        if (ret)
+            assetType = AssetType::UNIQUE;
+
+        return ret;
+    }
+    else if (std::regex_match(name, MSG_CHANNEL_INDICATOR))
+    {
+        bool ret = asset_name_regex::IsTypeCheckNameValid(AssetType::MSGCHANNEL, name, error);
+        if (ret)
+            assetType = AssetType::MSGCHANNEL;
+
+        return ret;
+    }
+    else if (std::regex_match(name, OWNER_INDICATOR))
+    {
+        bool ret = asset_name_regex::IsTypeCheckNameValid(AssetType::OWNER, name, error);
+        if (ret)
+            assetType = AssetType::OWNER;
+
+        return ret;
+    }
+    else if (std::regex_match(name, VOTE_INDICATOR))
+    {
+        bool ret = asset_name_regex::IsTypeCheckNameValid(AssetType::VOTE, name, error);
+        if (ret)
+            assetType = AssetType::VOTE;
+
+        return ret;
+    }
+    else if (std::regex_match(name, QUALIFIER_INDICATOR))
+    {
+        bool ret = asset_name_regex::IsTypeCheckNameValid(AssetType::QUALIFIER, name, error);
+        if (ret) {
+            if (IsAssetNameASubQualifier(name))
+                assetType = AssetType::SUB_QUALIFIER;
+            else
+                assetType = AssetType::QUALIFIER;
+        }
+
+        return ret;
+    }
+    else if (std::regex_match(name, SUB_QUALIFIER_INDICATOR))
+    {
+        bool ret = asset_name_regex::IsTypeCheckNameValid(AssetType::SUB_QUALIFIER, name, error);
+        if (ret) {
+            if (IsAssetNameASubQualifier(name))
+                assetType = AssetType::SUB_QUALIFIER;
+        }
+
+        return ret;
+    }
+    else if (std::regex_match(name, RESTRICTED_INDICATOR))
+    {
+        bool ret = asset_name_regex::IsTypeCheckNameValid(AssetType::RESTRICTED, name, error);
+        if (ret)
+            assetType = AssetType::RESTRICTED;
+
+        return ret;
+    }
+    else
+    {
+        auto type = IsAssetNameASubasset(name) ? AssetType::SUB : AssetType::ROOT;
+        bool ret = asset_name_regex::IsTypeCheckNameValid(type, name, error);
+        if (ret)
+            assetType = type;
+
+        return ret;
+    }
+}
+
+inline bool IsAssetNameValid(const std::string& name)
+{
+    AssetType _assetType;
+    std::string _error;
+    return asset_name_regex::IsAssetNameValid(name, _assetType, _error);
+}
+
+inline bool IsAssetNameValid(const std::string& name, AssetType& assetType)
+{
+    std::string _error;
+    return asset_name_regex::IsAssetNameValid(name, assetType, _error);
+}
+
+inline bool IsAssetNameARoot(const std::string& name)
+{
+    AssetType type;
+    return asset_name_regex::IsAssetNameValid(name, type) && type == AssetType::ROOT;
+}
+
+inline bool IsAssetNameAnOwner(const std::string& name)
+{
+    return asset_name_regex::IsAssetNameValid(name) && std::regex_match(name, OWNER_INDICATOR);
+}
+
+inline bool IsAssetNameAnRestricted(const std::string& name)
+{
+    return asset_name_regex::IsAssetNameValid(name) && std::regex_match(name, RESTRICTED_INDICATOR);
+}
+
+inline bool IsAssetNameAQualifier(const std::string& name, bool fOnlyQualifiers)
+{
+    if (fOnlyQualifiers) {
+        return asset_name_regex::IsAssetNameValid(name) && std::regex_match(name, QUALIFIER_INDICATOR);
+    }
+
+    return asset_name_regex::IsAssetNameValid(name) && (std::regex_match(name, QUALIFIER_INDICATOR) || std::regex_match(name, SUB_QUALIFIER_INDICATOR));
+}
+
+inline bool IsAssetNameAnMsgChannel(const std::string& name)
+{
+    return asset_name_regex::IsAssetNameValid(name) && std::regex_match(name, MSG_CHANNEL_INDICATOR);
+}
+
+inline bool IsTypeCheckNameValid(const AssetType type, const std::string& name, std::string& error)
+{
+    if (type == AssetType::UNIQUE) {
+        if (name.size() > MAX_NAME_LENGTH) { error = "Name is greater than max length of " + std::to_string(MAX_NAME_LENGTH); return false; }
+        std::vector<std::string> parts;
+        boost::split(parts, name, boost::is_any_of(UNIQUE_TAG_DELIMITER));
+        bool valid = IsNameValidBeforeTag(parts.front()) && IsUniqueTagValid(parts.back());
+        if (!valid) { error = "Unique name contains invalid characters (Valid characters are: A-Z a-z 0-9 @ $ % & * ( ) [ ] { } _ . ? : -)";  return false; }
+        return true;
+    } else if (type == AssetType::MSGCHANNEL) {
+        if (name.size() > MAX_NAME_LENGTH) { error = "Name is greater than max length of " + std::to_string(MAX_NAME_LENGTH); return false; }
+        std::vector<std::string> parts;
+        boost::split(parts, name, boost::is_any_of(MSG_CHANNEL_TAG_DELIMITER));
+        bool valid = IsNameValidBeforeTag(parts.front()) && IsMsgChannelTagValid(parts.back());
+        if (parts.back().size() > MAX_CHANNEL_NAME_LENGTH) { error = "Channel name is greater than max length of " + std::to_string(MAX_CHANNEL_NAME_LENGTH); return false; }
+        if (!valid) { error = "Message Channel name contains invalid characters (Valid characters are: A-Z 0-9 _ .) (special characters can't be the first or last characters)";  return false; }
+        return true;
+    } else if (type == AssetType::OWNER) {
+        if (name.size() > MAX_NAME_LENGTH) { error = "Name is greater than max length of " + std::to_string(MAX_NAME_LENGTH); return false; }
+        bool valid = IsNameValidBeforeTag(name.substr(0, name.size() - 1));
+        if (!valid) { error = "Owner name contains invalid characters (Valid characters are: A-Z 0-9 _ .) (special characters can't be the first or last characters)";  return false; }
+        return true;
+    } else if (type == AssetType::VOTE) {
+        if (name.size() > MAX_NAME_LENGTH) { error = "Name is greater than max length of " + std::to_string(MAX_NAME_LENGTH); return false; }
+        std::vector<std::string> parts;
+        boost::split(parts, name, boost::is_any_of(VOTE_TAG_DELIMITER));
+        bool valid = IsNameValidBeforeTag(parts.front()) && IsVoteTagValid(parts.back());
+        if (!valid) { error = "Vote name contains invalid characters (Valid characters are: A-Z 0-9 _ .) (special characters can't be the first or last characters)";  return false; }
+        return true;
+    } else if (type == AssetType::QUALIFIER || type == AssetType::SUB_QUALIFIER) {
+        if (name.size() > MAX_NAME_LENGTH) { error = "Name is greater than max length of " + std::to_string(MAX_NAME_LENGTH); return false; }
+        bool valid = IsQualifierNameValidBeforeTag(name);
+        if (!valid) { error = "Qualifier name contains invalid characters (Valid characters are: A-Z 0-9 _ .) (# must be the first character, _ . special characters can't be the first or last characters)";  return false; }
+        return true;
+    } else if (type == AssetType::RESTRICTED) {
+        if (name.size() > MAX_NAME_LENGTH) { error = "Name is greater than max length of " + std::to_string(MAX_NAME_LENGTH); return false; }
+        bool valid = IsRestrictedNameValid(name);
+        if (!valid) { error = "Restricted name contains invalid characters (Valid characters are: A-Z 0-9 _ .) ($ must be the first character, _ . special characters can't be the first or last characters)";  return false; }
+        return true;
+    } else {
+        if (name.size() > MAX_NAME_LENGTH - 1) { error = "Name is greater than max length of " + std::to_string(MAX_NAME_LENGTH - 1); return false; }  //Assets and sub-assets need to leave one extra char for OWNER indicator
+        if (!IsAssetNameASubasset(name) && name.size() < MIN_ASSET_LENGTH) { error = "Name must be contain " + std::to_string(MIN_ASSET_LENGTH) + " characters"; return false; }
+        bool valid = IsNameValidBeforeTag(name);
+        if (!valid && IsAssetNameASubasset(name) && name.size() < 3) { error = "Name must have at least 3 characters (Valid characters are: A-Z 0-9 _ .)";  return false; }
+        if (!valid) { error = "Name contains invalid characters (Valid characters are: A-Z 0-9 _ .) (special characters can't be the first or last characters)";  return false; }
+        return true;
+    }
+}
+
+/** Whether the asset name validation in assets/assets.cpp agrees with this reference on name. */
+inline bool MatchesAssetNameValidation(const std::string& name)
+{
+    AssetType type = AssetType::INVALID, typeRegex = AssetType::INVALID;
+    std::string error, errorRegex;
+    if (::IsAssetNameValid(name, type, error) != asset_name_regex::IsAssetNameValid(name, typeRegex, errorRegex) || type != typeRegex || error != errorRegex)
+        return false;
+
+    for (int nType = 0; nType <= (int)AssetType::INVALID; nType++) {
+        error.clear();
+        errorRegex.clear();
+        if (::IsTypeCheckNameValid((AssetType)nType, name, error) != asset_name_regex::IsTypeCheckNameValid((AssetType)nType, name, errorRegex) || error != errorRegex)
+            return false;
+    }
+
+    return ::IsUniqueTagValid(name) == IsUniqueTagValid(name)
+        && ::IsAssetNameASubasset(name) == IsAssetNameASubasset(name)
+        && ::IsAssetNameASubQualifier(name) == IsAssetNameASubQualifier(name)
+        && ::IsAssetNameARoot(name) == IsAssetNameARoot(name)
+        && ::IsAssetNameAnOwner(name) == IsAssetNameAnOwner(name)
+        && ::IsAssetNameAnRestricted(name) == IsAssetNameAnRestricted(name)
+        && ::IsAssetNameAQualifier(name, true) == IsAssetNameAQualifier(name, true)
+        && ::IsAssetNameAQualifier(name, false) == IsAssetNameAQualifier(name, false)
+        && ::IsAssetNameAnMsgChannel(name) == IsAssetNameAnMsgChannel(name);
+}
+
+} // namespace asset_name_regex
+
+#endif // NRGC_TEST_ASSETS_ASSET_NAME_REGEX_H
@@ -15,6 +15,8 @@
 #include <chainparams.h>
 
 #include "LibBoolEE.h"
+#include "random.h"
+#include "test/assets/asset_name_regex.h"
 
 BOOST_FIXTURE_TEST_SUITE(asset_tests, BasicTestingSetup)
 
@@ -221,6 +223,31 @@ BOOST_FIXTURE_TEST_SUITE(asset_tests, BasicTestingSetup)
         BOOST_CHECK(!IsAssetNameValid("$ABC#NO"));
     }
 
+    BOOST_AUTO_TEST_CASE(name_validation_regex_differential_tests)
+    {
+        BOOST_TEST_MESSAGE("Running Name Validation Regex Differential Test");
+
+        // Mutations of names of every type, over the characters the validators treat specially
+        static const std::vector<std::string> seeds = {"", "NRGC", "ENERGYCOIN", "#NRGC", "ABC", "ABC/SUB", "ABC#TAG",
+                                                       "ABC~CHAN", "ABC^VOTE", "ABC!", "#QUAL", "#QUAL/#SUB", "$REST"};
+        static const std::string alphabet = "AZ09._/#~^!$az@-()[]{}?:% \n";
+        FastRandomContext rng(true);
+        for (int i = 0; i < 20000; i++) {
+            std::string name = seeds[rng.randrange(seeds.size())];
+            int nMutations = rng.randrange(8);
+            for (int j = 0; j < nMutations; j++) {
+                size_t nPos = rng.randrange(name.size() + 1);
+                if (rng.randbool() || nPos == name.size())
+                    name.insert(nPos, 1, alphabet[rng.randrange(alphabet.size())]);
+                else
+                    name.erase(nPos, 1);
+            }
+            if (rng.randrange(16) == 0)
+                name.append(rng.randrange(40), 'A');
+            BOOST_CHECK_MESSAGE(asset_name_regex::MatchesAssetNameValidation(name), "mismatch for \"" + name + "\"");
+        }
+    }
+
     BOOST_AUTO_TEST_CASE(transfer_asset_coin_test)
     {
         BOOST_TEST_MESSAGE("Running Transfer Asset Coin Test");
@@ -3,6 +3,9 @@
 #include <boost/test/unit_test.hpp>
 #include <test/test_nrgc.h>
 
+#include <atomic>
+#include <thread>
+
 BOOST_FIXTURE_TEST_SUITE(cache_tests, BasicTestingSetup)
 
 
@@ -37,5 +40,93 @@ BOOST_AUTO_TEST_CASE(cache_test)
 
 }
 
+BOOST_AUTO_TEST_CASE(cache_counters_test)
+{
+    BOOST_TEST_MESSAGE("Running Cache Counters Test");
+
+    CLRUCache<std::string, int> cache(3);
+    cache.Put("A", 1);
+    cache.Put("B", 2);
+    cache.Put("C", 3);
+
+    // Touching A makes B the least recently used
+    int value = 0;
+    BOOST_CHECK(cache.TryGet("A", value));
+    BOOST_CHECK_EQUAL(value, 1);
+    cache.Put("D", 4);
+    BOOST_CHECK(!cache.Exists("B"));
+    BOOST_CHECK(cache.Exists("A"));
+    BOOST_CHECK_EQUAL(cache.Size(), 3U);
+
+    // Overwriting a key doesn't evict
+    cache.Put("C", 30);
+    BOOST_CHECK_EQUAL(cache.Get("C"), 30);
+    BOOST_CHECK(!cache.TryGet("B", value));
+    BOOST_CHECK_THROW(cache.Get("B"), std::range_error);
+
+    BOOST_CHECK_EQUAL(cache.Hits(), 2U);
+    BOOST_CHECK_EQUAL(cache.Misses(), 2U);
+    BOOST_CHECK_EQUAL(cache.Evictions(), 1U);
+
+    // Erased nodes are reused
+    cache.Erase("A");
+    cache.Put("E", 5);
+    BOOST_CHECK_EQUAL(cache.Size(), 3U);
+    BOOST_CHECK_EQUAL(cache.Evictions(), 1U);
+
+    std::vector<std::string> vKeys;
+    cache.ForEach([&vKeys](const std::string& key, const int&) { vKeys.push_back(key); });
+    BOOST_CHECK(vKeys == std::vector<std::string>({"E", "C", "D"}));
+
+    // Shrinking evicts the least recently used entries
+    cache.SetSize(1);
+    BOOST_CHECK_EQUAL(cache.Size(), 1U);
+    BOOST_CHECK(cache.Exists("E"));
+}
+
+BOOST_AUTO_TEST_CASE(sharded_cache_test)
+{
+    BOOST_TEST_MESSAGE("Running Sharded Cache Test");
+
+    CShardedLRUCache<std::string, int, 4> cache(1000);
+    for (int i = 0; i < 100; i++)
+        cache.Put("TEST" + std::to_string(i), i);
+    BOOST_CHECK_EQUAL(cache.Size(), 100U);
+    BOOST_CHECK_EQUAL(cache.MaxSize(), 1000U);
+
+    int value;
+    BOOST_CHECK(cache.TryGet("TEST42", value));
+    BOOST_CHECK_EQUAL(value, 42);
+    BOOST_CHECK_EQUAL(cache.Get("TEST7"), 7);
+    BOOST_CHECK(!cache.TryGet("NOTCACHED", value));
+    cache.Erase("TEST42");
+    BOOST_CHECK(!cache.Exists("TEST42"));
+    BOOST_CHECK_EQUAL(cache.Hits(), 2U);
+    BOOST_CHECK_EQUAL(cache.Misses(), 1U);
+
+    // Concurrent readers and writers never see a torn entry
+    std::atomic<int> nBadReads{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([&cache, &nBadReads, t] {
+            for (int i = 0; i < 5000; i++) {
+                std::string key = "KEY" + std::to_string((i * 7 + t) % 2000);
+                int value;
+                if (cache.TryGet(key, value)) {
+                    if ("KEY" + std::to_string(value) != key)
+                        nBadReads++;
+                } else
+                    cache.Put(key, (i * 7 + t) % 2000);
+            }
+        });
+    }
+    for (std::thread& thread : threads)
+        thread.join();
+
+    BOOST_CHECK_EQUAL(nBadReads, 0);
+    BOOST_CHECK(cache.Size() <= cache.MaxSize());
+    BOOST_CHECK(cache.Evictions() > 0);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
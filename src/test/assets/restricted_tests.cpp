@@ -10,6 +10,7 @@
 #include <amount.h>
 #include <base58.h>
 #include <chainparams.h>
+#include <validation.h>
 
 BOOST_FIXTURE_TEST_SUITE(restricted_tests, BasicTestingSetup)
 
@@ -185,4 +186,39 @@ BOOST_FIXTURE_TEST_SUITE(restricted_tests, BasicTestingSetup)
     }
 
 
+
+    BOOST_FIXTURE_TEST_CASE(restricted_asset_check_test, TestingSetup)
+    {
+        BOOST_TEST_MESSAGE("Running Restricted Asset Check Test");
+
+        LOCK(cs_main);
+        CAssetsCache setup(passets);
+        BOOST_CHECK(setup.AddNewAsset(CNewAsset("#CHECKKYC", 1 * COIN), "address", 1, uint256()));
+        BOOST_CHECK(setup.AddQualifierAddress("#CHECKKYC", "tagged", QualifierType::ADD_QUALIFIER));
+        BOOST_CHECK(setup.AddRestrictedVerifier("$CHECKA", "true"));
+        BOOST_CHECK(setup.AddRestrictedAddress("$CHECKA", "frozen", RestrictedType::FREEZE_ADDRESS));
+        BOOST_CHECK(setup.AddRestrictedVerifier("$CHECKB", "CHECKKYC"));
+        BOOST_CHECK(setup.AddRestrictedVerifier("$CHECKG", "true"));
+        BOOST_CHECK(setup.AddGlobalRestricted("$CHECKG", RestrictedType::GLOBAL_FREEZE));
+        BOOST_CHECK(setup.Flush());
+
+        // The block's cache, the checks read the cache below it
+        CAssetsCache blockCache(passets);
+        uint256 txHash;
+
+        BOOST_CHECK(CAssetCheck()());
+        BOOST_CHECK(CAssetCheck(CAssetCheck::FROZEN_ADDRESS, "$CHECKA", "tagged", &blockCache, txHash)());
+        BOOST_CHECK(!CAssetCheck(CAssetCheck::FROZEN_ADDRESS, "$CHECKA", "frozen", &blockCache, txHash)());
+        BOOST_CHECK(CAssetCheck(CAssetCheck::RESTRICTED_TRANSFER, "$CHECKA", "frozen", &blockCache, txHash)());
+        BOOST_CHECK(CAssetCheck(CAssetCheck::RESTRICTED_TRANSFER, "$CHECKB", "tagged", &blockCache, txHash)());
+        BOOST_CHECK(!CAssetCheck(CAssetCheck::RESTRICTED_TRANSFER, "$CHECKB", "untagged", &blockCache, txHash)());
+        BOOST_CHECK(!CAssetCheck(CAssetCheck::RESTRICTED_TRANSFER, "$CHECKG", "tagged", &blockCache, txHash)());
+
+        // Changes made by the block itself don't affect its checks
+        BOOST_CHECK(blockCache.AddRestrictedAddress("$CHECKA", "tagged", RestrictedType::FREEZE_ADDRESS));
+        BOOST_CHECK(blockCache.AddGlobalRestricted("$CHECKB", RestrictedType::GLOBAL_FREEZE));
+        BOOST_CHECK(CAssetCheck(CAssetCheck::FROZEN_ADDRESS, "$CHECKA", "tagged", &blockCache, txHash)());
+        BOOST_CHECK(CAssetCheck(CAssetCheck::RESTRICTED_TRANSFER, "$CHECKB", "tagged", &blockCache, txHash)());
+    }
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -157,6 +157,50 @@ BOOST_FIXTURE_TEST_SUITE(verifier_string_tests, BasicTestingSetup)
         BOOST_CHECK_THROW(LibBoolEE::resolve(bad_syntax_after_true_statement, vals), std::runtime_error);
     }
 
+    BOOST_AUTO_TEST_CASE(compiled_verifier_test)
+    {
+        BOOST_TEST_MESSAGE("Running Compiled Verifier Test");
+
+        // The compiled program must agree with resolve under every valuation of its variables
+        std::vector<std::string> valid_formulas = {"KYC", "!KYC", "KYC&ABC", "KYC|ABC&DEF", "(KYC|ABC)&!DEF", "!(KYC&ABC)|DEF&(GHI|!RET)",
+                                                   "1&KYC", "0|KYC", "!!KYC", "((KYC))", "KYC&ABC&DEF&GHI|RET", "KYC | ABC & ( DEF | !GHI ) & KYC"};
+        for (const auto& formula : valid_formulas) {
+            LibBoolEE::Program program = LibBoolEE::compile(formula);
+            const std::vector<std::string>& variables = program.variables();
+            for (uint64_t valuation = 0; valuation < (static_cast<uint64_t>(1) << variables.size()); valuation++) {
+                LibBoolEE::Vals vals;
+                for (size_t i = 0; i < variables.size(); i++)
+                    vals.insert(std::make_pair(variables[i], ((valuation >> i) & 1) != 0));
+                BOOST_CHECK_MESSAGE(program.evaluate(valuation) == LibBoolEE::resolve(formula, vals), "Compiled formula disagrees with resolve - " + formula);
+            }
+        }
+
+        // It rejects the malformed formulas resolve rejects, unknown variables are only found when they are looked up
+        std::vector<std::string> invalid_formulas = {"", "!", "KYC&", "(KYC", "KYC)", "KYC||ABC", "KYC~ABC", "(KYC)ABC", "&"};
+        for (const auto& formula : invalid_formulas) {
+            LibBoolEE::Vals vals = {{"KYC", true}, {"ABC", true}};
+            BOOST_CHECK_THROW(LibBoolEE::resolve(formula, vals), std::runtime_error);
+            BOOST_CHECK_THROW(LibBoolEE::compile(formula), std::runtime_error);
+        }
+
+        // Variables are interned
+        BOOST_CHECK_EQUAL(LibBoolEE::compile("KYC&ABC|!KYC").variables().size(), 2);
+
+        // Formulas past the limits of the program are left to resolve
+        std::string too_many_variables = "Q0";
+        for (int i = 1; i <= 64; i++)
+            too_many_variables += "|Q" + std::to_string(i);
+        BOOST_CHECK_THROW(LibBoolEE::compile(too_many_variables), std::runtime_error);
+        std::string too_deep = "KYC";
+        for (int i = 0; i < 64; i++)
+            too_deep = "KYC&(" + too_deep + ")";
+        BOOST_CHECK_THROW(LibBoolEE::compile(too_deep), std::runtime_error);
+        BOOST_CHECK(LibBoolEE::resolve(too_deep, {{"KYC", true}}));
+
+        BOOST_CHECK(GetCompiledVerifierString("$COMPILED", "KYC&!ABC"));
+        BOOST_CHECK(!GetCompiledVerifierString("$COMPILED", "KYC&(ABC"));
+        BOOST_CHECK(!GetCompiledVerifierString("$COMPILED", "#KYC"));
+    }
 
     BOOST_AUTO_TEST_CASE(verifier_check_asset_txout)
     {
@@ -5,6 +5,8 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include "hash.h"
+#include "algo/x16r_multi.h"
+#include "random.h"
 #include "utilstrencodings.h"
 #include "test/test_nrgc.h"
 #include "consensus/merkle.h"
@@ -108,6 +110,35 @@ BOOST_FIXTURE_TEST_SUITE(hash_tests, BasicTestingSetup)
 
     };
 
+    BOOST_AUTO_TEST_CASE(hash16R_multi_test)
+    {
+        BOOST_TEST_MESSAGE("Running Hash16R Multi Test");
+
+        // Enough inputs that every algorithm sees several full groups of lanes in most rounds,
+        // plus a few odd lengths to exercise the scalar fallback.
+        FastRandomContext rng(true);
+        std::vector<std::vector<unsigned char>> vInputs;
+        std::vector<X16RMultiJob> vJobs;
+        for (int i = 0; i < 600; i++) {
+            size_t nLen = i % 50 == 0 ? rng.randrange(200) : 80;
+            vInputs.push_back(rng.randbytes(nLen));
+        }
+        for (int i = 0; i < 600; i++) {
+            const std::vector<unsigned char>& vInput = vInputs[i];
+            vJobs.emplace_back(vInput.data(), vInput.data() + vInput.size(), rng.rand256(), i % 3 == 0);
+        }
+
+        HashX16RMulti(vJobs);
+
+        for (const X16RMultiJob& job : vJobs) {
+            if (job.fV2) {
+                BOOST_CHECK(job.hash == HashX16RV2(job.pbegin, job.pend, job.hashPrevBlock));
+            } else {
+                BOOST_CHECK(job.hash == HashX16R(job.pbegin, job.pend, job.hashPrevBlock));
+            }
+        }
+    }
+
     BOOST_AUTO_TEST_CASE(siphash_test)
     {
         BOOST_TEST_MESSAGE("Running SipHash Test");
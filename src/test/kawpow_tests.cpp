@@ -3,6 +3,10 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 
+#include <arith_uint256.h>
+#include <hash.h>
+#include <miner.h>
+#include <random.h>
 #include <test/test_nrgc.h>
 
 #include <boost/test/unit_test.hpp>
@@ -139,4 +143,86 @@ BOOST_AUTO_TEST_CASE(kawpow_search)
     BOOST_CHECK(sr.mix_hash == r.mix_hash);
 }
 
+BOOST_AUTO_TEST_CASE(kawpow_global_context_prebuild)
+{
+    // An epoch no other test uses, so nothing has built its global context yet
+    constexpr int epoch_number = 9;
+    BOOST_CHECK(ethash::try_get_global_epoch_context(epoch_number) == nullptr);
+
+    ethash::prebuild_global_epoch_context(epoch_number);
+    const ethash::epoch_context* global = ethash::try_get_global_epoch_context(epoch_number);
+    BOOST_REQUIRE(global != nullptr);
+    BOOST_CHECK(global == &ethash::get_global_epoch_context(epoch_number));
+
+    auto context = ethash::create_epoch_context(epoch_number);
+    BOOST_CHECK_EQUAL(global->epoch_number, epoch_number);
+    BOOST_CHECK_EQUAL(global->light_cache_num_items, context->light_cache_num_items);
+    BOOST_CHECK(memcmp(global->light_cache, context->light_cache, ethash::get_light_cache_size(context->light_cache_num_items)) == 0);
+    BOOST_CHECK(memcmp(global->l1_cache, context->l1_cache, progpow::l1_cache_size) == 0);
+}
+
+BOOST_AUTO_TEST_CASE(kawpow_binary_hashes)
+{
+    // The binary conversions give the hashes the hex string round trips gave
+    FastRandomContext rng(true);
+    for (int i = 0; i < 8; i++) {
+        uint256 hash = rng.rand256();
+        BOOST_CHECK(ToEthashHash(hash) == to_hash256(hash.GetHex()));
+        BOOST_CHECK(FromEthashHash(ToEthashHash(hash)) == hash);
+        BOOST_CHECK(FromEthashHash(ToEthashHash(hash)) == uint256S(to_hex(to_hash256(hash.GetHex()))));
+    }
+
+    const uint256 header_hash = rng.rand256();
+    const auto result = progpow::hash(get_ethash_epoch_context_0(), 30, to_hash256(header_hash.GetHex()), 395);
+    uint256 mix_hash;
+    BOOST_CHECK(KAWPOWHash(header_hash, 30, 395, mix_hash) == uint256S(to_hex(result.final_hash)));
+    BOOST_CHECK(mix_hash == uint256S(to_hex(result.mix_hash)));
+    BOOST_CHECK(KAWPOWHash_OnlyMix(header_hash, 30, 395, mix_hash) == uint256S(to_hex(result.final_hash)));
+}
+
+BOOST_AUTO_TEST_CASE(kawpow_scan_block_nonces)
+{
+    CBlock block;
+    block.nVersion = 4;
+    block.hashPrevBlock = GetRandHash();
+    block.hashMerkleRoot = GetRandHash();
+    block.nTime = std::max<uint32_t>(nKAWPOWActivationTime, 1);
+    block.nBits = 0x207fffff;
+    block.nHeight = 30;
+
+    // Every hash meets the highest target, so the first nonce wins
+    uint64_t nHashes = 0;
+    BOOST_CHECK(ScanBlockNonces(&block, ~arith_uint256(), 100, 16, nHashes));
+    BOOST_CHECK_EQUAL(nHashes, 1U);
+    BOOST_CHECK_EQUAL(block.nNonce64, 100U);
+    uint256 mix_hash;
+    BOOST_CHECK(KAWPOWHash(block, mix_hash) == block.GetHash());
+    BOOST_CHECK(mix_hash == block.mix_hash);
+
+    // No hash meets a zero target
+    BOOST_CHECK(!ScanBlockNonces(&block, arith_uint256(), 0, 4, nHashes));
+    BOOST_CHECK_EQUAL(nHashes, 4U);
+
+    // With the lowest of the hashes as the target both the light cache and the full dataset find its nonce
+    const uint256 header_hash = block.GetKAWPOWHeaderHash();
+    arith_uint256 hashLowest = ~arith_uint256();
+    uint64_t nLowest = 0;
+    for (uint64_t nNonce = 0; nNonce < 8; nNonce++) {
+        arith_uint256 hash = UintToArith256(KAWPOWHash(header_hash, block.nHeight, nNonce, mix_hash));
+        if (hash < hashLowest) {
+            hashLowest = hash;
+            nLowest = nNonce;
+        }
+    }
+    for (bool fFullDataset : {false, true}) {
+        block.nNonce64 = 0;
+        block.mix_hash.SetNull();
+        BOOST_CHECK(ScanBlockNonces(&block, hashLowest, 0, 8, nHashes, fFullDataset));
+        BOOST_CHECK_EQUAL(nHashes, nLowest + 1);
+        BOOST_CHECK_EQUAL(block.nNonce64, nLowest);
+        BOOST_CHECK(UintToArith256(KAWPOWHash(block, mix_hash)) == hashLowest);
+        BOOST_CHECK(mix_hash == block.mix_hash);
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -4,7 +4,9 @@
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
+#include "arith_uint256.h"
 #include "chainparams.h"
+#include "consensus/validation.h"
 #include "validation.h"
 #include "net.h"
 
@@ -88,4 +90,36 @@ BOOST_FIXTURE_TEST_SUITE(main_tests, TestingSetup)
         BOOST_CHECK(Test());
     }
 
+    BOOST_AUTO_TEST_CASE(process_new_block_headers_pow_test)
+    {
+        BOOST_TEST_MESSAGE("Running ProcessNewBlockHeaders PoW Test");
+
+        const CChainParams& chainparams = GetParams();
+        const CBlock& genesis = chainparams.GenesisBlock();
+
+        // A KAWPOW header on top of genesis that cannot meet the target
+        CBlockHeader header;
+        header.nVersion = genesis.nVersion;
+        header.hashPrevBlock = genesis.GetHash();
+        header.nTime = nKAWPOWActivationTime;
+        header.nBits = UintToArith256(chainparams.GetConsensus().powLimit).GetCompact();
+        header.nHeight = 1;
+        header.nNonce64 = 1;
+
+        // Checked on the header check threads, and serially in the calling thread
+        const int nThreads = nScriptCheckThreads;
+        for (int nCheckThreads : {nThreads, 0}) {
+            nScriptCheckThreads = nCheckThreads;
+            std::vector<CBlockHeader> headers = {genesis.GetBlockHeader(), header};
+            CValidationState state;
+            CBlockHeader first_invalid;
+            BOOST_CHECK(!ProcessNewBlockHeaders(headers, state, chainparams, nullptr, &first_invalid));
+            BOOST_CHECK_EQUAL(state.GetRejectReason(), "high-hash");
+            BOOST_CHECK(first_invalid.GetHash() == header.GetHash());
+            LOCK(cs_main);
+            BOOST_CHECK(!mapBlockIndex.count(header.GetHash()));
+        }
+        nScriptCheckThreads = nThreads;
+    }
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -598,4 +598,57 @@ BOOST_FIXTURE_TEST_SUITE(mempool_tests, TestingSetup)
         SetMockTime(0);
     }
 
+    BOOST_AUTO_TEST_CASE(mempool_restriction_index_test)
+    {
+        typedef CMemPoolRestrictionIndex::Kind Kind;
+        CTxMemPool pool;
+        TestMemPoolEntryHelper entry;
+        LOCK(pool.cs);
+
+        CMutableTransaction txFreeze;
+        txFreeze.vin.resize(1);
+        txFreeze.vin[0].scriptSig = CScript() << OP_11;
+        txFreeze.vout.resize(1);
+        txFreeze.vout[0].scriptPubKey = CScript() << OP_11 << OP_EQUAL;
+        txFreeze.vout[0].nValue = 10 * COIN;
+        CMutableTransaction txTransfer = txFreeze;
+        txTransfer.vin[0].scriptSig = CScript() << OP_12;
+        txTransfer.vin[0].prevout = COutPoint(uint256S("01"), 0);
+        pool.addUnchecked(txFreeze.GetHash(), entry.FromTx(txFreeze));
+        pool.addUnchecked(txTransfer.GetHash(), entry.FromTx(txTransfer));
+
+        pool.restrictionIndex.Add(Kind::GLOBAL_FREEZING, txFreeze.GetHash(), "$RESTRICTED");
+        pool.restrictionIndex.Add(Kind::ASSET_GLOBAL_FROZEN, txTransfer.GetHash(), "$RESTRICTED");
+        pool.restrictionIndex.Add(Kind::ADDRESS_FROZEN, txTransfer.GetHash(), "address", "$RESTRICTED");
+        pool.restrictionIndex.Add(Kind::ADDRESS_FROZEN, txFreeze.GetHash(), "address", "$RESTRICTED");
+        pool.restrictionIndex.Add(Kind::ADDRESS_FROZEN, txFreeze.GetHash(), "address", "$RESTRICTED");
+
+        BOOST_CHECK(pool.restrictionIndex.Contains(Kind::GLOBAL_FREEZING, "$RESTRICTED"));
+        BOOST_CHECK(!pool.restrictionIndex.Contains(Kind::GLOBAL_UNFREEZING, "$RESTRICTED"));
+        BOOST_CHECK(!pool.restrictionIndex.Contains(Kind::ADDRESS_FROZEN, "$RESTRICTED", "address"));
+        BOOST_CHECK(!pool.restrictionIndex.Contains(Kind::ADDRESS_FROZEN, "other", "$RESTRICTED"));
+        BOOST_CHECK_EQUAL(pool.restrictionIndex.GetTxs(Kind::ADDRESS_FROZEN, "address", "$RESTRICTED").size(), 2);
+        BOOST_CHECK(pool.restrictionIndex.GetTxs(Kind::VERIFIER_CHANGED, "$RESTRICTED").empty());
+        BOOST_CHECK_EQUAL(pool.restrictionIndex.GetKeyCount(), 3);
+        BOOST_CHECK_EQUAL(pool.restrictionIndex.GetStringCount(), 2);
+
+        // Removing a transaction from the mempool removes it from every key it was added under
+        pool.removeRecursive(txFreeze);
+        BOOST_CHECK(!pool.restrictionIndex.Contains(Kind::GLOBAL_FREEZING, "$RESTRICTED"));
+        std::vector<uint256> vHashes = pool.restrictionIndex.GetTxs(Kind::ADDRESS_FROZEN, "address", "$RESTRICTED");
+        BOOST_CHECK(vHashes == std::vector<uint256>{txTransfer.GetHash()});
+        BOOST_CHECK_EQUAL(pool.restrictionIndex.GetKeyCount(), 2);
+
+        // Strings are released with the last key that uses them
+        pool.removeRecursive(txTransfer);
+        BOOST_CHECK_EQUAL(pool.restrictionIndex.GetKeyCount(), 0);
+        BOOST_CHECK_EQUAL(pool.restrictionIndex.GetStringCount(), 0);
+
+        pool.restrictionIndex.Add(Kind::ADDRESS_ADDED_TAG, txFreeze.GetHash(), "address", "#TAG");
+        BOOST_CHECK(pool.restrictionIndex.Contains(Kind::ADDRESS_ADDED_TAG, "address", "#TAG"));
+        pool.clear();
+        BOOST_CHECK(!pool.restrictionIndex.Contains(Kind::ADDRESS_ADDED_TAG, "address", "#TAG"));
+        BOOST_CHECK_EQUAL(pool.restrictionIndex.GetStringCount(), 0);
+    }
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -14,6 +14,8 @@
 #include "miner.h"
 #include "policy/policy.h"
 #include "pubkey.h"
+#include "random.h"
+#include "script/sign.h"
 #include "script/standard.h"
 #include "txmempool.h"
 #include "uint256.h"
@@ -658,4 +660,111 @@ BOOST_FIXTURE_TEST_SUITE(miner_tests, TestingSetup)
         fCheckpointsEnabled = true;
     }
 
+    BOOST_FIXTURE_TEST_CASE(createnewblock_last_template_test, TestChain100Setup)
+    {
+        const CChainParams& chainparams = GetParams();
+        CScript scriptPubKey = CScript() << ToByteVector(coinbaseKey.GetPubKey()) << OP_CHECKSIG;
+
+        // Mature three more coinbases, then spend four, each paying a higher fee than the one before
+        for (int i = 0; i < 3; i++)
+            CreateAndProcessBlock({}, scriptPubKey);
+        std::vector<CMutableTransaction> spends(4);
+        for (int i = 0; i < 4; i++) {
+            spends[i].nVersion = 1;
+            spends[i].vin.resize(1);
+            spends[i].vin[0].prevout = COutPoint(coinbaseTxns[i].GetHash(), 0);
+            spends[i].vout.resize(1);
+            spends[i].vout[0].nValue = coinbaseTxns[i].vout[0].nValue - (i + 1) * 100000;
+            spends[i].vout[0].scriptPubKey = scriptPubKey;
+
+            std::vector<unsigned char> vchSig;
+            uint256 hash = SignatureHash(scriptPubKey, spends[i], 0, SIGHASH_ALL, 0, SIGVERSION_BASE);
+            BOOST_CHECK(coinbaseKey.Sign(hash, vchSig));
+            vchSig.push_back((unsigned char) SIGHASH_ALL);
+            spends[i].vin[0].scriptSig << vchSig;
+        }
+
+        auto ToMemPool = [](const CMutableTransaction& tx) {
+            LOCK(cs_main);
+            CValidationState state;
+            return AcceptToMemoryPool(mempool, state, MakeTransactionRef(tx), nullptr, nullptr, true, 0);
+        };
+        auto CheckTemplate = [&](const std::vector<int>& vExpected) {
+            std::unique_ptr<CBlockTemplate> pblocktemplate = AssemblerForTest(chainparams).CreateNewBlock(scriptPubKey);
+            BOOST_REQUIRE_EQUAL(pblocktemplate->block.vtx.size(), vExpected.size() + 1);
+            for (size_t i = 0; i < vExpected.size(); i++)
+                BOOST_CHECK(pblocktemplate->block.vtx[i + 1]->GetHash() == spends[vExpected[i]].GetHash());
+        };
+
+        BOOST_CHECK(ToMemPool(spends[0]));
+        BOOST_CHECK(ToMemPool(spends[1]));
+        CheckTemplate({1, 0});
+
+        // The next template starts with the transactions of the last one and adds the new one after them
+        BOOST_CHECK(ToMemPool(spends[2]));
+        CheckTemplate({1, 0, 2});
+
+        // When one of them left the mempool all transactions are selected again
+        {
+            LOCK(mempool.cs);
+            mempool.removeRecursive(spends[0]);
+        }
+        CheckTemplate({2, 1});
+        BOOST_CHECK(ToMemPool(spends[0]));
+        CheckTemplate({2, 1, 0});
+
+        // So are they after a while
+        BOOST_CHECK(ToMemPool(spends[3]));
+        CheckTemplate({2, 1, 0, 3});
+        SetMockTime(GetTime() + 60);
+        CheckTemplate({3, 2, 1, 0});
+
+        SetMockTime(0);
+        mempool.clear();
+    }
+
+    BOOST_AUTO_TEST_CASE(kawpow_template_store_test)
+    {
+        CKAWPOWTemplateStore store(3);
+        std::vector<uint256> vHeaderHashes;
+        for (uint32_t i = 0; i < 4; i++) {
+            CBlock block;
+            block.nHeight = 10 + i;
+            block.vtx.push_back(MakeTransactionRef(CMutableTransaction()));
+            vHeaderHashes.push_back(GetRandHash());
+            store.Add(vHeaderHashes.back(), std::make_shared<const CBlock>(block));
+        }
+
+        // The oldest template made room for the fourth
+        CKAWPOWTemplateStore::Stats stats = store.GetStats();
+        BOOST_CHECK_EQUAL(stats.nTemplates, 3U);
+        BOOST_CHECK_EQUAL(stats.nEvictions, 1U);
+        BOOST_CHECK(stats.nMemoryUsage > 0);
+        BOOST_CHECK(!store.Get(vHeaderHashes[0]));
+        BOOST_REQUIRE(store.Get(vHeaderHashes[1]));
+        BOOST_CHECK_EQUAL(store.Get(vHeaderHashes[1])->nHeight, 11U);
+        stats = store.GetStats();
+        BOOST_CHECK_EQUAL(stats.nHits, 2U);
+        BOOST_CHECK_EQUAL(stats.nMisses, 1U);
+
+        // Looking up the second template made the third the least recently used
+        CBlock block;
+        block.nHeight = 14;
+        store.Add(GetRandHash(), std::make_shared<const CBlock>(block));
+        BOOST_CHECK(store.Exists(vHeaderHashes[1]));
+        BOOST_CHECK(!store.Exists(vHeaderHashes[2]));
+        BOOST_CHECK(store.Exists(vHeaderHashes[3]));
+
+        store.RemoveBelowHeight(13);
+        stats = store.GetStats();
+        BOOST_CHECK_EQUAL(stats.nTemplates, 2U);
+        BOOST_CHECK(!store.Exists(vHeaderHashes[1]));
+        BOOST_CHECK(store.Exists(vHeaderHashes[3]));
+
+        store.Clear();
+        stats = store.GetStats();
+        BOOST_CHECK_EQUAL(stats.nTemplates, 0U);
+        BOOST_CHECK_EQUAL(stats.nMemoryUsage, 0U);
+    }
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -5,6 +5,7 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include "test_nrgc.h"
+#include "algo/x16r_multi.h"
 #include "chainparams.h"
 #include "consensus/consensus.h"
 #include "consensus/validation.h"
@@ -35,6 +36,7 @@ extern void noui_connect();
 BasicTestingSetup::BasicTestingSetup(const std::string &chainName)
 {
     SHA256AutoDetect();
+    X16RMultiAutoDetect();
     RandomInit();
     ECC_Start();
     SetupEnvironment();
@@ -88,8 +90,11 @@ TestingSetup::TestingSetup(const std::string &chainName) : BasicTestingSetup(cha
         }
     }
     nScriptCheckThreads = 3;
-    for (int i = 0; i < nScriptCheckThreads - 1; i++)
+    for (int i = 0; i < nScriptCheckThreads - 1; i++) {
         threadGroup.create_thread(&ThreadScriptCheck);
+        threadGroup.create_thread(&ThreadHeaderCheck);
+        threadGroup.create_thread(&ThreadAssetCheck);
+    }
     g_connman = std::unique_ptr<CConnman>(new CConnman(0x1337, 0x1337)); // Deterministic randomness for tests.
     connman = g_connman.get();
     peerLogic.reset(new PeerLogicValidation(connman, scheduler));
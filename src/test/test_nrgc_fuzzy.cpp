@@ -21,6 +21,7 @@
 #include "undo.h"
 #include "version.h"
 #include "pubkey.h"
+#include "test/assets/asset_name_regex.h"
 
 #include <stdint.h>
 #include <unistd.h>
@@ -48,6 +49,7 @@ enum TEST_ID
     CBLOOMFILTER_DESERIALIZE,
     CDISKBLOCKINDEX_DESERIALIZE,
     CTXOUTCOMPRESSOR_DESERIALIZE,
+    ASSET_NAME_VALIDATE,
     TEST_ID_END
 };
 
@@ -273,6 +275,14 @@ int test_one_input(std::vector<uint8_t> buffer)
 
             break;
         }
+        case ASSET_NAME_VALIDATE:
+        {
+            // Differential check of the asset name validator against the std::regex reference
+            std::string name(ds.begin(), ds.end());
+            if (!asset_name_regex::MatchesAssetNameValidation(name))
+                abort();
+            break;
+        }
         default:
             return 0;
     }
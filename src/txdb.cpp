@@ -38,6 +38,9 @@ static const char DB_FLAG = 'F';
 static const char DB_REINDEX_FLAG = 'R';
 static const char DB_LAST_BLOCK = 'l';
 
+//! Number of block index entries read before their hashes are computed together
+static const size_t BLOCK_INDEX_LOAD_BATCH = 4096;
+
 namespace {
 
 struct CoinEntry {
@@ -464,40 +467,57 @@ bool CBlockTreeDB::LoadBlockIndexGuts(const Consensus::Params& consensusParams,
 
     pcursor->Seek(std::make_pair(DB_BLOCK_INDEX, uint256()));
 
+    // Entries are read in chunks so that their hashes can be computed together
+    std::vector<CDiskBlockIndex> vDiskIndex;
+    std::vector<CBlockHeader> vHeaders;
+    std::vector<uint256> vHashes;
+    vDiskIndex.reserve(BLOCK_INDEX_LOAD_BATCH);
+    vHeaders.reserve(BLOCK_INDEX_LOAD_BATCH);
+
     // Load mapBlockIndex
-    while (pcursor->Valid()) {
+    bool fMore = pcursor->Valid();
+    while (fMore) {
         boost::this_thread::interruption_point();
-        std::pair<char, uint256> key;
-        if (pcursor->GetKey(key) && key.first == DB_BLOCK_INDEX) {
+        vDiskIndex.clear();
+        vHeaders.clear();
+        while (vDiskIndex.size() < BLOCK_INDEX_LOAD_BATCH) {
+            std::pair<char, uint256> key;
+            if (!pcursor->Valid() || !pcursor->GetKey(key) || key.first != DB_BLOCK_INDEX) {
+                fMore = false;
+                break;
+            }
             CDiskBlockIndex diskindex;
-            if (pcursor->GetValue(diskindex)) {
-                // Construct block index object
-                CBlockIndex* pindexNew = insertBlockIndex(diskindex.GetBlockHash());
-                pindexNew->pprev          = insertBlockIndex(diskindex.hashPrev);
-                pindexNew->nHeight        = diskindex.nHeight;
-                pindexNew->nFile          = diskindex.nFile;
-                pindexNew->nDataPos       = diskindex.nDataPos;
-                pindexNew->nUndoPos       = diskindex.nUndoPos;
-                pindexNew->nVersion       = diskindex.nVersion;
-                pindexNew->hashMerkleRoot = diskindex.hashMerkleRoot;
-                pindexNew->nTime          = diskindex.nTime;
-                pindexNew->nBits          = diskindex.nBits;
-                pindexNew->nNonce         = diskindex.nNonce;
-                pindexNew->nStatus        = diskindex.nStatus;
-                pindexNew->nTx            = diskindex.nTx;
-                pindexNew->nNonce64       = diskindex.nNonce64;
-                pindexNew->mix_hash       = diskindex.mix_hash;
-                pindexNew->nHeight        = diskindex.nHeight;
-
-                if (!CheckProofOfWork(pindexNew->GetBlockHash(), pindexNew->nBits, consensusParams))
-                    return error("%s: CheckProofOfWork failed: %s", __func__, pindexNew->ToString());
-
-                pcursor->Next();
-            } else {
+            if (!pcursor->GetValue(diskindex))
                 return error("%s: failed to read value", __func__);
-            }
-        } else {
-            break;
+            vHeaders.push_back(diskindex.GetDiskBlockHeader());
+            vDiskIndex.push_back(std::move(diskindex));
+            pcursor->Next();
+        }
+
+        GetBlockHeaderHashes(vHeaders, vHashes);
+
+        for (size_t i = 0; i < vDiskIndex.size(); i++) {
+            const CDiskBlockIndex& diskindex = vDiskIndex[i];
+            // Construct block index object
+            CBlockIndex* pindexNew = insertBlockIndex(vHashes[i]);
+            pindexNew->pprev          = insertBlockIndex(diskindex.hashPrev);
+            pindexNew->nHeight        = diskindex.nHeight;
+            pindexNew->nFile          = diskindex.nFile;
+            pindexNew->nDataPos       = diskindex.nDataPos;
+            pindexNew->nUndoPos       = diskindex.nUndoPos;
+            pindexNew->nVersion       = diskindex.nVersion;
+            pindexNew->hashMerkleRoot = diskindex.hashMerkleRoot;
+            pindexNew->nTime          = diskindex.nTime;
+            pindexNew->nBits          = diskindex.nBits;
+            pindexNew->nNonce         = diskindex.nNonce;
+            pindexNew->nStatus        = diskindex.nStatus;
+            pindexNew->nTx            = diskindex.nTx;
+            pindexNew->nNonce64       = diskindex.nNonce64;
+            pindexNew->mix_hash       = diskindex.mix_hash;
+            pindexNew->nHeight        = diskindex.nHeight;
+
+            if (!CheckProofOfWork(pindexNew->GetBlockHash(), pindexNew->nBits, consensusParams))
+                return error("%s: CheckProofOfWork failed: %s", __func__, pindexNew->ToString());
         }
     }
 
@@ -617,6 +617,116 @@ bool CTxMemPool::removeSpentIndex(const uint256 txhash)
     return true;
 }
 
+uint32_t CMemPoolRestrictionIndex::AddString(const std::string& str)
+{
+    auto it = mapStringIds.find(str);
+    if (it == mapStringIds.end()) {
+        uint32_t nId;
+        if (vFreeIds.empty()) {
+            nId = vStrings.size();
+            vStrings.emplace_back(nullptr);
+        } else {
+            nId = vFreeIds.back();
+            vFreeIds.pop_back();
+        }
+        it = mapStringIds.emplace(str, InternedString{nId, 0}).first;
+        // Keys of unordered_map nodes don't move when it rehashes
+        vStrings[nId] = &it->first;
+    }
+    it->second.nRefs++;
+    return it->second.nId;
+}
+
+void CMemPoolRestrictionIndex::ReleaseString(uint32_t nId)
+{
+    if (nId == NO_STRING)
+        return;
+
+    auto it = mapStringIds.find(*vStrings[nId]);
+    if (--it->second.nRefs == 0) {
+        vStrings[nId] = nullptr;
+        vFreeIds.push_back(nId);
+        mapStringIds.erase(it);
+    }
+}
+
+bool CMemPoolRestrictionIndex::FindKey(Kind kind, const std::string& strFirst, const std::string& strSecond, Key& key) const
+{
+    key.kind = kind;
+    auto itFirst = mapStringIds.find(strFirst);
+    if (itFirst == mapStringIds.end())
+        return false;
+    key.nFirst = itFirst->second.nId;
+
+    key.nSecond = NO_STRING;
+    if (!strSecond.empty()) {
+        auto itSecond = mapStringIds.find(strSecond);
+        if (itSecond == mapStringIds.end())
+            return false;
+        key.nSecond = itSecond->second.nId;
+    }
+    return true;
+}
+
+void CMemPoolRestrictionIndex::Add(Kind kind, const uint256& hash, const std::string& strFirst, const std::string& strSecond)
+{
+    Key key;
+    if (!FindKey(kind, strFirst, strSecond, key) || !mapKeyTxs.count(key)) {
+        // Each key holds a reference to its strings
+        key.nFirst = AddString(strFirst);
+        key.nSecond = strSecond.empty() ? NO_STRING : AddString(strSecond);
+    }
+
+    if (mapKeyTxs[key].insert(hash).second)
+        mapTxKeys[hash].push_back(key);
+}
+
+bool CMemPoolRestrictionIndex::Contains(Kind kind, const std::string& strFirst, const std::string& strSecond) const
+{
+    Key key;
+    return FindKey(kind, strFirst, strSecond, key) && mapKeyTxs.count(key);
+}
+
+std::vector<uint256> CMemPoolRestrictionIndex::GetTxs(Kind kind, const std::string& strFirst, const std::string& strSecond) const
+{
+    Key key;
+    if (!FindKey(kind, strFirst, strSecond, key))
+        return {};
+
+    auto it = mapKeyTxs.find(key);
+    if (it == mapKeyTxs.end())
+        return {};
+
+    return std::vector<uint256>(it->second.begin(), it->second.end());
+}
+
+void CMemPoolRestrictionIndex::RemoveTx(const uint256& hash)
+{
+    auto itTx = mapTxKeys.find(hash);
+    if (itTx == mapTxKeys.end())
+        return;
+
+    for (const Key& key : itTx->second) {
+        auto itKey = mapKeyTxs.find(key);
+        itKey->second.erase(hash);
+        if (itKey->second.empty()) {
+            mapKeyTxs.erase(itKey);
+            ReleaseString(key.nFirst);
+            ReleaseString(key.nSecond);
+        }
+    }
+    mapTxKeys.erase(itTx);
+}
+
+void CMemPoolRestrictionIndex::Clear()
+{
+    mapKeyTxs.clear();
+    mapTxKeys.clear();
+    mapStringIds.clear();
+    vStrings.clear();
+    vFreeIds.clear();
+}
+
 void CTxMemPool::removeUnchecked(txiter it, MemPoolRemovalReason reason)
 {
     NotifyEntryRemoved(it->GetSharedTx(), reason);
@@ -658,72 +768,8 @@ void CTxMemPool::removeUnchecked(txiter it, MemPoolRemovalReason reason)
         mapHashToAsset.erase(hash);
     }
 
-    // Erase from the restricted asset mempool maps if they match txids
-    if (mapHashToAddressMarkedFrozen.count(hash)) {
-        for (auto item : mapHashToAddressMarkedFrozen.at(hash))
-            mapAddressesMarkedFrozen.at(item).erase(hash);
-        mapHashToAddressMarkedFrozen.erase(hash);
-    }
-
-    if (mapHashMarkedGlobalFrozen.count(hash)) {
-        for (auto item : mapHashMarkedGlobalFrozen.at(hash))
-            mapAssetMarkedGlobalFrozen.at(item).erase(hash);
-        mapHashMarkedGlobalFrozen.erase(hash);
-    }
-
-    if (mapHashQualifiersChanged.count(hash)) {
-        for (auto item : mapHashQualifiersChanged.at(hash))
-            mapAddressesQualifiersChanged.at(item).erase(hash);
-        mapHashQualifiersChanged.erase(hash);
-    }
-
-    if (mapHashVerifierChanged.count(hash)) {
-        for (auto item : mapHashVerifierChanged.at(hash))
-            mapAssetVerifierChanged.at(item).erase(hash);
-        mapHashVerifierChanged.erase(hash);
-    }
-
-    if (mapHashGlobalFreezingAssetTransactions.count(hash)) {
-        for (auto item : mapHashGlobalFreezingAssetTransactions.at(hash)) {
-            if (mapGlobalFreezingAssetTransactions.count(item)) {
-                mapGlobalFreezingAssetTransactions.at(item).erase(hash);
-                if (mapGlobalFreezingAssetTransactions.at(item).size() == 0)
-                    mapGlobalFreezingAssetTransactions.erase(item);
-            }
-        }
-        mapHashGlobalFreezingAssetTransactions.erase(hash);
-    }
-
-    if (mapHashGlobalUnFreezingAssetTransactions.count(hash)) {
-        for (auto item : mapHashGlobalUnFreezingAssetTransactions.at(hash)) {
-            if (mapGlobalUnFreezingAssetTransactions.count(item)) {
-                mapGlobalUnFreezingAssetTransactions.at(item).erase(hash);
-                if (mapGlobalUnFreezingAssetTransactions.at(item).size() == 0)
-                    mapGlobalUnFreezingAssetTransactions.erase(item);
-            }
-        }
-        mapHashGlobalUnFreezingAssetTransactions.erase(hash);
-    }
-
-    if (mapHashToAddressAddedTag.count(hash)) {
-        for (auto item : mapHashToAddressAddedTag.at(hash)) {
-            if (mapAddressAddedTag.count(item)) {
-                mapAddressAddedTag.at(item).erase(hash);
-                if (mapAddressAddedTag.at(item).size() == 0)
-                    mapAddressAddedTag.erase(item);
-            }
-        }
-    }
-
-    if (mapHashToAddressRemoveTag.count(hash)) {
-        for (auto item : mapHashToAddressRemoveTag.at(hash)) {
-            if (mapAddressRemoveTag.count(item)) {
-                mapAddressRemoveTag.at(item).erase(hash);
-                if (mapAddressRemoveTag.at(item).size() == 0)
-                    mapAddressRemoveTag.erase(item);
-            }
-        }
-    }
+    // Erase from the restricted asset mempool bookkeeping
+    restrictionIndex.RemoveTx(hash);
     /** NRGC END */
 }
 
@@ -884,33 +930,30 @@ void CTxMemPool::removeForBlock(const std::vector<CTransactionRef>& vtx, unsigne
         }
     }
 
+    typedef CMemPoolRestrictionIndex::Kind Kind;
     for (auto it : connectedBlockData.newVerifiersToAdd) {
-        if (mapAssetVerifierChanged.count(it.assetName)) {
-            for (auto hash : mapAssetVerifierChanged.at(it.assetName)) {
-                indexed_transaction_set::iterator i = mapTx.find(hash);
-                if (i != mapTx.end()) {
-                    CValidationState state;
-                    if (!setAlreadyRemoving.count(hash) && !CheckTransaction(i->GetTx(), state, passets)) {
-                        entries.push_back(&*i);
-                        trans.emplace_back(i->GetTx());
-                        setAlreadyRemoving.insert(hash);
-                    }
+        for (auto hash : restrictionIndex.GetTxs(Kind::VERIFIER_CHANGED, it.assetName)) {
+            indexed_transaction_set::iterator i = mapTx.find(hash);
+            if (i != mapTx.end()) {
+                CValidationState state;
+                if (!setAlreadyRemoving.count(hash) && !CheckTransaction(i->GetTx(), state, passets)) {
+                    entries.push_back(&*i);
+                    trans.emplace_back(i->GetTx());
+                    setAlreadyRemoving.insert(hash);
                 }
             }
         }
     }
 
     for (auto it : connectedBlockData.newQualifiersToAdd) {
-        if (mapAddressesQualifiersChanged.count(it.address)) {
-            for (auto hash : mapAddressesQualifiersChanged.at(it.address)) {
-                indexed_transaction_set::iterator i = mapTx.find(hash);
-                if (i != mapTx.end()) {
-                    CValidationState state;
-                    if (!setAlreadyRemoving.count(hash) && !CheckTransaction(i->GetTx(), state, passets)) {
-                        entries.push_back(&*i);
-                        trans.emplace_back(i->GetTx());
-                        setAlreadyRemoving.insert(hash);
-                    }
+        for (auto hash : restrictionIndex.GetTxs(Kind::QUALIFIERS_CHANGED, it.address)) {
+            indexed_transaction_set::iterator i = mapTx.find(hash);
+            if (i != mapTx.end()) {
+                CValidationState state;
+                if (!setAlreadyRemoving.count(hash) && !CheckTransaction(i->GetTx(), state, passets)) {
+                    entries.push_back(&*i);
+                    trans.emplace_back(i->GetTx());
+                    setAlreadyRemoving.insert(hash);
                 }
             }
         }
@@ -918,44 +961,36 @@ void CTxMemPool::removeForBlock(const std::vector<CTransactionRef>& vtx, unsigne
 
     for (auto it : connectedBlockData.newGlobalRestrictionsToAdd) {
         if (it.type == RestrictedType::GLOBAL_FREEZE) {
-            if (mapAssetMarkedGlobalFrozen.count(it.assetName)) {
-                for (auto hash : mapAssetMarkedGlobalFrozen.at(it.assetName)) {
-                    indexed_transaction_set::iterator i = mapTx.find(hash);
-                    if (i != mapTx.end()) {
-                        CValidationState state;
-                        if (!setAlreadyRemoving.count(hash) && !CheckTransaction(i->GetTx(), state, passets)) {
-                            entries.push_back(&*i);
-                            trans.emplace_back(i->GetTx());
-                            setAlreadyRemoving.insert(hash);
-                        }
+            for (auto hash : restrictionIndex.GetTxs(Kind::ASSET_GLOBAL_FROZEN, it.assetName)) {
+                indexed_transaction_set::iterator i = mapTx.find(hash);
+                if (i != mapTx.end()) {
+                    CValidationState state;
+                    if (!setAlreadyRemoving.count(hash) && !CheckTransaction(i->GetTx(), state, passets)) {
+                        entries.push_back(&*i);
+                        trans.emplace_back(i->GetTx());
+                        setAlreadyRemoving.insert(hash);
                     }
                 }
             }
 
-            if (mapGlobalFreezingAssetTransactions.count(it.assetName)) {
-                for (auto hash : mapGlobalFreezingAssetTransactions.at(it.assetName)) {
-                    indexed_transaction_set::iterator i = mapTx.find(hash);
-                    if (i != mapTx.end()) {
-                        CValidationState state;
-                        if (!setAlreadyRemoving.count(hash)) {
-                            entries.push_back(&*i);
-                            trans.emplace_back(i->GetTx());
-                            setAlreadyRemoving.insert(hash);
-                        }
+            for (auto hash : restrictionIndex.GetTxs(Kind::GLOBAL_FREEZING, it.assetName)) {
+                indexed_transaction_set::iterator i = mapTx.find(hash);
+                if (i != mapTx.end()) {
+                    if (!setAlreadyRemoving.count(hash)) {
+                        entries.push_back(&*i);
+                        trans.emplace_back(i->GetTx());
+                        setAlreadyRemoving.insert(hash);
                     }
                 }
             }
         } else if (it.type == RestrictedType::GLOBAL_UNFREEZE) {
-            if (mapGlobalUnFreezingAssetTransactions.count(it.assetName)) {
-                for (auto hash : mapGlobalUnFreezingAssetTransactions.at(it.assetName)) {
-                    indexed_transaction_set::iterator i = mapTx.find(hash);
-                    if (i != mapTx.end()) {
-                        CValidationState state;
-                        if (!setAlreadyRemoving.count(hash)) {
-                            entries.push_back(&*i);
-                            trans.emplace_back(i->GetTx());
-                            setAlreadyRemoving.insert(hash);
-                        }
+            for (auto hash : restrictionIndex.GetTxs(Kind::GLOBAL_UNFREEZING, it.assetName)) {
+                indexed_transaction_set::iterator i = mapTx.find(hash);
+                if (i != mapTx.end()) {
+                    if (!setAlreadyRemoving.count(hash)) {
+                        entries.push_back(&*i);
+                        trans.emplace_back(i->GetTx());
+                        setAlreadyRemoving.insert(hash);
                     }
                 }
             }
@@ -964,18 +999,15 @@ void CTxMemPool::removeForBlock(const std::vector<CTransactionRef>& vtx, unsigne
 
     for (auto it : connectedBlockData.newAddressRestrictionsToAdd) {
         if (it.type == RestrictedType::FREEZE_ADDRESS) {
-            auto pair = std::make_pair(it.address, it.assetName);
-            if (mapAddressesMarkedFrozen.count(pair)) {
-                for (auto hash : mapAddressesMarkedFrozen.at(pair)) {
-                    indexed_transaction_set::iterator i = mapTx.find(hash);
-                    if (i != mapTx.end()) {
-                        CValidationState state;
-                        std::vector<std::pair<std::string, uint256>> vReissueAssets;
-                        if (!setAlreadyRemoving.count(hash) && !Consensus::CheckTxAssets(i->GetTx(), state, pcoinsTip, passets, false, vReissueAssets)) {
-                            entries.push_back(&*i);
-                            trans.emplace_back(i->GetTx());
-                            setAlreadyRemoving.insert(hash);
-                        }
+            for (auto hash : restrictionIndex.GetTxs(Kind::ADDRESS_FROZEN, it.address, it.assetName)) {
+                indexed_transaction_set::iterator i = mapTx.find(hash);
+                if (i != mapTx.end()) {
+                    CValidationState state;
+                    std::vector<std::pair<std::string, uint256>> vReissueAssets;
+                    if (!setAlreadyRemoving.count(hash) && !Consensus::CheckTxAssets(i->GetTx(), state, pcoinsTip, passets, false, vReissueAssets)) {
+                        entries.push_back(&*i);
+                        trans.emplace_back(i->GetTx());
+                        setAlreadyRemoving.insert(hash);
                     }
                 }
             }
@@ -1030,25 +1062,7 @@ void CTxMemPool::_clear()
     mapAssetToHash.clear();
     mapHashToAsset.clear();
 
-    mapAddressesMarkedFrozen.clear();
-    mapHashToAddressMarkedFrozen.clear();
-    mapAssetMarkedGlobalFrozen.clear();
-    mapHashMarkedGlobalFrozen.clear();
-    mapAddressesQualifiersChanged.clear();
-    mapHashQualifiersChanged.clear();
-    mapAssetVerifierChanged.clear();
-    mapHashVerifierChanged.clear();
-
-    mapHashToAddressAddedTag.clear();
-    mapAddressAddedTag.clear();
-    mapHashToAddressRemoveTag.clear();
-    mapAddressRemoveTag.clear();
-
-    mapGlobalFreezingAssetTransactions.clear();
-    mapHashGlobalFreezingAssetTransactions.clear();
-
-    mapGlobalUnFreezingAssetTransactions.clear();
-    mapHashGlobalUnFreezingAssetTransactions.clear();
+    restrictionIndex.Clear();
 }
 
 void CTxMemPool::clear()
@@ -14,6 +14,9 @@
 #include <vector>
 #include <utility>
 #include <string>
+#include <limits>
+#include <unordered_map>
+#include <unordered_set>
 
 #include "addressindex.h"
 #include "spentindex.h"
@@ -342,6 +345,70 @@ public:
     }
 };
 
+/**
+ * The asset restriction bookkeeping of the mempool: which mempool transactions a new freeze, tag or verifier
+ * would make invalid, and which ones already freeze or tag something. Every key is a kind plus one or two
+ * interned strings (an address and/or an asset name), and every transaction keeps the list of keys it was
+ * added under, so removing a transaction only touches its own entries.
+ */
+class CMemPoolRestrictionIndex
+{
+public:
+    enum class Kind : uint8_t {
+        ADDRESS_FROZEN,         //!< (address, restricted asset): spends the asset held by the address
+        ASSET_GLOBAL_FROZEN,    //!< (restricted asset): spends the asset
+        QUALIFIERS_CHANGED,     //!< (address): sends a restricted asset to the address
+        VERIFIER_CHANGED,       //!< (restricted asset): sends the asset
+        GLOBAL_FREEZING,        //!< (restricted asset): freezes the asset
+        GLOBAL_UNFREEZING,      //!< (restricted asset): unfreezes the asset
+        ADDRESS_ADDED_TAG,      //!< (address, qualifier): adds the tag to the address
+        ADDRESS_REMOVED_TAG,    //!< (address, qualifier): removes the tag from the address
+    };
+
+    void Add(Kind kind, const uint256& hash, const std::string& strFirst, const std::string& strSecond = "");
+    bool Contains(Kind kind, const std::string& strFirst, const std::string& strSecond = "") const;
+    std::vector<uint256> GetTxs(Kind kind, const std::string& strFirst, const std::string& strSecond = "") const;
+    void RemoveTx(const uint256& hash);
+    void Clear();
+
+    size_t GetKeyCount() const { return mapKeyTxs.size(); }
+    size_t GetStringCount() const { return mapStringIds.size(); }
+
+private:
+    static const uint32_t NO_STRING = std::numeric_limits<uint32_t>::max();
+
+    struct Key {
+        Kind kind;
+        uint32_t nFirst;
+        uint32_t nSecond;
+
+        bool operator==(const Key& other) const { return kind == other.kind && nFirst == other.nFirst && nSecond == other.nSecond; }
+    };
+
+    struct KeyHasher {
+        size_t operator()(const Key& key) const {
+            return ((uint64_t)key.nFirst << 32 | key.nSecond) * 0x9E3779B97F4A7C15ULL + (uint8_t)key.kind;
+        }
+    };
+
+    struct InternedString {
+        uint32_t nId;
+        uint32_t nRefs;
+    };
+
+    //! Every string is stored once, keys only hold its id. The id is released when no key uses the string anymore
+    std::unordered_map<std::string, InternedString> mapStringIds;
+    std::vector<const std::string*> vStrings;
+    std::vector<uint32_t> vFreeIds;
+
+    std::unordered_map<Key, std::unordered_set<uint256, SaltedTxidHasher>, KeyHasher> mapKeyTxs;
+    std::unordered_map<uint256, std::vector<Key>, SaltedTxidHasher> mapTxKeys;
+
+    uint32_t AddString(const std::string& str);
+    void ReleaseString(uint32_t nId);
+    bool FindKey(Kind kind, const std::string& strFirst, const std::string& strSecond, Key& key) const;
+};
+
 /**
  * CTxMemPool stores valid-according-to-the-current-best-chain transactions
  * that may be included in the next block.
@@ -472,37 +539,8 @@ public:
     std::map<std::string, uint256> mapAssetToHash;
     std::map<uint256, std::string> mapHashToAsset;
 
-    /** Restricted assets maps */
-    // Helper maps for when addresses are marked as frozen
-    std::map<std::pair<std::string, std::string>, std::set<uint256> > mapAddressesMarkedFrozen;
-    std::map<uint256, std::set<std::pair<std::string, std::string>>> mapHashToAddressMarkedFrozen;
-
-    // Helper maps for when restricted assets are globally frozen
-    std::map<std::string, std::set<uint256>> mapAssetMarkedGlobalFrozen;
-    std::map<uint256, std::set<std::string>> mapHashMarkedGlobalFrozen;
-
-    // Helper maps for when qualifiers are added or removed from addresses
-    std::map<std::string, std::set<uint256>> mapAddressesQualifiersChanged;
-    std::map<uint256, std::set<std::string>> mapHashQualifiersChanged;
-
-    // Helper maps for when verifier string are changed
-    std::map<std::string, std::set<uint256>> mapAssetVerifierChanged;
-    std::map<uint256, std::set<std::string>> mapHashVerifierChanged;
-
-    // Helper map for when an asset already in mempool that is globally freezing
-    std::map<std::string, std::set<uint256>> mapGlobalFreezingAssetTransactions;
-    std::map<uint256, std::set<std::string>> mapHashGlobalFreezingAssetTransactions;
-
-    // Helper map for when a qualfier is added to an address
-    std::map<std::pair<std::string, std::string>, std::set<uint256> > mapAddressAddedTag;
-    std::map<uint256, std::set<std::pair<std::string, std::string>>> mapHashToAddressAddedTag;
-
-    // Helper map for when a qualfier is added to an address
-    std::map<std::pair<std::string, std::string>, std::set<uint256> > mapAddressRemoveTag;
-    std::map<uint256, std::set<std::pair<std::string, std::string>>> mapHashToAddressRemoveTag;
-
-    std::map<std::string, std::set<uint256>> mapGlobalUnFreezingAssetTransactions;
-    std::map<uint256, std::set<std::string>> mapHashGlobalUnFreezingAssetTransactions;
+    /** Restricted assets bookkeeping */
+    CMemPoolRestrictionIndex restrictionIndex;
 
     typedef indexed_transaction_set::nth_index<0>::type::iterator txiter;
     std::vector<std::pair<uint256, txiter> > vTxHashes; //!< All tx witness hashes/entries in mapTx, in random order
@@ -238,10 +238,10 @@ CBlockTreeDB *pblocktree = nullptr;
 
 CAssetsDB *passetsdb = nullptr;
 CAssetsCache *passets = nullptr;
-CLRUCache<std::string, CDatabasedAssetData> *passetsCache = nullptr;
-CLRUCache<std::string, CMessage> *pMessagesCache = nullptr;
-CLRUCache<std::string, int> *pMessageSubscribedChannelsCache = nullptr;
-CLRUCache<std::string, int> *pMessagesSeenAddressCache = nullptr;
+CShardedLRUCache<std::string, CDatabasedAssetData> *passetsCache = nullptr;
+CShardedLRUCache<std::string, CMessage> *pMessagesCache = nullptr;
+CShardedLRUCache<std::string, int> *pMessageSubscribedChannelsCache = nullptr;
+CShardedLRUCache<std::string, int> *pMessagesSeenAddressCache = nullptr;
 CMessageDB *pmessagedb = nullptr;
 CMessageChannelDB *pmessagechanneldb = nullptr;
 CMyRestrictedDB *pmyrestricteddb = nullptr;
@@ -249,10 +249,11 @@ CSnapshotRequestDB *pSnapshotRequestDb = nullptr;
 CAssetSnapshotDB *pAssetSnapshotDb = nullptr;
 CDistributeSnapshotRequestDB *pDistributeSnapshotDb = nullptr;
 
-CLRUCache<std::string, CNullAssetTxVerifierString> *passetsVerifierCache = nullptr;
-CLRUCache<std::string, int8_t> *passetsQualifierCache = nullptr;
-CLRUCache<std::string, int8_t> *passetsRestrictionCache = nullptr;
-CLRUCache<std::string, int8_t> *passetsGlobalRestrictionCache = nullptr;
+CShardedLRUCache<std::string, CNullAssetTxVerifierString> *passetsVerifierCache = nullptr;
+CShardedLRUCache<std::string, std::shared_ptr<const CCompiledVerifierString>> *passetsCompiledVerifierCache = nullptr;
+CShardedLRUCache<std::string, int8_t> *passetsQualifierCache = nullptr;
+CShardedLRUCache<std::string, int8_t> *passetsRestrictionCache = nullptr;
+CShardedLRUCache<std::string, int8_t> *passetsGlobalRestrictionCache = nullptr;
 CRestrictedDB *prestricteddb = nullptr;
 
 enum FlushStateMode {
@@ -1002,29 +1003,24 @@ static bool AcceptToMemoryPoolWorker(const CChainParams& chainparams, CTxMemPool
                     if (AreRestrictedAssetsDeployed()) {
                         if (IsAssetNameAnRestricted(data.assetName)) {
                             std::string address = EncodeDestination(data.destination);
-                            pool.mapAddressesQualifiersChanged[address].insert(hash);
-                            pool.mapHashQualifiersChanged[hash].insert(address);
-
-                            pool.mapAssetVerifierChanged[data.assetName].insert(hash);
-                            pool.mapHashVerifierChanged[hash].insert(data.assetName);
+                            pool.restrictionIndex.Add(CMemPoolRestrictionIndex::Kind::QUALIFIERS_CHANGED, hash, address);
+                            pool.restrictionIndex.Add(CMemPoolRestrictionIndex::Kind::VERIFIER_CHANGED, hash, data.assetName);
                         }
                     }
                 } else if (out.scriptPubKey.IsNullGlobalRestrictionAssetTxDataScript()) {
                     CNullAssetTxData globalNullData;
                     if (GlobalAssetNullDataFromScript(out.scriptPubKey, globalNullData)) {
                         if (globalNullData.flag == 1) {
-                            if (pool.mapGlobalFreezingAssetTransactions.count(globalNullData.asset_name)) {
+                            if (pool.restrictionIndex.Contains(CMemPoolRestrictionIndex::Kind::GLOBAL_FREEZING, globalNullData.asset_name)) {
                                 return state.DoS(0, false, REJECT_INVALID, "bad-txns-global-freeze-already-in-mempool");
                             } else {
-                                pool.mapGlobalFreezingAssetTransactions[globalNullData.asset_name].insert(tx.GetHash());
-                                pool.mapHashGlobalFreezingAssetTransactions[tx.GetHash()].insert(globalNullData.asset_name);
+                                pool.restrictionIndex.Add(CMemPoolRestrictionIndex::Kind::GLOBAL_FREEZING, tx.GetHash(), globalNullData.asset_name);
                             }
                         } else if (globalNullData.flag == 0) {
-                            if (pool.mapGlobalUnFreezingAssetTransactions.count(globalNullData.asset_name)) {
+                            if (pool.restrictionIndex.Contains(CMemPoolRestrictionIndex::Kind::GLOBAL_UNFREEZING, globalNullData.asset_name)) {
                                 return state.DoS(0, false, REJECT_INVALID, "bad-txns-global-unfreeze-already-in-mempool");
                             } else {
-                                pool.mapGlobalUnFreezingAssetTransactions[globalNullData.asset_name].insert(tx.GetHash());
-                                pool.mapHashGlobalUnFreezingAssetTransactions[tx.GetHash()].insert(globalNullData.asset_name);
+                                pool.restrictionIndex.Add(CMemPoolRestrictionIndex::Kind::GLOBAL_UNFREEZING, tx.GetHash(), globalNullData.asset_name);
                             }
                         }
                     }
@@ -1036,21 +1032,19 @@ static bool AcceptToMemoryPoolWorker(const CChainParams& chainparams, CTxMemPool
                     if (AssetNullDataFromScript(out.scriptPubKey, addressNullData, address)) {
                         if (IsAssetNameAQualifier(addressNullData.asset_name)) {
                             if (addressNullData.flag == (int) QualifierType::ADD_QUALIFIER) {
-                                if (pool.mapAddressAddedTag.count(std::make_pair(address, addressNullData.asset_name))) {
+                                if (pool.restrictionIndex.Contains(CMemPoolRestrictionIndex::Kind::ADDRESS_ADDED_TAG, address, addressNullData.asset_name)) {
                                     return state.DoS(0, false, REJECT_INVALID,
                                                      "bad-txns-adding-tag-already-in-mempool");
                                 }
                                 // Adding a qualifier to an address
-                                pool.mapAddressAddedTag[std::make_pair(address, addressNullData.asset_name)].insert(tx.GetHash());
-                                pool.mapHashToAddressAddedTag[tx.GetHash()].insert(std::make_pair(address, addressNullData.asset_name));
+                                pool.restrictionIndex.Add(CMemPoolRestrictionIndex::Kind::ADDRESS_ADDED_TAG, tx.GetHash(), address, addressNullData.asset_name);
                             } else {
-                                    if (pool.mapAddressRemoveTag.count(std::make_pair(address, addressNullData.asset_name))) {
+                                    if (pool.restrictionIndex.Contains(CMemPoolRestrictionIndex::Kind::ADDRESS_REMOVED_TAG, address, addressNullData.asset_name)) {
                                         return state.DoS(0, false, REJECT_INVALID,
                                                          "bad-txns-remove-tag-already-in-mempool");
                                     }
 
-                                pool.mapAddressRemoveTag[std::make_pair(address, addressNullData.asset_name)].insert(tx.GetHash());
-                                pool.mapHashToAddressRemoveTag[tx.GetHash()].insert(std::make_pair(address, addressNullData.asset_name));
+                                pool.restrictionIndex.Add(CMemPoolRestrictionIndex::Kind::ADDRESS_REMOVED_TAG, tx.GetHash(), address, addressNullData.asset_name);
                             }
                         }
                     }
@@ -1070,12 +1064,8 @@ static bool AcceptToMemoryPoolWorker(const CChainParams& chainparams, CTxMemPool
                 if (GetAssetData(coin.out.scriptPubKey, data)) {
 
                     if (IsAssetNameAnRestricted(data.assetName)) {
-                        pool.mapAssetMarkedGlobalFrozen[data.assetName].insert(hash);
-                        pool.mapHashMarkedGlobalFrozen[hash].insert(data.assetName);
-
-                        auto pair = std::make_pair(EncodeDestination(data.destination), data.assetName);
-                        pool.mapAddressesMarkedFrozen[pair].insert(hash);
-                        pool.mapHashToAddressMarkedFrozen[hash].insert(pair);
+                        pool.restrictionIndex.Add(CMemPoolRestrictionIndex::Kind::ASSET_GLOBAL_FROZEN, hash, data.assetName);
+                        pool.restrictionIndex.Add(CMemPoolRestrictionIndex::Kind::ADDRESS_FROZEN, hash, EncodeDestination(data.destination), data.assetName);
                     }
                 }
             }
@@ -1609,6 +1599,22 @@ bool CScriptCheck::operator()() {
     return VerifyScript(scriptSig, m_tx_out.scriptPubKey, witness, nFlags, CachingTransactionSignatureChecker(ptxTo, nIn, m_tx_out.nValue, cacheStore, *txdata), &error);
 }
 
+bool CAssetCheck::operator()() {
+    if (type == NONE)
+        return true;
+
+    CAssetsCache* pbaseCache = pcache->Parent();
+    std::string strError;
+    if (type == FROZEN_ADDRESS) {
+        if (pbaseCache->CheckForAddressRestriction(strAssetName, strAddress, true))
+            return error("%s: %s: bad-txns-restricted-asset-transfer-from-frozen-address", __func__, txHash.ToString());
+    } else if (type == RESTRICTED_TRANSFER) {
+        if (!ContextualCheckTransferRestrictions(pbaseCache, CAssetTransfer(strAssetName, 0), strAddress, strError))
+            return error("%s: %s: %s", __func__, txHash.ToString(), strError.empty() ? "bad-txns-restricted-asset-verifier-failed" : strError);
+    }
+    return true;
+}
+
 int GetSpendHeight(const CCoinsViewCache& inputs)
 {
     LOCK(cs_main);
@@ -1896,7 +1902,7 @@ static DisconnectResult DisconnectBlock(const CBlock& block, const CBlockIndex*
     std::vector<std::pair<CSpentIndexKey, CSpentIndexValue> > spentIndex;
 
     // undo transactions in reverse order
-    CAssetsCache tempCache(*assetsCache);
+    CAssetsCache tempCache(assetsCache);
     for (int i = block.vtx.size() - 1; i >= 0; i--) {
         const CTransaction &tx = *(block.vtx[i]);
         uint256 hash = tx.GetHash();
@@ -2342,6 +2348,13 @@ void ThreadScriptCheck() {
     scriptcheckqueue.Thread();
 }
 
+static CCheckQueue<CAssetCheck> assetcheckqueue(128);
+
+void ThreadAssetCheck() {
+    RenameThread("nrgc-assetch");
+    assetcheckqueue.Thread();
+}
+
 // Protected by cs_main
 VersionBitsCache versionbitscache;
 
@@ -2439,7 +2452,8 @@ static int64_t nBlocksTotal = 0;
  *  Validity checks that depend on the UTXO set are also done; ConnectBlock()
  *  can fail if those validity checks fail (among other reasons). */
 static bool ConnectBlock(const CBlock& block, CValidationState& state, CBlockIndex* pindex,
-                  CCoinsViewCache& view, const CChainParams& chainparams, CAssetsCache* assetsCache = nullptr, bool fJustCheck = false, bool ignoreAddressIndex = false)
+                  CCoinsViewCache& view, const CChainParams& chainparams, CAssetsCache* assetsCache = nullptr, bool fJustCheck = false, bool ignoreAddressIndex = false,
+                  unsigned int nAssetCheckedTxs = 0)
 {
 
     AssertLockHeld(cs_main);
@@ -2551,6 +2565,18 @@ static bool ConnectBlock(const CBlock& block, CValidationState& state, CBlockInd
 
     CCheckQueueControl<CScriptCheck> control(fScriptChecks && nScriptCheckThreads ? &scriptcheckqueue : nullptr);
 
+    /** NRGC START */
+    // The restricted asset checks only read the cache below assetsCache. When that is passets it isn't changed until
+    // assetsCache is flushed, so the checks can run on the asset check queue. A qualifier issued by the block would
+    // change what the verifier checks of the transactions after it see, so those blocks are checked in order.
+    bool fQueueAssetChecks = nScriptCheckThreads && AreRestrictedAssetsDeployed() && assetsCache && passets && assetsCache->Parent() == passets;
+    for (unsigned int i = 0; fQueueAssetChecks && i < block.vtx.size(); i++) {
+        if (block.vtx[i]->IsNewQualifierAsset())
+            fQueueAssetChecks = false;
+    }
+    CCheckQueueControl<CAssetCheck> assetControl(fQueueAssetChecks ? &assetcheckqueue : nullptr);
+    /** NRGC END */
+
     std::vector<int> prevheights;
     CAmount nFees = 0;
     int nInputs = 0;
@@ -2597,13 +2623,16 @@ static bool ConnectBlock(const CBlock& block, CValidationState& state, CBlockInd
                         return state.DoS(100, error("%s : Received Block with tx that contained an null asset data tx when assets wasn't active", __func__), REJECT_INVALID, "bad-txns-null-data-assets-not-active");
             }
 
-            if (AreAssetsDeployed()) {
+            // The asset checks of the first nAssetCheckedTxs transactions after the coinbase already passed
+            if (AreAssetsDeployed() && !(fJustCheck && i <= nAssetCheckedTxs)) {
                 std::vector<std::pair<std::string, uint256>> vReissueAssets;
-                if (!Consensus::CheckTxAssets(tx, state, view, assetsCache, false, vReissueAssets, false, &setMessages, block.nTime, &myNullAssetData)) {
+                std::vector<CAssetCheck> vAssetChecks;
+                if (!Consensus::CheckTxAssets(tx, state, view, assetsCache, false, vReissueAssets, false, &setMessages, block.nTime, &myNullAssetData, fQueueAssetChecks ? &vAssetChecks : nullptr)) {
                     state.SetFailedTransaction(tx.GetHash());
                     return error("%s: Consensus::CheckTxAssets: %s, %s", __func__, tx.GetHash().ToString(),
                                  FormatStateMessage(state));
                 }
+                assetControl.Add(vAssetChecks);
             }
 
             /** NRGC END */
@@ -2835,6 +2864,8 @@ static bool ConnectBlock(const CBlock& block, CValidationState& state, CBlockInd
 	
     if (!control.Wait())
         return state.DoS(100, error("%s: CheckQueue failed", __func__), REJECT_INVALID, "block-validation-failed");
+    if (!assetControl.Wait())
+        return state.DoS(100, error("%s: asset CheckQueue failed", __func__), REJECT_INVALID, "block-asset-validation-failed");
     int64_t nTime4 = GetTimeMicros(); nTimeVerify += nTime4 - nTime2;
     LogPrint(BCLog::BENCH, "    - Verify %u txins: %.2fms (%.3fms/txin) [%.2fs (%.2fms/blk)]\n", nInputs - 1, MILLI * (nTime4 - nTime2), nInputs <= 1 ? 0 : MILLI * (nTime4 - nTime2) / (nInputs-1), nTimeVerify * MICRO, nTimeVerify * MILLI / nBlocksTotal);
 
@@ -3157,6 +3188,9 @@ void static UpdateTip(CBlockIndex *pindexNew, const CChainParams& chainParams) {
     // New best block
     mempool.AddTransactionsUpdated(1);
 
+    // Peers' asset data requests read the new tip from now on
+    InvalidateAssetMetaDataSnapshot();
+
     cvBlockChange.notify_all();
 
     std::vector<std::string> warningMessages;
@@ -3860,10 +3894,10 @@ bool ResetBlockFailureFlags(CBlockIndex *pindex) {
     return true;
 }
 
-static CBlockIndex* AddToBlockIndex(const CBlockHeader& block)
+static CBlockIndex* AddToBlockIndex(const CBlockHeader& block, const uint256* phashKnown = nullptr)
 {
     // Check for duplicate
-    uint256 hash = block.GetHash();
+    uint256 hash = phashKnown ? *phashKnown : block.GetHash();
     BlockMap::iterator it = mapBlockIndex.find(hash);
     if (it != mapBlockIndex.end())
         return it->second;
@@ -4031,27 +4065,38 @@ static bool FindUndoPos(CValidationState &state, int nFile, CDiskBlockPos &pos,
     return true;
 }
 
-static bool CheckBlockHeader(const CBlockHeader& block, CValidationState& state, const Consensus::Params& consensusParams, bool fCheckPOW = true)
+/** Height of the last checkpoint we have in mapBlockIndex, or -1 if there is none. */
+static int GetLastCheckpointHeight()
 {
-    // If we are checking a KAWPOW block below a know checkpoint height. We can validate the proof of work using the mix_hash
-    if (fCheckPOW && block.nTime >= nKAWPOWActivationTime) {
-        CBlockIndex* pcheckpoint = Checkpoints::GetLastCheckpoint(GetParams().Checkpoints());
-        if (fCheckPOW && pcheckpoint && block.nHeight <= (uint32_t)pcheckpoint->nHeight) {
-           if (!CheckProofOfWork(block.GetHash(), block.nBits, consensusParams)) {
-               return state.DoS(50, false, REJECT_INVALID, "high-hash", false, "proof of work failed with mix_hash only check");
-           }
+    AssertLockHeld(cs_main);
+    CBlockIndex* pcheckpoint = Checkpoints::GetLastCheckpoint(GetParams().Checkpoints());
+    return pcheckpoint ? pcheckpoint->nHeight : -1;
+}
 
-           return true;
+/**
+ * Proof of work part of CheckBlockHeader. It does not touch any global chain state,
+ * so it is safe to run without cs_main (see CHeaderCheck).
+ */
+static bool CheckBlockHeaderPoW(const CBlockHeader& block, CValidationState& state, const Consensus::Params& consensusParams, int nCheckpointHeight, const uint256* phashKnown)
+{
+    // If we are checking a KAWPOW block below a know checkpoint height. We can validate the proof of work using the mix_hash
+    if (block.nTime >= nKAWPOWActivationTime && nCheckpointHeight >= 0 && block.nHeight <= (uint32_t)nCheckpointHeight) {
+        if (!CheckProofOfWork(phashKnown ? *phashKnown : block.GetHash(), block.nBits, consensusParams)) {
+            return state.DoS(50, false, REJECT_INVALID, "high-hash", false, "proof of work failed with mix_hash only check");
         }
+
+        return true;
     }
 
     uint256 mix_hash;
-    // Check proof of work matches claimed amount
-    if (fCheckPOW && !CheckProofOfWork(block.GetHashFull(mix_hash), block.nBits, consensusParams)) {
+    // Check proof of work matches claimed amount. Before KAWPOW the block hash is the proof of work
+    // hash, so a hash the caller already computed (e.g. in bulk through GetBlockHeaderHashes) is reused.
+    const bool fHashKnown = phashKnown && block.nTime < nKAWPOWActivationTime;
+    if (!CheckProofOfWork(fHashKnown ? *phashKnown : block.GetHashFull(mix_hash), block.nBits, consensusParams)) {
         return state.DoS(50, false, REJECT_INVALID, "high-hash", false, "proof of work failed");
     }
 
-    if (fCheckPOW && block.nTime >= nKAWPOWActivationTime) {
+    if (block.nTime >= nKAWPOWActivationTime) {
         if (mix_hash != block.mix_hash) {
             return state.DoS(50, false, REJECT_INVALID, "invalid-mix-hash", false, "mix_hash validity failed");
         }
@@ -4060,6 +4105,65 @@ static bool CheckBlockHeader(const CBlockHeader& block, CValidationState& state,
     return true;
 }
 
+static bool CheckBlockHeader(const CBlockHeader& block, CValidationState& state, const Consensus::Params& consensusParams, bool fCheckPOW = true, const uint256* phashKnown = nullptr)
+{
+    if (!fCheckPOW)
+        return true;
+
+    const int nCheckpointHeight = block.nTime >= nKAWPOWActivationTime ? GetLastCheckpointHeight() : -1;
+    return CheckBlockHeaderPoW(block, state, consensusParams, nCheckpointHeight, phashKnown);
+}
+
+/** Hash and proof of work verdict of a header, computed before AcceptBlockHeader takes it. */
+struct CHeaderPreCheck
+{
+    uint256 hash;
+    //! Whether the proof of work has been checked; if not AcceptBlockHeader checks it itself
+    bool fChecked;
+    bool fValid;
+    //! Failure reason when fChecked && !fValid
+    CValidationState state;
+
+    CHeaderPreCheck() : fChecked(false), fValid(false) {}
+};
+
+/** Proof of work check of one header, run on the header check queue outside cs_main. */
+class CHeaderCheck
+{
+private:
+    const CBlockHeader* pheader;
+    const Consensus::Params* pconsensus;
+    int nCheckpointHeight;
+    CHeaderPreCheck* pprecheck;
+
+public:
+    CHeaderCheck() : pheader(nullptr), pconsensus(nullptr), nCheckpointHeight(-1), pprecheck(nullptr) {}
+    CHeaderCheck(const CBlockHeader& header, const Consensus::Params& consensus, int nCheckpointHeightIn, CHeaderPreCheck& precheck) :
+        pheader(&header), pconsensus(&consensus), nCheckpointHeight(nCheckpointHeightIn), pprecheck(&precheck) {}
+
+    bool operator()()
+    {
+        pprecheck->fValid = CheckBlockHeaderPoW(*pheader, pprecheck->state, *pconsensus, nCheckpointHeight, &pprecheck->hash);
+        pprecheck->fChecked = true;
+        return pprecheck->fValid;
+    }
+
+    void swap(CHeaderCheck& check)
+    {
+        std::swap(pheader, check.pheader);
+        std::swap(pconsensus, check.pconsensus);
+        std::swap(nCheckpointHeight, check.nCheckpointHeight);
+        std::swap(pprecheck, check.pprecheck);
+    }
+};
+
+static CCheckQueue<CHeaderCheck> headercheckqueue(16);
+
+void ThreadHeaderCheck() {
+    RenameThread("nrgc-headerch");
+    headercheckqueue.Thread();
+}
+
 bool CheckBlock(const CBlock& block, CValidationState& state, const Consensus::Params& consensusParams, bool fCheckPOW, bool fCheckMerkleRoot, bool fDBCheck)
 {
     // These are checks that are independent of context.
@@ -4352,11 +4456,11 @@ static bool ContextualCheckBlock(const CBlock& block, CValidationState& state, c
     return true;
 }
 
-static bool AcceptBlockHeader(const CBlockHeader& block, CValidationState& state, const CChainParams& chainparams, CBlockIndex** ppindex)
+static bool AcceptBlockHeader(const CBlockHeader& block, CValidationState& state, const CChainParams& chainparams, CBlockIndex** ppindex, const CHeaderPreCheck* pprecheck = nullptr)
 {
     AssertLockHeld(cs_main);
     // Check for duplicate
-    uint256 hash = block.GetHash();
+    uint256 hash = pprecheck ? pprecheck->hash : block.GetHash();
     BlockMap::iterator miSelf = mapBlockIndex.find(hash);
     CBlockIndex *pindex = nullptr;
     if (hash != chainparams.GetConsensus().hashGenesisBlock) {
@@ -4371,8 +4475,14 @@ static bool AcceptBlockHeader(const CBlockHeader& block, CValidationState& state
             return true;
         }
 
-        if (!CheckBlockHeader(block, state, chainparams.GetConsensus()))
+        if (pprecheck && pprecheck->fChecked) {
+            if (!pprecheck->fValid) {
+                state = pprecheck->state;
+                return error("%s: Consensus::CheckBlockHeader: %s, %s", __func__, hash.ToString(), FormatStateMessage(state));
+            }
+        } else if (!CheckBlockHeader(block, state, chainparams.GetConsensus(), true, &hash)) {
             return error("%s: Consensus::CheckBlockHeader: %s, %s", __func__, hash.ToString(), FormatStateMessage(state));
+        }
 
         // Get prev block index
         CBlockIndex* pindexPrev = nullptr;
@@ -4401,7 +4511,7 @@ static bool AcceptBlockHeader(const CBlockHeader& block, CValidationState& state
         }
     }
     if (pindex == nullptr)
-        pindex = AddToBlockIndex(block);
+        pindex = AddToBlockIndex(block, &hash);
 
     if (ppindex)
         *ppindex = pindex;
@@ -4412,14 +4522,51 @@ static bool AcceptBlockHeader(const CBlockHeader& block, CValidationState& state
 }
 
 // Exposed wrapper for AcceptBlockHeader
-bool ProcessNewBlockHeaders(const std::vector<CBlockHeader>& headers, CValidationState& state, const CChainParams& chainparams, const CBlockIndex** ppindex, CBlockHeader *first_invalid)
+bool ProcessNewBlockHeaders(const std::vector<CBlockHeader>& headers, CValidationState& state, const CChainParams& chainparams, const CBlockIndex** ppindex, CBlockHeader *first_invalid, const std::vector<uint256>* pvHeaderHashes)
 {
     if (first_invalid != nullptr) first_invalid->SetNull();
+
+    // Hash the whole batch up front, outside cs_main
+    std::vector<CHeaderPreCheck> vPreChecks(headers.size());
+    {
+        std::vector<uint256> vHeaderHashes;
+        if (pvHeaderHashes == nullptr || pvHeaderHashes->size() != headers.size()) {
+            GetBlockHeaderHashes(headers, vHeaderHashes);
+            pvHeaderHashes = &vHeaderHashes;
+        }
+        for (size_t i = 0; i < headers.size(); i++)
+            vPreChecks[i].hash = (*pvHeaderHashes)[i];
+    }
+
+    // Verify the proof of work of the headers we don't know yet on the header check threads,
+    // also outside cs_main, so that only the cheap contextual checks run under the lock.
+    std::vector<CHeaderCheck> vChecks;
+    {
+        LOCK(cs_main);
+        const int nCheckpointHeight = GetLastCheckpointHeight();
+        for (size_t i = 0; i < headers.size(); i++) {
+            const uint256& hash = vPreChecks[i].hash;
+            if (hash != chainparams.GetConsensus().hashGenesisBlock && !mapBlockIndex.count(hash))
+                vChecks.emplace_back(headers[i], chainparams.GetConsensus(), nCheckpointHeight, vPreChecks[i]);
+        }
+    }
+    if (nScriptCheckThreads) {
+        CCheckQueueControl<CHeaderCheck> control(&headercheckqueue);
+        control.Add(vChecks);
+        control.Wait();
+    } else {
+        for (CHeaderCheck& check : vChecks) {
+            if (!check())
+                break;
+        }
+    }
+
     {
         LOCK(cs_main);
-        for (const CBlockHeader& header : headers) {
+        for (size_t i = 0; i < headers.size(); i++) {
+            const CBlockHeader& header = headers[i];
             CBlockIndex *pindex = nullptr; // Use a temp pindex instead of ppindex to avoid a const_cast
-            if (!AcceptBlockHeader(header, state, chainparams, &pindex)) {
+            if (!AcceptBlockHeader(header, state, chainparams, &pindex, &vPreChecks[i])) {
                 if (first_invalid) *first_invalid = header;
                 return false;
             }
@@ -4559,7 +4706,7 @@ bool ProcessNewBlock(const CChainParams& chainparams, const std::shared_ptr<cons
     return true;
 }
 
-bool TestBlockValidity(CValidationState& state, const CChainParams& chainparams, const CBlock& block, CBlockIndex* pindexPrev, bool fCheckPOW, bool fCheckMerkleRoot)
+bool TestBlockValidity(CValidationState& state, const CChainParams& chainparams, const CBlock& block, CBlockIndex* pindexPrev, bool fCheckPOW, bool fCheckMerkleRoot, unsigned int nAssetCheckedTxs)
 {
     AssertLockHeld(cs_main);
     assert(pindexPrev && pindexPrev == chainActive.Tip());
@@ -4569,7 +4716,7 @@ bool TestBlockValidity(CValidationState& state, const CChainParams& chainparams,
     indexDummy.nHeight = pindexPrev->nHeight + 1;
 
     /** NRGC START */
-    CAssetsCache assetCache = *GetCurrentAssetCache();
+    CAssetsCache assetCache(GetCurrentAssetCache());
     /** NRGC END */
 
     // NOTE: CheckBlockHeader is called by CheckBlock
@@ -4579,7 +4726,7 @@ bool TestBlockValidity(CValidationState& state, const CChainParams& chainparams,
         return error("%s: Consensus::CheckBlock: %s", __func__, FormatStateMessage(state));
     if (!ContextualCheckBlock(block, state, chainparams.GetConsensus(), pindexPrev, &assetCache))
         return error("%s: Consensus::ContextualCheckBlock: %s", __func__, FormatStateMessage(state));
-    if (!ConnectBlock(block, state, &indexDummy, viewNew, chainparams, &assetCache, true)) /** NRGC START */ /*Add asset to function */ /** NRGC END*/
+    if (!ConnectBlock(block, state, &indexDummy, viewNew, chainparams, &assetCache, true, false, nAssetCheckedTxs)) /** NRGC START */ /*Add asset to function */ /** NRGC END*/
         return error("%s: Consensus::ConnectBlock: %s", __func__, FormatStateMessage(state));
     assert(state.IsValid());
 
@@ -4978,7 +5125,7 @@ bool CVerifyDB::VerifyDB(const CChainParams& chainparams, CCoinsView *coinsview,
     int reportDone = 0;
 
     auto currentActiveAssetCache = GetCurrentAssetCache();
-    CAssetsCache assetCache(*currentActiveAssetCache);
+    CAssetsCache assetCache(currentActiveAssetCache);
     LogPrintf("[0%%]...");
     for (CBlockIndex* pindex = chainActive.Tip(); pindex && pindex->pprev; pindex = pindex->pprev)
     {
@@ -5086,7 +5233,7 @@ bool ReplayBlocks(const CChainParams& params, CCoinsView* view)
 
     CCoinsViewCache cache(view);
     auto currentActiveAssetCache = GetCurrentAssetCache();
-    CAssetsCache assetsCache(*currentActiveAssetCache);
+    CAssetsCache assetsCache(currentActiveAssetCache);
 
     std::vector<uint256> hashHeads = view->GetHeadBlocks();
     if (hashHeads.empty()) return true; // We're already in a consistent state.
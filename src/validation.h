@@ -284,8 +284,9 @@ bool ProcessNewBlock(const CChainParams& chainparams, const std::shared_ptr<cons
  * @param[in]  chainparams The params for the chain we want to connect to
  * @param[out] ppindex If set, the pointer will be set to point to the last new block index object for the given headers
  * @param[out] first_invalid First header that fails validation, if one exists
+ * @param[in]  pvHeaderHashes Optional GetHash() of each header, as computed by GetBlockHeaderHashes
  */
-bool ProcessNewBlockHeaders(const std::vector<CBlockHeader>& block, CValidationState& state, const CChainParams& chainparams, const CBlockIndex** ppindex=nullptr, CBlockHeader *first_invalid=nullptr);
+bool ProcessNewBlockHeaders(const std::vector<CBlockHeader>& block, CValidationState& state, const CChainParams& chainparams, const CBlockIndex** ppindex=nullptr, CBlockHeader *first_invalid=nullptr, const std::vector<uint256>* pvHeaderHashes=nullptr);
 
 /** Check whether enough disk space is available for an incoming block */
 bool CheckDiskSpace(uint64_t nAdditionalBytes = 0);
@@ -306,6 +307,10 @@ bool LoadChainTip(const CChainParams& chainparams);
 void UnloadBlockIndex();
 /** Run an instance of the script checking thread */
 void ThreadScriptCheck();
+/** Run instances of the header proof of work check queue */
+void ThreadHeaderCheck();
+/** Run instances of the restricted asset check queue */
+void ThreadAssetCheck();
 /** Check whether we are doing an initial block download (synchronizing from disk or network) */
 bool IsInitialBlockDownload();
 bool IsInitialSyncSpeedUp();
@@ -428,6 +433,43 @@ public:
     ScriptError GetScriptError() const { return error; }
 };
 
+/**
+ * Closure representing one restricted asset check of a block transaction.
+ * It only reads the asset state below the cache the block is connected on (the fSkipTempCache
+ * lookups), which doesn't change while the block's own asset changes are applied to that cache.
+ */
+class CAssetCheck
+{
+public:
+    enum Type {
+        NONE,
+        FROZEN_ADDRESS,         //! The restricted asset of an input mustn't be frozen for its address
+        RESTRICTED_TRANSFER     //! The restricted asset of an output mustn't be globally frozen, and its address must pass the verifier
+    };
+
+private:
+    Type type;
+    std::string strAssetName;
+    std::string strAddress;
+    CAssetsCache* pcache;
+    uint256 txHash;
+
+public:
+    CAssetCheck(): type(NONE), pcache(nullptr) {}
+    CAssetCheck(Type typeIn, const std::string& strAssetNameIn, const std::string& strAddressIn, CAssetsCache* pcacheIn, const uint256& txHashIn) :
+        type(typeIn), strAssetName(strAssetNameIn), strAddress(strAddressIn), pcache(pcacheIn), txHash(txHashIn) { }
+
+    bool operator()();
+
+    void swap(CAssetCheck &check) {
+        std::swap(type, check.type);
+        std::swap(strAssetName, check.strAssetName);
+        std::swap(strAddress, check.strAddress);
+        std::swap(pcache, check.pcache);
+        std::swap(txHash, check.txHash);
+    }
+};
+
 /** Initializes the script-execution cache */
 void InitScriptExecutionCache();
 
@@ -454,8 +496,10 @@ bool ReadBlockFromDisk(CBlock& block, const CBlockIndex* pindex, const Consensus
 /** Context-independent validity checks */
 bool CheckBlock(const CBlock& block, CValidationState& state, const Consensus::Params& consensusParams, bool fCheckPOW = true, bool fCheckMerkleRoot = true, bool fDBCheck = false);
 
-/** Check a block is completely valid from start to finish (only works on top of our current best block, with cs_main held) */
-bool TestBlockValidity(CValidationState& state, const CChainParams& chainparams, const CBlock& block, CBlockIndex* pindexPrev, bool fCheckPOW = true, bool fCheckMerkleRoot = true);
+/** Check a block is completely valid from start to finish (only works on top of our current best block, with cs_main held).
+ *  The asset checks of the first nAssetCheckedTxs transactions after the coinbase are skipped, for templates that start
+ *  with the transactions of an earlier valid template on the same tip. */
+bool TestBlockValidity(CValidationState& state, const CChainParams& chainparams, const CBlock& block, CBlockIndex* pindexPrev, bool fCheckPOW = true, bool fCheckMerkleRoot = true, unsigned int nAssetCheckedTxs = 0);
 
 /** Check whether witness commitments are required for block. */
 bool IsWitnessEnabled(const CBlockIndex* pindexPrev, const Consensus::Params& params);
@@ -513,16 +557,16 @@ extern CAssetsDB *passetsdb;
 extern CAssetsCache *passets;
 
 /** Global variable that point to the assets metadata LRU Cache (protected by cs_main) */
-extern CLRUCache<std::string, CDatabasedAssetData> *passetsCache;
+extern CShardedLRUCache<std::string, CDatabasedAssetData> *passetsCache;
 
 /** Global variable that points to the subscribed channel LRU Cache (protected by cs_main) */
-extern CLRUCache<std::string, CMessage> *pMessagesCache;
+extern CShardedLRUCache<std::string, CMessage> *pMessagesCache;
 
 /** Global variable that points to the subscribed channel LRU Cache (protected by cs_main) */
-extern CLRUCache<std::string, int> *pMessageSubscribedChannelsCache;
+extern CShardedLRUCache<std::string, int> *pMessageSubscribedChannelsCache;
 
 /** Global variable that points to the address seen LRU Cache (protected by cs_main) */
-extern CLRUCache<std::string, int> *pMessagesSeenAddressCache;
+extern CShardedLRUCache<std::string, int> *pMessagesSeenAddressCache;
 
 /** Global variable that points to the messages database (protected by cs_main) */
 extern CMessageDB *pmessagedb;
@@ -537,16 +581,19 @@ extern CMyRestrictedDB *pmyrestricteddb;
 extern CRestrictedDB *prestricteddb;
 
 /** Global variable that points to the asset verifier LRU Cache (protected by cs_main) */
-extern CLRUCache<std::string, CNullAssetTxVerifierString> *passetsVerifierCache;
+extern CShardedLRUCache<std::string, CNullAssetTxVerifierString> *passetsVerifierCache;
+
+/** Global variable that points to the compiled asset verifier LRU Cache */
+extern CShardedLRUCache<std::string, std::shared_ptr<const CCompiledVerifierString>> *passetsCompiledVerifierCache;
 
 /** Global variable that points to the asset address qualifier LRU Cache (protected by cs_main) */
-extern CLRUCache<std::string, int8_t> *passetsQualifierCache; // hash(address,qualifier_name) ->int8_t
+extern CShardedLRUCache<std::string, int8_t> *passetsQualifierCache; // hash(address,qualifier_name) ->int8_t
 
 /** Global variable that points to the asset address restriction LRU Cache (protected by cs_main) */
-extern CLRUCache<std::string, int8_t> *passetsRestrictionCache; // hash(address,qualifier_name) ->int8_t
+extern CShardedLRUCache<std::string, int8_t> *passetsRestrictionCache; // hash(address,qualifier_name) ->int8_t
 
 /** Global variable that points to the global asset restriction LRU Cache (protected by cs_main) */
-extern CLRUCache<std::string, int8_t> *passetsGlobalRestrictionCache;
+extern CShardedLRUCache<std::string, int8_t> *passetsGlobalRestrictionCache;
 
 /** Global variable that point to the active Snapshot Request database (protected by cs_main) */
 extern CSnapshotRequestDB *pSnapshotRequestDb;
@@ -11,7 +11,7 @@
  * network protocol versioning
  */
 
-static const int PROTOCOL_VERSION = 70028;
+static const int PROTOCOL_VERSION = 70029;
 
 //! initial proto version, to be increased after version/verack negotiation
 static const int INIT_PROTO_VERSION = 209;
@@ -61,5 +61,8 @@ static const int ASSETDATA_VERSION_UPDATED = 70020;
 //! In this version, 'rip5 (messaging and restricted assets)' was introduced
 static const int MESSAGING_RESTRICTED_ASSETS_VERSION = 70026;
 
+//! getassetbtch and assetbatch, asset metadata for many assets per message, start with this version
+static const int ASSETDATA_BATCH_VERSION = 70029;
+
 
 #endif // NRGC_VERSION_H